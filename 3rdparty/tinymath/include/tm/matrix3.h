@@ -26,7 +26,6 @@
 #define MATRIX3_H
 
 namespace tmath{
-const double pi = 3.1415926535897932384626433832795;
 
 template<typename T, int N, int M>
 class matrix;
@@ -190,6 +189,10 @@ public:
 		return m * s;
 	}
 	inline friend matrix<T,3,3> operator*(const matrix<T,3,3>& m1, const matrix<T,3,3>& m2 )  {
+		matrix<T,3,3> m;
+		if (simd::mul33(&m1.xx, &m2.xx, &m.xx)) {
+			return m;
+		}
 		return matrix<T,3,3>(m1.xx * m2.xx + m1.xy * m2.yx + m1.xz * m2.zx,
 											m1.xx * m2.xy + m1.xy * m2.yy + m1.xz * m2.zy,
 											m1.xx * m2.xz + m1.xy * m2.yz + m1.xz * m2.zz,
@@ -289,9 +292,9 @@ public:
 	/// Calculate the determinant of a matrix
 	T det() const {
 		T det;
-		det = this->[0] * (yy * zz - yz * zy)
-			- this->[3] * (zz * xy - zy * xz)
-			+ this->[7] * (yz * xy - yy * xz);
+		det = xx * (yy * zz - yz * zy)
+			- yx * (zz * xy - zy * xz)
+			+ zx * (yz * xy - yy * xz);
 		return det;
 	}
 
@@ -208,6 +208,10 @@ public:
 												m1.wx * m2.xw + m1.wy * m2.yw + m1.wz * m2.zw + m1.ww * m2.ww);
 	}
 	inline friend const vectorn<T,4> operator*(const matrix<T,4,4>& m, const vectorn<T,4>& v) {
+		vectorn<T,4> r;
+		if (simd::mul44v(&m.xx, &v.x, &r.x)) {
+			return r;
+		}
 		return vectorn<T,4>(v.x*m.xx + v.y*m.xy + v.z*m.xz + v.w*m.xw,
 											v.x*m.yx + v.y*m.yy + v.z*m.yz + v.w*m.yw,
 											v.x*m.zx + v.y*m.zy + v.z*m.zz + v.w*m.zw,
@@ -290,12 +294,12 @@ public:
 	/// Calculates the determinant of a matrix<T,4,4>
 	T det() const {
 		T det;
-		det =  this->[0] * this->[5] * this->[10];
-		det += this->[4] * this->[9] * this->[2];
-		det += this->[8] * this->[1] * this->[6];
-		det -= this->[8] * this->[5] * this->[2];
-		det -= this->[4] * this->[1] * this->[10];
-		det -= this->[0] * this->[9] * this->[6];
+		det =  (*this)[0] * (*this)[5] * (*this)[10];
+		det += (*this)[4] * (*this)[9] * (*this)[2];
+		det += (*this)[8] * (*this)[1] * (*this)[6];
+		det -= (*this)[8] * (*this)[5] * (*this)[2];
+		det -= (*this)[4] * (*this)[1] * (*this)[10];
+		det -= (*this)[0] * (*this)[9] * (*this)[6];
 		return det;
 	}
 
@@ -306,28 +310,28 @@ public:
 
 	/// Calculates the inverse of a matrix4<t>
 	const matrix<T, 4, 4> inv() {
-		T det = det();
-		if (fabs(det) < static_cast<T>(0.0005)) {
+		T detval = det();
+		if (fabs(detval) < static_cast<T>(0.0005)) {
 			return matrix<T, 4, 4>();
 		}
-		T idet = static_cast<T>(1.0) / det;
+		T idet = static_cast<T>(1.0) / detval;
 
 		matrix<T, 4, 4> invM;
-		invM[0] = (this->[5] * this->[10] - this->[9] * this->[6]) * idet;
-		invM[1] = -(this->[1] * this->[10] - this->[9] * this->[2]) * idet;
-		invM[2] = (this->[1] * this->[6] - this->[5] * this->[2]) * idet;
+		invM[0] = ((*this)[5] * (*this)[10] - (*this)[9] * (*this)[6]) * idet;
+		invM[1] = -((*this)[1] * (*this)[10] - (*this)[9] * (*this)[2]) * idet;
+		invM[2] = ((*this)[1] * (*this)[6] - (*this)[5] * (*this)[2]) * idet;
 		invM[3] = 0.0;
-		invM[4] = -(this->[4] * this->[10] - this->[8] * this->[6]) * idet;
-		invM[5] = (this->[0] * this->[10] - this->[8] * this->[2]) * idet;
-		invM[6] = -(this->[0] * this->[6] - this->[4] * this->[2]) * idet;
+		invM[4] = -((*this)[4] * (*this)[10] - (*this)[8] * (*this)[6]) * idet;
+		invM[5] = ((*this)[0] * (*this)[10] - (*this)[8] * (*this)[2]) * idet;
+		invM[6] = -((*this)[0] * (*this)[6] - (*this)[4] * (*this)[2]) * idet;
 		invM[7] = 0.0;
-		invM[8] = (this->[4] * this->[9] - this->[8] * this->[5]) * idet;
-		invM[9] = -(this->[0] * this->[9] - this->[8] * this->[1]) * idet;
-		invM[10] = (this->[0] * this->[5] - this->[4] * this->[1]) * idet;
+		invM[8] = ((*this)[4] * (*this)[9] - (*this)[8] * (*this)[5]) * idet;
+		invM[9] = -((*this)[0] * (*this)[9] - (*this)[8] * (*this)[1]) * idet;
+		invM[10] = ((*this)[0] * (*this)[5] - (*this)[4] * (*this)[1]) * idet;
 		invM[11] = 0.0;
-		invM[12] = -(this->[12] * invM[0] + this->[13] * invM[4] + this->[14] * invM[8]);
-		invM[13] = -(this->[12] * invM[1] + this->[13] * invM[5] + this->[14] * invM[9]);
-		invM[14] = -(this->[12] * invM[2] + this->[13] * invM[6] + this->[14] * invM[10]);
+		invM[12] = -((*this)[12] * invM[0] + (*this)[13] * invM[4] + (*this)[14] * invM[8]);
+		invM[13] = -((*this)[12] * invM[1] + (*this)[13] * invM[5] + (*this)[14] * invM[9]);
+		invM[14] = -((*this)[12] * invM[2] + (*this)[13] * invM[6] + (*this)[14] * invM[10]);
 		invM[15] = 1.0;
 		return invM;
 	}
@@ -30,6 +30,9 @@ namespace tmath{
 template<typename T, int N, int M>
 class matrix;
 
+template<typename T, int NUM>
+class vectorn;
+
 /**
 	@class 			quaternion
 	@brief 			Class that represents a quaternion
@@ -202,7 +205,7 @@ public:
 	}
 	// Return Normalized copy of the quaternion
 	quaternion<T> normalized() const {
-		quaternion<T> q(this);
+		quaternion<T> q(*this);
 		q.normalize();
 
 		return q;
@@ -210,7 +213,7 @@ public:
 
 	// conjugate the quaternion
 	inline quaternion<T> conj() const {
-		tmath::quaternion<T> qres(this);
+		tmath::quaternion<T> qres(*this);
 		qres.x *= static_cast<T>(-1.0);
 		qres.y *= static_cast<T>(-1.0);
 		qres.z *= static_cast<T>(-1.0);
@@ -218,12 +221,12 @@ public:
 	}
 	// invert the quaternion
 	inline quaternion<T> inv() const {
-		tmath::quaternion<T> qres(this);
+		tmath::quaternion<T> qres(*this);
 		T s = qres.len();
 		if (s > static_cast<T>(0.0)) {
 			s = static_cast<T>(1.0) / s;
 			qres *= s;
-			return conj(qres);
+			return qres.conj();
 		}
 		return quaternion<T>(0.0, 0.0, 0.0, 0.0);
 	}
@@ -241,6 +244,21 @@ public:
 		return len();
 	}
 
+	/// Rotates a vector into the frame of the quaternion, as the rotation matrix<T,3,3>(q) does
+	inline const vectorn<T,3> rotate(const vectorn<T,3>& v) const {
+		vectorn<T,3> r;
+		if (simd::qrot(&x, &v.x, &r.x)) {
+			return r;
+		}
+		// t = 2 (v x q.xyz), r = v + w t + t x q.xyz
+		T tx = static_cast<T>(2.0) * (v.y * z - v.z * y);
+		T ty = static_cast<T>(2.0) * (v.z * x - v.x * z);
+		T tz = static_cast<T>(2.0) * (v.x * y - v.y * x);
+		return vectorn<T,3>(v.x + w * tx + (ty * z - tz * y),
+							v.y + w * ty + (tz * x - tx * z),
+							v.z + w * tz + (tx * y - ty * x));
+	}
+
 	/// Returns the euler angles from the quaternion rotation
 	void getEulerAngles(T& yaw, T& pitch, T& roll) {
 
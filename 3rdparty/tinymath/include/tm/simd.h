@@ -0,0 +1,133 @@
+/*
+	SIMD kernels for the fixed size tinymath types.
+
+	Each kernel computes exactly the expression of the scalar operator it
+	replaces: one output component per lane, with the same multiplications and
+	the same left to right additions, so results are bit-for-bit identical to
+	the scalar code.  Kernels never use fused multiply-add, build with
+	floating-point contraction off (-ffp-contract=off, the /fp:precise
+	default) if the scalar code must match them exactly on FMA targets.
+
+	Only the kernels faster than what the compiler makes of the scalar code
+	are defined (SSE2 on every x64 target, AVX where the build targets AVX or
+	AVX2); each returns true, the generic versions return false and the
+	operators then run their scalar code.  Define TM_NO_SIMD to use the
+	scalar code everywhere.
+*/
+
+//Source added by Cory Parks 09/2017
+
+#ifndef TM_SIMD_H
+#define TM_SIMD_H
+
+#if !defined(TM_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TM_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define TM_SIMD_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+namespace tmath{
+namespace simd{
+
+// Generic versions, no kernel for the type or target
+template<typename T> inline bool mul33(const T*, const T*, T*) { return false; }
+template<typename T> inline bool mul44v(const T*, const T*, T*) { return false; }
+template<typename T> inline bool qrot(const T*, const T*, T*) { return false; }
+
+#ifdef TM_SIMD_SSE2
+
+// ----------------------------------------------------------------------------
+// matrix3 * matrix3, row i of r = a[i][0]*b.row0 + a[i][1]*b.row1 + a[i][2]*b.row2
+// (the compiler does as well for double)
+//
+inline bool mul33(const float* a, const float* b, float* r) {
+	// the 4th lane of each row is padding, row 2 is loaded from b + 5 to stay inside b
+	__m128 b0 = _mm_loadu_ps(b);
+	__m128 b1 = _mm_loadu_ps(b + 3);
+	__m128 b2 = _mm_loadu_ps(b + 5);
+	b2 = _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(3, 3, 2, 1));
+	__m128 row[3];
+	for (int i = 0; i < 3; i++) {
+		__m128 s = _mm_mul_ps(_mm_set1_ps(a[3*i]), b0);
+		s = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(a[3*i + 1]), b1));
+		row[i] = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(a[3*i + 2]), b2));
+	}
+	// rows 0 and 1 spill their padding into the next row, which is stored after them;
+	// row 2 is stored from r + 5 with r[5] rewritten
+	_mm_storeu_ps(r, row[0]);
+	_mm_storeu_ps(r + 3, row[1]);
+	__m128 t = _mm_shuffle_ps(row[1], row[2], _MM_SHUFFLE(0, 0, 2, 2));
+	_mm_storeu_ps(r + 5, _mm_shuffle_ps(t, row[2], _MM_SHUFFLE(2, 1, 2, 0)));
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+// matrix4 * vector4, r = v.x*m.column0 + v.y*m.column1 + v.z*m.column2 + v.w*m.column3
+// (the compiler does as well for SSE2 double, and vectorizes every matrix4 * matrix4)
+//
+inline bool mul44v(const float* m, const float* v, float* r) {
+	__m128 c0 = _mm_loadu_ps(m);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_loadu_ps(m + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	__m128 s = _mm_mul_ps(_mm_set1_ps(v[0]), c0);
+	s = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(v[1]), c1));
+	s = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(v[2]), c2));
+	s = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(v[3]), c3));
+	_mm_storeu_ps(r, s);
+	return true;
+}
+
+#ifdef TM_SIMD_AVX
+inline bool mul44v(const double* m, const double* v, double* r) {
+	__m256d r0 = _mm256_loadu_pd(m);
+	__m256d r1 = _mm256_loadu_pd(m + 4);
+	__m256d r2 = _mm256_loadu_pd(m + 8);
+	__m256d r3 = _mm256_loadu_pd(m + 12);
+	__m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+	__m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+	__m256d c0 = _mm256_permute2f128_pd(t0, t2, 0x20), c2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+	__m256d c1 = _mm256_permute2f128_pd(t1, t3, 0x20), c3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+	__m256d s = _mm256_mul_pd(_mm256_set1_pd(v[0]), c0);
+	s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_set1_pd(v[1]), c1));
+	s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_set1_pd(v[2]), c2));
+	s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_set1_pd(v[3]), c3));
+	_mm256_storeu_pd(r, s);
+	return true;
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// quaternion rotation of a vector3 (quaternion::rotate), components (x, y, z) in lanes 0 to 2:
+//	t = 2 (v x q.xyz), r = v + q.w*t + t x q.xyz
+// (the compiler does as well for double, and for float on AVX targets)
+//
+#ifndef TM_SIMD_AVX
+inline bool qrot(const float* q, const float* v, float* r) {
+	__m128 a = _mm_loadu_ps(q);
+	__m128 b = _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(v)), _mm_load_ss(v + 2));
+	__m128 ayzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 azxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+	__m128 t = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1)), azxy),
+		_mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2)), ayzx));
+	t = _mm_mul_ps(_mm_set1_ps(2.0f), t);
+	__m128 s = _mm_add_ps(b, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), t));
+	__m128 c = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(t, t, _MM_SHUFFLE(3, 0, 2, 1)), azxy),
+		_mm_mul_ps(_mm_shuffle_ps(t, t, _MM_SHUFFLE(3, 1, 0, 2)), ayzx));
+	s = _mm_add_ps(s, c);
+	_mm_storel_pi(reinterpret_cast<__m64*>(r), s);
+	_mm_store_ss(r + 2, _mm_movehl_ps(s, s));
+	return true;
+}
+#endif
+
+#endif //TM_SIMD_SSE2
+
+}
+}
+
+#endif
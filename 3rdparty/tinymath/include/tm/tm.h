@@ -29,6 +29,8 @@
 #include <iostream>
 #include <cmath>
 #include <cfloat>
+#include <tm/tmconfig.h>
+#include <tm/simd.h>
 #include <tm/vector2.h>
 #include <tm/vector3.h>
 #include <tm/vector4.h>
@@ -23,5 +23,8 @@
 #ifndef TMCONFIG_H
 #define TMCONFIG_H
 
+namespace tmath{
+const double pi = 3.1415926535897932384626433832795;
+}
 
 #endif
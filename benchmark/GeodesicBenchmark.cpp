@@ -0,0 +1,698 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       GeodesicBenchmark.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FUNCTIONAL DESCRIPTION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Benchmark and check of the otWorld Ellipsoid distance and bearing matrices on the
+WGS84 Earth.
+
+Two sets of origins and destinations (a region of about 2000 km and the whole
+globe) are solved pair by pair with the single pair functions of Ellipsoid, and as
+matrices with each solution, with the estimate as a prefilter for the exact
+solution, and split across thread pools of 2 and 4 threads.  One record is written
+per set and method with the cost per pair, the percentage of pairs solved (not only
+estimated), and the largest difference in distance and bearing from the reference:
+
+	pair functions     -
+	vincenty, exact    the pair functions (must be identical)
+	estimated          getEstimatedDistanceAndBearing, for the final bearing the
+	                   reverse initial bearing of the transposed matrix
+	exact_prefilter    the exact matrix, for the pairs within the maximum distance
+	                   (must be identical, every one of them solved)
+
+Routes: flight plans of waypoints across a continent are sampled at equal
+distances by a GeodesicRoute (GeodesicLine and GeodesicLineExact legs), and point
+by point with Ellipsoid::getDestinationPoint and GeographicLib::Geodesic::Direct
+from the start of the leg, the reference.  The errors of these records are of the
+position (m) and bearing.  Building the legs of the routes is timed with the legs
+cached and not.
+
+The program returns 1 if a matrix is not within the tolerance of its reference, a
+route sample is not within the route tolerance of GeographicLib, setting the
+waypoints of a route does not build exactly the legs missing from its cache, or
+trimming the cache does not drop the least recently used legs first.
+
+Usage: geodesicBenchmark [--format=csv|json] [--min-time=<ms>]
+
+	--format     csv (default, with a header line) or json (one object per line)
+	--min-time   minimum measured time per case in ms (default 5)
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "Ellipsoid.h"
+#include "GeodesicRoute.h"
+#include "ThreadPool.h"
+#include "GeographicLib/Geodesic.hpp"
+
+#include "Conversions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+using otWorld::Ellipsoid;
+using otWorld::Geodetic2;
+using otWorld::Geodetic3;
+using otWorld::GeodesicRoute;
+using otWorld::GeodesicSolution;
+using otWorld::RouteSpacing;
+using otCore::ThreadPool;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+//WGS84
+const double EARTH_A = 6378137.0;
+const double EARTH_F = 1.0 / 298.257223563;
+
+//Origins and destinations per set
+const size_t NUM_POINTS = 128;
+
+//Agreement of the estimated matrix with getEstimatedDistanceAndBearing (different
+//but equivalent formulas) and of its final bearings with the reverse initial bearings
+const double ESTIMATE_DISTANCE_TOLERANCE = 1.0e-6;
+const double ESTIMATE_BEARING_TOLERANCE = 1.0e-9;
+
+//Flight plans, waypoints per flight plan and points sampled per route
+const size_t NUM_ROUTES = 100;
+const size_t NUM_WAYPOINTS = 8;
+const size_t NUM_SAMPLES = 256;
+
+//Agreement of route samples with GeographicLib::Geodesic::Direct
+const double ROUTE_POSITION_TOLERANCE = 1.0e-6;
+const double ROUTE_BEARING_TOLERANCE = 1.0e-9;
+
+struct Options
+{
+	bool json = false;
+	double minTimeMs = 5.0;
+};
+
+//One benchmark record
+struct Result
+{
+	const char* set;
+	const char* method;
+	unsigned int threads;
+	double ns;
+	double solvedPercent;
+	double distanceError;
+	double bearingError;
+	std::string status;
+};
+
+//Origins and destinations (lat,lon in radians) and the maximum distance of the prefilter
+struct PointSet
+{
+	const char* name;
+	double maxDistance;
+	std::vector<double> originLatitudes, originLongitudes;
+	std::vector<double> destinationLatitudes, destinationLongitudes;
+};
+
+//Distance and bearing matrices
+struct Matrices
+{
+	std::vector<double> distances, initialBearings, finalBearings;
+
+	explicit Matrices(size_t numPairs) : distances(numPairs), initialBearings(numPairs), finalBearings(numPairs) {}
+};
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+volatile double sink = 0;
+
+//Best time per operation in ns over 3 trials of at least minTimeMs / 3 each, for
+//passes of count operations
+template <typename Pass>
+double timeOperations(Pass pass, size_t count, double minTimeMs)
+{
+	double trialTime = minTimeMs / 3.0;
+	double best = 0;
+
+	sink = sink + pass();
+
+	for (int trial = 0; trial < 3; trial++)
+	{
+		size_t passes = 0;
+		Clock::time_point start = Clock::now();
+		double elapsedMs = 0;
+		do {
+			sink = sink + pass();
+			passes++;
+			elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		} while (elapsedMs < trialTime);
+
+		double ns = elapsedMs * 1.0e6 / (double)(passes * count);
+		if (trial == 0 || ns < best) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Points with latitude uniform in its sine (uniform over the area) between the given bounds
+void makePoints(std::mt19937& rng, double minLatitudeDeg, double maxLatitudeDeg, double minLongitudeDeg, double maxLongitudeDeg,
+	std::vector<double>& latitudes, std::vector<double>& longitudes)
+{
+	std::uniform_real_distribution<double> sinLatitude(sin(minLatitudeDeg * DEG2RAD), sin(maxLatitudeDeg * DEG2RAD));
+	std::uniform_real_distribution<double> longitude(minLongitudeDeg * DEG2RAD, maxLongitudeDeg * DEG2RAD);
+
+	for (size_t i = 0; i < NUM_POINTS; i++)
+	{
+		latitudes.push_back(asin(sinLatitude(rng)));
+		longitudes.push_back(longitude(rng));
+	}
+}
+
+PointSet makeSet(const char* name, double maxDistance, double minLatitudeDeg, double maxLatitudeDeg,
+	double minLongitudeDeg, double maxLongitudeDeg)
+{
+	std::mt19937 rng(1234);
+
+	PointSet set;
+	set.name = name;
+	set.maxDistance = maxDistance;
+	makePoints(rng, minLatitudeDeg, maxLatitudeDeg, minLongitudeDeg, maxLongitudeDeg, set.originLatitudes, set.originLongitudes);
+	makePoints(rng, minLatitudeDeg, maxLatitudeDeg, minLongitudeDeg, maxLongitudeDeg, set.destinationLatitudes, set.destinationLongitudes);
+	return set;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool sameBits(double a, double b)
+{
+	return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+//Difference of two bearings in [0, 2 pi), as an angle in [0, pi]
+double bearingDifference(double a, double b)
+{
+	double difference = fabs(a - b);
+	return std::min(difference, 2.0 * PI - difference);
+}
+
+//Solve the matrices of a set
+void solveMatrix(const Ellipsoid& earth, const PointSet& set, Matrices& m, GeodesicSolution solution,
+	double maxDistance, ThreadPool* pool)
+{
+	earth.getDistanceAndBearingMatrix(set.originLatitudes.data(), set.originLongitudes.data(), NUM_POINTS,
+		set.destinationLatitudes.data(), set.destinationLongitudes.data(), NUM_POINTS,
+		m.distances.data(), m.initialBearings.data(), m.finalBearings.data(), solution, maxDistance, pool);
+}
+
+//Solve the matrices of a set pair by pair with an Ellipsoid function for a single pair
+typedef void (Ellipsoid::*PairFunction)(const Geodetic3&, const Geodetic3&, double&, double&, double&) const;
+
+void solvePairs(const Ellipsoid& earth, const PointSet& set, Matrices& m, PairFunction function)
+{
+	for (size_t i = 0; i < NUM_POINTS; i++)
+	{
+		Geodetic3 origin(set.originLatitudes[i], set.originLongitudes[i], 0.0);
+		for (size_t j = 0; j < NUM_POINTS; j++)
+		{
+			Geodetic3 destination(set.destinationLatitudes[j], set.destinationLongitudes[j], 0.0);
+			size_t k = i * NUM_POINTS + j;
+			(earth.*function)(origin, destination, m.distances[k], m.initialBearings[k], m.finalBearings[k]);
+		}
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Time the pair by pair solution of a set
+Result runPairs(const Ellipsoid& earth, const PointSet& set, const char* method, PairFunction function,
+	Matrices& m, const Options& options)
+{
+	Result r = { set.name, method, 1, 0.0, 100.0, 0.0, 0.0, "-" };
+	r.ns = timeOperations([&]() {
+		solvePairs(earth, set, m, function);
+		return m.distances[0];
+	}, NUM_POINTS * NUM_POINTS, options.minTimeMs);
+	return r;
+}
+
+//Time a matrix solution of a set, status "ok" if it is identical to the reference
+//for the pairs within maxDistance (all of them if not prefiltered)
+Result runMatrix(const Ellipsoid& earth, const PointSet& set, const char* method, GeodesicSolution solution,
+	double maxDistance, ThreadPool* pool, const Matrices& reference, const Options& options)
+{
+	size_t numPairs = NUM_POINTS * NUM_POINTS;
+	Matrices m(numPairs);
+
+	Result r = { set.name, method, pool ? pool->getNumThreads() : 1, 0.0, 100.0, 0.0, 0.0, "ok" };
+	r.ns = timeOperations([&]() {
+		solveMatrix(earth, set, m, solution, maxDistance, pool);
+		return m.distances[0];
+	}, numPairs, options.minTimeMs);
+
+	size_t solved = 0;
+	for (size_t k = 0; k < numPairs; k++)
+	{
+		bool same = sameBits(m.distances[k], reference.distances[k]) &&
+			sameBits(m.initialBearings[k], reference.initialBearings[k]) &&
+			sameBits(m.finalBearings[k], reference.finalBearings[k]);
+		if (same) {
+			solved++;
+		}
+		else if (maxDistance <= 0.0 || reference.distances[k] <= maxDistance) {
+			r.status = "mismatch";
+		}
+		if (maxDistance <= 0.0 || reference.distances[k] <= maxDistance)
+		{
+			r.distanceError = std::max(r.distanceError, fabs(m.distances[k] - reference.distances[k]));
+			r.bearingError = std::max(r.bearingError, bearingDifference(m.initialBearings[k], reference.initialBearings[k]));
+			r.bearingError = std::max(r.bearingError, bearingDifference(m.finalBearings[k], reference.finalBearings[k]));
+		}
+	}
+	r.solvedPercent = 100.0 * solved / numPairs;
+	return r;
+}
+
+//Time the estimated matrix of a set, status "ok" if its distances and initial bearings
+//are within tolerance of getEstimatedDistanceAndBearing and its final bearings of the
+//reverse initial bearings
+Result runEstimated(const Ellipsoid& earth, const PointSet& set, ThreadPool* pool, const Options& options)
+{
+	size_t numPairs = NUM_POINTS * NUM_POINTS;
+	Matrices m(numPairs);
+	Matrices reference(numPairs);
+	solvePairs(earth, set, reference, &Ellipsoid::getEstimatedDistanceAndBearing);
+
+	PointSet transposed = set;
+	std::swap(transposed.originLatitudes, transposed.destinationLatitudes);
+	std::swap(transposed.originLongitudes, transposed.destinationLongitudes);
+	Matrices reverse(numPairs);
+	solveMatrix(earth, transposed, reverse, GeodesicSolution::ESTIMATED, 0.0, nullptr);
+
+	Result r = { set.name, "estimated", pool ? pool->getNumThreads() : 1, 0.0, 0.0, 0.0, 0.0, "ok" };
+	r.ns = timeOperations([&]() {
+		solveMatrix(earth, set, m, GeodesicSolution::ESTIMATED, 0.0, pool);
+		return m.distances[0];
+	}, numPairs, options.minTimeMs);
+
+	for (size_t i = 0; i < NUM_POINTS; i++)
+	{
+		for (size_t j = 0; j < NUM_POINTS; j++)
+		{
+			size_t k = i * NUM_POINTS + j;
+			double reverseBearing = fmod(reverse.initialBearings[j * NUM_POINTS + i] + PI, 2.0 * PI);
+			r.distanceError = std::max(r.distanceError, fabs(m.distances[k] - reference.distances[k]));
+			r.bearingError = std::max(r.bearingError, bearingDifference(m.initialBearings[k], reference.initialBearings[k]));
+			r.bearingError = std::max(r.bearingError, bearingDifference(m.finalBearings[k], reverseBearing));
+		}
+	}
+	if (!(r.distanceError <= ESTIMATE_DISTANCE_TOLERANCE && r.bearingError <= ESTIMATE_BEARING_TOLERANCE)) {
+		r.status = "inaccurate";
+	}
+	return r;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void printHeader(const Options& options)
+{
+	if (!options.json) {
+		printf("set,method,threads,ns_per_pair,solved_pct,distance_error_m,bearing_error_rad,status\n");
+	}
+}
+
+void printResult(const Options& options, const Result& r)
+{
+	if (options.json)
+	{
+		printf("{\"set\":\"%s\",\"method\":\"%s\",\"threads\":%u,\"ns_per_pair\":%.3f,\"solved_pct\":%.1f,\"distance_error_m\":%.3g,\"bearing_error_rad\":%.3g,\"status\":\"%s\"}\n",
+			r.set, r.method, r.threads, r.ns, r.solvedPercent, r.distanceError, r.bearingError, r.status.c_str());
+	}
+	else
+	{
+		printf("%s,%s,%u,%.3f,%.1f,%.3g,%.3g,%s\n",
+			r.set, r.method, r.threads, r.ns, r.solvedPercent, r.distanceError, r.bearingError, r.status.c_str());
+	}
+	fflush(stdout);
+}
+
+//Matrices of every set, returns false if one is not within tolerance of its reference
+bool runMatrices(const Options& options)
+{
+	Ellipsoid earth(EARTH_A, EARTH_F);
+	ThreadPool pool2(2);
+	ThreadPool pool4(4);
+	fprintf(stderr, "%u hardware threads\n", std::thread::hardware_concurrency());
+
+	std::vector<PointSet> sets;
+	sets.push_back(makeSet("regional", 5.0e5, 35.0, 50.0, -5.0, 20.0));
+	sets.push_back(makeSet("global", 2.0e6, -90.0, 90.0, -180.0, 180.0));
+
+	bool accurate = true;
+	for (const PointSet& set : sets)
+	{
+		size_t numPairs = NUM_POINTS * NUM_POINTS;
+		Matrices vincenty(numPairs);
+		Matrices exact(numPairs);
+		Matrices estimate(numPairs);
+
+		std::vector<Result> results;
+		results.push_back(runPairs(earth, set, "pairs_estimated", &Ellipsoid::getEstimatedDistanceAndBearing, estimate, options));
+		results.push_back(runPairs(earth, set, "pairs_vincenty", &Ellipsoid::getDistanceAndBearing, vincenty, options));
+		results.push_back(runPairs(earth, set, "pairs_exact", &Ellipsoid::getExactDistanceAndBearing, exact, options));
+		results.push_back(runEstimated(earth, set, nullptr, options));
+		results.push_back(runEstimated(earth, set, &pool4, options));
+		results.push_back(runMatrix(earth, set, "vincenty", GeodesicSolution::VINCENTY, 0.0, nullptr, vincenty, options));
+		results.push_back(runMatrix(earth, set, "exact", GeodesicSolution::EXACT, 0.0, nullptr, exact, options));
+		results.push_back(runMatrix(earth, set, "exact", GeodesicSolution::EXACT, 0.0, &pool2, exact, options));
+		results.push_back(runMatrix(earth, set, "exact", GeodesicSolution::EXACT, 0.0, &pool4, exact, options));
+		results.push_back(runMatrix(earth, set, "exact_prefilter", GeodesicSolution::EXACT, set.maxDistance, nullptr, exact, options));
+		results.push_back(runMatrix(earth, set, "exact_prefilter", GeodesicSolution::EXACT, set.maxDistance, &pool4, exact, options));
+
+		for (const Result& r : results)
+		{
+			printResult(options, r);
+			accurate = accurate && r.status != "mismatch" && r.status != "inaccurate";
+		}
+
+		//error of the estimate the prefilter allows for
+		double worst = 0;
+		for (size_t k = 0; k < numPairs; k++)
+		{
+			if (exact.distances[k] > 0) {
+				worst = std::max(worst, fabs(estimate.distances[k] - exact.distances[k]) / exact.distances[k]);
+			}
+		}
+		fprintf(stderr, "%s: estimated distances within %.3f%% of the exact ones\n", set.name, 100.0 * worst);
+	}
+	return accurate;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Flight plans and the points sampled along them
+struct RouteSet
+{
+	std::vector<std::vector<Geodetic2>> waypoints;
+
+	//per leg, from GeographicLib::Geodesic::Inverse
+	std::vector<std::vector<double>> legLengths, legBearings;
+
+	//NUM_SAMPLES points per route, at equal distances: the leg, the distance along it,
+	//and GeographicLib::Geodesic::Direct from its start
+	std::vector<size_t> legs;
+	std::vector<double> offsets;
+	std::vector<double> latitudes, longitudes, bearings;
+};
+
+double toBearing(double azimuthDeg)
+{
+	return (azimuthDeg < 0 ? azimuthDeg + 360.0 : azimuthDeg) * DEG2RAD;
+}
+
+RouteSet makeRouteSet(const GeographicLib::Geodesic& geodesic)
+{
+	std::mt19937 rng(1234);
+	RouteSet set;
+	for (size_t r = 0; r < NUM_ROUTES; r++)
+	{
+		std::vector<double> latitudes, longitudes;
+		makePoints(rng, 25.0, 60.0, -125.0, -65.0, latitudes, longitudes);
+
+		std::vector<Geodetic2> waypoints;
+		std::vector<double> lengths, bearings;
+		double total = 0;
+		for (size_t i = 0; i < NUM_WAYPOINTS; i++)
+		{
+			waypoints.push_back(Geodetic2(latitudes[i], longitudes[i]));
+			if (i > 0)
+			{
+				double s12, azi1, azi2;
+				geodesic.Inverse(latitudes[i - 1] * RAD2DEG, longitudes[i - 1] * RAD2DEG, latitudes[i] * RAD2DEG, longitudes[i] * RAD2DEG,
+					s12, azi1, azi2);
+				lengths.push_back(s12);
+				bearings.push_back(azi1);
+				total += s12;
+			}
+		}
+
+		for (size_t i = 0; i < NUM_SAMPLES; i++)
+		{
+			double along = (i + 1 == NUM_SAMPLES) ? total : total / (NUM_SAMPLES - 1) * i;
+			size_t leg = 0;
+			while (leg + 1 < lengths.size() && along >= lengths[leg])
+			{
+				along -= lengths[leg];
+				leg++;
+			}
+
+			double latitude, longitude, azimuth;
+			geodesic.Direct(waypoints[leg].getLatitude() * RAD2DEG, waypoints[leg].getLongitude() * RAD2DEG, bearings[leg], along,
+				latitude, longitude, azimuth);
+			set.legs.push_back(leg);
+			set.offsets.push_back(along);
+			set.latitudes.push_back(latitude * DEG2RAD);
+			set.longitudes.push_back(longitude * DEG2RAD);
+			set.bearings.push_back(toBearing(azimuth));
+		}
+		set.waypoints.push_back(waypoints);
+		set.legLengths.push_back(lengths);
+		set.legBearings.push_back(bearings);
+	}
+	return set;
+}
+
+//Largest position and bearing differences of route samples from the reference, status "ok"
+//if within the route tolerance
+void measureRouteErrors(const RouteSet& set, const std::vector<double>& latitudes, const std::vector<double>& longitudes,
+	const std::vector<double>& bearings, Result& r)
+{
+	for (size_t k = 0; k < set.latitudes.size(); k++)
+	{
+		double north = (latitudes[k] - set.latitudes[k]) * EARTH_A;
+		double east = bearingDifference(longitudes[k] + PI, set.longitudes[k] + PI) * cos(set.latitudes[k]) * EARTH_A;
+		r.distanceError = std::max(r.distanceError, sqrt(north * north + east * east));
+		r.bearingError = std::max(r.bearingError, bearingDifference(bearings[k], set.bearings[k]));
+	}
+	if (!(r.distanceError <= ROUTE_POSITION_TOLERANCE && r.bearingError <= ROUTE_BEARING_TOLERANCE)) {
+		r.status = "inaccurate";
+	}
+}
+
+//Time the sampling of every route of a set by GeodesicRoute objects
+Result runRouteSample(const Ellipsoid& earth, const RouteSet& set, const char* method, bool exact,
+	RouteSpacing spacing, const Options& options)
+{
+	std::vector<GeodesicRoute*> routes;
+	for (const std::vector<Geodetic2>& waypoints : set.waypoints)
+	{
+		routes.push_back(new GeodesicRoute(earth, exact));
+		routes.back()->setWaypoints(waypoints.data(), waypoints.size());
+	}
+
+	size_t numPoints = NUM_ROUTES * NUM_SAMPLES;
+	std::vector<double> latitudes(numPoints), longitudes(numPoints), bearings(numPoints);
+
+	Result r = { "flight_plans", method, 1, 0.0, 100.0, 0.0, 0.0, "ok" };
+	r.ns = timeOperations([&]() {
+		for (size_t i = 0; i < NUM_ROUTES; i++)
+		{
+			size_t k = i * NUM_SAMPLES;
+			routes[i]->sample(NUM_SAMPLES, &latitudes[k], &longitudes[k], &bearings[k], spacing);
+		}
+		return latitudes[0];
+	}, numPoints, options.minTimeMs);
+
+	if (spacing == RouteSpacing::DISTANCE) {
+		measureRouteErrors(set, latitudes, longitudes, bearings, r);
+	}
+	else {
+		r.status = "-";
+	}
+	for (GeodesicRoute* route : routes) {
+		delete route;
+	}
+	return r;
+}
+
+//Time the points of every route of a set solved one at a time from the start of their leg
+template <typename Direct>
+Result runRouteDirect(const RouteSet& set, const char* method, Direct direct, const Options& options)
+{
+	size_t numPoints = NUM_ROUTES * NUM_SAMPLES;
+	std::vector<double> latitudes(numPoints), longitudes(numPoints), bearings(numPoints);
+
+	Result r = { "flight_plans", method, 1, 0.0, 100.0, 0.0, 0.0, "-" };
+	r.ns = timeOperations([&]() {
+		for (size_t k = 0; k < numPoints; k++)
+		{
+			size_t route = k / NUM_SAMPLES;
+			size_t leg = set.legs[k];
+			direct(set.waypoints[route][leg], set.legBearings[route][leg], set.offsets[k], latitudes[k], longitudes[k], bearings[k]);
+		}
+		return latitudes[0];
+	}, numPoints, options.minTimeMs);
+
+	std::string status = r.status;
+	measureRouteErrors(set, latitudes, longitudes, bearings, r);
+	r.status = status;
+	return r;
+}
+
+//Time setting the waypoints of every route of a set, with the legs cached or not; status
+//"ok" if exactly the legs missing from the cache are built
+Result runRouteBuild(const Ellipsoid& earth, const RouteSet& set, const char* method, bool cached, const Options& options)
+{
+	GeodesicRoute route(earth);
+	if (!cached) {
+		route.setMaxCachedLegs(0);
+	}
+
+	Result r = { "flight_plans", method, 1, 0.0, 100.0, 0.0, 0.0, "ok" };
+	unsigned long long passes = 0;
+	r.ns = timeOperations([&]() {
+		for (const std::vector<Geodetic2>& waypoints : set.waypoints) {
+			route.setWaypoints(waypoints.data(), waypoints.size());
+		}
+		passes++;
+		return route.getLength();
+	}, NUM_ROUTES * (NUM_WAYPOINTS - 1), options.minTimeMs);
+
+	//built once with the cache, every time without
+	unsigned long long legs = NUM_ROUTES * (NUM_WAYPOINTS - 1);
+	unsigned long long expected = cached ? legs : legs * passes;
+	if (route.getNumLegsBuilt() != expected) {
+		r.status = "mismatch";
+	}
+
+	//moving one waypoint rebuilds only its two legs
+	std::vector<Geodetic2> waypoints = set.waypoints[0];
+	route.setMaxCachedLegs(1024);
+	route.setWaypoints(waypoints.data(), waypoints.size());
+	unsigned long long built = route.getNumLegsBuilt();
+	waypoints[3] = Geodetic2(waypoints[3].getLatitude() + 1.0e-6, waypoints[3].getLongitude());
+	route.setWaypoints(waypoints.data(), waypoints.size());
+	if (route.getNumLegsBuilt() - built != 2) {
+		r.status = "mismatch";
+	}
+
+	//trimming the cache drops the least recently used legs: routes 0, 1, 0 and 2, then room for
+	//two routes keeps the legs of 0 and 2 and drops those of 1
+	const std::vector<std::vector<Geodetic2>>& plans = set.waypoints;
+	GeodesicRoute lruRoute(earth);
+	lruRoute.setMaxCachedLegs(3 * (NUM_WAYPOINTS - 1));
+	for (size_t plan : { 0, 1, 0, 2 }) {
+		lruRoute.setWaypoints(plans[plan].data(), plans[plan].size());
+	}
+	lruRoute.setMaxCachedLegs(2 * (NUM_WAYPOINTS - 1));
+	built = lruRoute.getNumLegsBuilt();
+	lruRoute.setWaypoints(plans[0].data(), plans[0].size());
+	bool keptRecent = lruRoute.getNumLegsBuilt() == built;
+	lruRoute.setWaypoints(plans[1].data(), plans[1].size());
+	if (!keptRecent || lruRoute.getNumLegsBuilt() - built != NUM_WAYPOINTS - 1) {
+		r.status = "mismatch";
+	}
+	return r;
+}
+
+//Routes sampled and built, returns false if a route is inaccurate or builds the wrong legs
+bool runRoutes(const Options& options)
+{
+	Ellipsoid earth(EARTH_A, EARTH_F);
+	GeographicLib::Geodesic geodesic(EARTH_A, EARTH_F);
+	RouteSet set = makeRouteSet(geodesic);
+
+	std::vector<Result> results;
+	results.push_back(runRouteDirect(set, "destination_point",
+		[&](const Geodetic2& start, double azimuthDeg, double along, double& latitude, double& longitude, double& bearing) {
+			Geodetic3 destination;
+			earth.getDestinationPoint(Geodetic3(start.getLatitude(), start.getLongitude(), 0.0), destination,
+				along, toBearing(azimuthDeg), bearing);
+			latitude = destination.getLatitude();
+			longitude = destination.getLongitude();
+		}, options));
+	results.push_back(runRouteDirect(set, "geographiclib_direct",
+		[&](const Geodetic2& start, double azimuthDeg, double along, double& latitude, double& longitude, double& bearing) {
+			double azimuth;
+			geodesic.Direct(start.getLatitude() * RAD2DEG, start.getLongitude() * RAD2DEG, azimuthDeg, along,
+				latitude, longitude, azimuth);
+			latitude *= DEG2RAD;
+			longitude *= DEG2RAD;
+			bearing = toBearing(azimuth);
+		}, options));
+	results.push_back(runRouteSample(earth, set, "route_sample", false, RouteSpacing::DISTANCE, options));
+	results.push_back(runRouteSample(earth, set, "route_sample_arc", false, RouteSpacing::ARC_LENGTH, options));
+	results.push_back(runRouteSample(earth, set, "route_sample_exact", true, RouteSpacing::DISTANCE, options));
+	results.push_back(runRouteBuild(earth, set, "route_build", false, options));
+	results.push_back(runRouteBuild(earth, set, "route_build_cached", true, options));
+
+	bool accurate = true;
+	for (const Result& r : results)
+	{
+		printResult(options, r);
+		accurate = accurate && r.status != "mismatch" && r.status != "inaccurate";
+	}
+	return accurate;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--format=json") {
+			options.json = true;
+		}
+		else if (arg == "--format=csv") {
+			options.json = false;
+		}
+		else if (arg.compare(0, 11, "--min-time=") == 0) {
+			options.minTimeMs = std::max(0.1, atof(arg.c_str() + 11));
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--format=csv|json] [--min-time=<ms>]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+} //namespace
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+		return 1;
+
+	printHeader(options);
+	bool accurate = runMatrices(options);
+	accurate = runRoutes(options) && accurate;
+
+	return accurate ? 0 : 1;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
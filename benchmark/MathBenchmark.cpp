@@ -0,0 +1,731 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       MathBenchmark.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FUNCTIONAL DESCRIPTION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Benchmark and check of the SIMD kernels of the tinymath types (tm/simd.h).
+
+Each operation with a kernel on some target (3x3 matrix product, 4x4 matrix
+times vector, quaternion rotation of a vector) and the 4x4 matrix product,
+which the compiler vectorizes as well, is run through its operator and
+through a copy of its scalar code, in double and float, on arrays of random
+operands.  One record is written per case with the cost of both, whether the
+kernel is used on this target, and whether the results are bit-for-bit
+identical.
+
+The filter banks, filter chains and PID banks of otMath are run next to the
+filter and PID objects they replace (Filters.h, PID.h), 1024 of each, with
+random constants and inputs through a scripted sequence: the time delta
+changes from 10 ms to 20 ms and then on every step for a while, the constants
+of a third of the filters change (for the PIDs as well the gains scheduled
+from a table for half of them), every fifth filter is reset and later all of
+them.  Every output of every step must be bit-for-bit that of the objects.
+One record is written per case with the cost per filter step of the objects
+and of the bank or chain.  The program returns 1 if any result differs.
+
+Usage: mathBenchmark [--format=csv|json] [--min-time=<ms>]
+
+	--format     csv (default, with a header line) or json (one object per line)
+	--min-time   minimum measured time per case in ms (default 5)
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "otMath.h"
+#include "FilterBank.h"
+#include "FilterChain.h"
+#include "PIDBank.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+using namespace otMath;
+using tmath::matrix;
+using tmath::quaternion;
+using tmath::vectorn;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+//Operands per timed pass, small enough to stay in cache
+const size_t NUM_OPERANDS = 1024;
+
+struct Options
+{
+	bool json = false;
+	double minTimeMs = 5.0;
+};
+
+//One benchmark record
+struct Result
+{
+	const char* type;
+	const char* operation;
+	bool kernel;
+	double nsScalar;
+	double nsOperator;
+	std::string status;
+};
+
+template <typename T> const char* typeName();
+template <> const char* typeName<double>() { return "double"; }
+template <> const char* typeName<float>() { return "float"; }
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Scalar code of the operators, as they compute without a kernel
+template <typename T>
+matrix<T, 3, 3> scalarMul(const matrix<T, 3, 3>& m1, const matrix<T, 3, 3>& m2)
+{
+	return matrix<T, 3, 3>(m1.xx * m2.xx + m1.xy * m2.yx + m1.xz * m2.zx,
+		m1.xx * m2.xy + m1.xy * m2.yy + m1.xz * m2.zy,
+		m1.xx * m2.xz + m1.xy * m2.yz + m1.xz * m2.zz,
+		m1.yx * m2.xx + m1.yy * m2.yx + m1.yz * m2.zx,
+		m1.yx * m2.xy + m1.yy * m2.yy + m1.yz * m2.zy,
+		m1.yx * m2.xz + m1.yy * m2.yz + m1.yz * m2.zz,
+		m1.zx * m2.xx + m1.zy * m2.yx + m1.zz * m2.zx,
+		m1.zx * m2.xy + m1.zy * m2.yy + m1.zz * m2.zy,
+		m1.zx * m2.xz + m1.zy * m2.yz + m1.zz * m2.zz);
+}
+
+template <typename T>
+matrix<T, 4, 4> scalarMul(const matrix<T, 4, 4>& m1, const matrix<T, 4, 4>& m2)
+{
+	return matrix<T, 4, 4>(m1.xx * m2.xx + m1.xy * m2.yx + m1.xz * m2.zx + m1.xw * m2.wx,
+		m1.xx * m2.xy + m1.xy * m2.yy + m1.xz * m2.zy + m1.xw * m2.wy,
+		m1.xx * m2.xz + m1.xy * m2.yz + m1.xz * m2.zz + m1.xw * m2.wz,
+		m1.xx * m2.xw + m1.xy * m2.yw + m1.xz * m2.zw + m1.xw * m2.ww,
+		m1.yx * m2.xx + m1.yy * m2.yx + m1.yz * m2.zx + m1.yw * m2.wx,
+		m1.yx * m2.xy + m1.yy * m2.yy + m1.yz * m2.zy + m1.yw * m2.wy,
+		m1.yx * m2.xz + m1.yy * m2.yz + m1.yz * m2.zz + m1.yw * m2.wz,
+		m1.yx * m2.xw + m1.yy * m2.yw + m1.yz * m2.zw + m1.yw * m2.ww,
+		m1.zx * m2.xx + m1.zy * m2.yx + m1.zz * m2.zx + m1.zw * m2.wx,
+		m1.zx * m2.xy + m1.zy * m2.yy + m1.zz * m2.zy + m1.zw * m2.wy,
+		m1.zx * m2.xz + m1.zy * m2.yz + m1.zz * m2.zz + m1.zw * m2.wz,
+		m1.zx * m2.xw + m1.zy * m2.yw + m1.zz * m2.zw + m1.zw * m2.ww,
+		m1.wx * m2.xx + m1.wy * m2.yx + m1.wz * m2.zx + m1.ww * m2.wx,
+		m1.wx * m2.xy + m1.wy * m2.yy + m1.wz * m2.zy + m1.ww * m2.wy,
+		m1.wx * m2.xz + m1.wy * m2.yz + m1.wz * m2.zz + m1.ww * m2.wz,
+		m1.wx * m2.xw + m1.wy * m2.yw + m1.wz * m2.zw + m1.ww * m2.ww);
+}
+
+template <typename T>
+vectorn<T, 4> scalarMul(const matrix<T, 4, 4>& m, const vectorn<T, 4>& v)
+{
+	return vectorn<T, 4>(v.x*m.xx + v.y*m.xy + v.z*m.xz + v.w*m.xw,
+		v.x*m.yx + v.y*m.yy + v.z*m.yz + v.w*m.yw,
+		v.x*m.zx + v.y*m.zy + v.z*m.zz + v.w*m.zw,
+		v.x*m.wx + v.y*m.wy + v.z*m.wz + v.w*m.ww);
+}
+
+template <typename T>
+vectorn<T, 3> scalarRotate(const quaternion<T>& q, const vectorn<T, 3>& v)
+{
+	T tx = static_cast<T>(2.0) * (v.y * q.z - v.z * q.y);
+	T ty = static_cast<T>(2.0) * (v.z * q.x - v.x * q.z);
+	T tz = static_cast<T>(2.0) * (v.x * q.y - v.y * q.x);
+	return vectorn<T, 3>(v.x + q.w * tx + (ty * q.z - tz * q.y),
+		v.y + q.w * ty + (tz * q.x - tx * q.z),
+		v.z + q.w * tz + (tx * q.y - ty * q.x));
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+volatile double sink = 0;
+
+//Best time per operation in ns over 3 trials of at least minTimeMs / 3 each
+template <typename Pass>
+double timeOperations(Pass pass, double minTimeMs)
+{
+	double trialTime = minTimeMs / 3.0;
+	double best = 0;
+
+	sink = sink + pass();
+
+	for (int trial = 0; trial < 3; trial++)
+	{
+		size_t passes = 0;
+		Clock::time_point start = Clock::now();
+		double elapsedMs = 0;
+		do {
+			sink = sink + pass();
+			passes++;
+			elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		} while (elapsedMs < trialTime);
+
+		double ns = elapsedMs * 1.0e6 / (double)(passes * NUM_OPERANDS);
+		if (trial == 0 || ns < best) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+//Times the operator and the scalar code of one operation over the operands a[i], b[i]
+//and compares their results
+template <typename R, typename A, typename B, typename Op, typename Scalar>
+Result runOperation(const char* type, const char* operation, bool kernel, const std::vector<A>& a, const std::vector<B>& b,
+	Op op, Scalar scalar, const Options& options)
+{
+	std::vector<R> out(a.size()), ref(a.size());
+	Result r;
+	r.type = type;
+	r.operation = operation;
+	r.kernel = kernel;
+	r.nsOperator = timeOperations([&]() {
+		for (size_t i = 0; i < a.size(); i++) {
+			out[i] = op(a[i], b[i]);
+		}
+		return (double)out[a.size() - 1][0];
+	}, options.minTimeMs);
+	r.nsScalar = timeOperations([&]() {
+		for (size_t i = 0; i < a.size(); i++) {
+			ref[i] = scalar(a[i], b[i]);
+		}
+		return (double)ref[a.size() - 1][0];
+	}, options.minTimeMs);
+	r.status = memcmp(out.data(), ref.data(), out.size() * sizeof(R)) == 0 ? "exact" : "mismatch";
+	return r;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void printHeader(const Options& options)
+{
+	if (!options.json) {
+		printf("type,operation,kernel,ns_scalar,ns_operator,status\n");
+	}
+}
+
+void printResult(const Options& options, const Result& r)
+{
+	if (options.json)
+	{
+		printf("{\"type\":\"%s\",\"operation\":\"%s\",\"kernel\":%s,\"ns_scalar\":%.3f,\"ns_operator\":%.3f,\"status\":\"%s\"}\n",
+			r.type, r.operation, r.kernel ? "true" : "false", r.nsScalar, r.nsOperator, r.status.c_str());
+	}
+	else
+	{
+		printf("%s,%s,%s,%.3f,%.3f,%s\n",
+			r.type, r.operation, r.kernel ? "yes" : "no", r.nsScalar, r.nsOperator, r.status.c_str());
+	}
+	fflush(stdout);
+}
+
+//Runs every operation for one value type, returns false if a result differs
+template <typename T>
+bool runType(const Options& options)
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<double> value(-2.0, 2.0);
+
+	std::vector<matrix<T, 3, 3>> a33(NUM_OPERANDS), b33(NUM_OPERANDS);
+	std::vector<matrix<T, 4, 4>> a44(NUM_OPERANDS), b44(NUM_OPERANDS);
+	std::vector<vectorn<T, 4>> v4(NUM_OPERANDS);
+	std::vector<vectorn<T, 3>> v3(NUM_OPERANDS);
+	std::vector<quaternion<T>> q(NUM_OPERANDS);
+	for (size_t i = 0; i < NUM_OPERANDS; i++)
+	{
+		for (int k = 0; k < 9; k++) {
+			((T*)a33[i])[k] = (T)value(rng);
+			((T*)b33[i])[k] = (T)value(rng);
+		}
+		for (int k = 0; k < 16; k++) {
+			((T*)a44[i])[k] = (T)value(rng);
+			((T*)b44[i])[k] = (T)value(rng);
+		}
+		v4[i] = vectorn<T, 4>((T)value(rng), (T)value(rng), (T)value(rng), (T)value(rng));
+		v3[i] = vectorn<T, 3>((T)value(rng), (T)value(rng), (T)value(rng));
+		q[i] = quaternion<T>((T)value(rng), (T)value(rng), (T)value(rng));
+	}
+
+	//whether the operators use a kernel on this target
+	T scratch[16];
+	bool kernel33 = tmath::simd::mul33((const T*)a33[0], (const T*)b33[0], scratch);
+	bool kernel44v = tmath::simd::mul44v((const T*)a44[0], (const T*)v4[0], scratch);
+	bool kernelRotate = tmath::simd::qrot((const T*)q[0], (const T*)v3[0], scratch);
+
+	std::vector<Result> results;
+	results.push_back(runOperation<matrix<T, 3, 3>>(typeName<T>(), "matrix33*matrix33", kernel33, a33, b33,
+		[](const matrix<T, 3, 3>& m1, const matrix<T, 3, 3>& m2) { return m1 * m2; },
+		[](const matrix<T, 3, 3>& m1, const matrix<T, 3, 3>& m2) { return scalarMul(m1, m2); }, options));
+	results.push_back(runOperation<matrix<T, 4, 4>>(typeName<T>(), "matrix44*matrix44", false, a44, b44,
+		[](const matrix<T, 4, 4>& m1, const matrix<T, 4, 4>& m2) { return m1 * m2; },
+		[](const matrix<T, 4, 4>& m1, const matrix<T, 4, 4>& m2) { return scalarMul(m1, m2); }, options));
+	results.push_back(runOperation<vectorn<T, 4>>(typeName<T>(), "matrix44*vector4", kernel44v, a44, v4,
+		[](const matrix<T, 4, 4>& m, const vectorn<T, 4>& v) { return m * v; },
+		[](const matrix<T, 4, 4>& m, const vectorn<T, 4>& v) { return scalarMul(m, v); }, options));
+	results.push_back(runOperation<vectorn<T, 3>>(typeName<T>(), "quaternion.rotate", kernelRotate, q, v3,
+		[](const quaternion<T>& qr, const vectorn<T, 3>& v) { return qr.rotate(v); },
+		[](const quaternion<T>& qr, const vectorn<T, 3>& v) { return scalarRotate(qr, v); }, options));
+
+	//rotate() must agree with the rotation matrix of the quaternion
+	double maxDiff = 0;
+	for (size_t i = 0; i < NUM_OPERANDS; i++) {
+		maxDiff = std::max(maxDiff, (double)(q[i].rotate(v3[i]) - matrix<T, 3, 3>(q[i]) * v3[i]).len());
+	}
+	if (maxDiff > 100.0 * std::numeric_limits<T>::epsilon()) {
+		results.back().status = "wrong rotation";
+	}
+
+	bool exact = true;
+	for (const Result& r : results)
+	{
+		printResult(options, r);
+		exact = exact && r.status == "exact";
+	}
+	return exact;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Steps of the filter sequence, and the steps where it changes the constants and resets
+const int NUM_STEPS = 200;
+const int STEP_CONSTANTS = 60;
+const int STEP_SCHEDULE = 90;
+const int STEP_RESET = 120;
+const int STEP_RESET_ALL = 170;
+
+//Time delta of a step of the filter sequence: 10 ms, 20 ms, then a different one each step
+double stepDt(int step)
+{
+	if (step < 50)
+		return 0.01;
+	if (step < 100)
+		return 0.02;
+	if (step < 150)
+		return 0.005 + 0.001*(step % 7);
+	return 0.01;
+}
+
+bool sameBits(double a, double b)
+{
+	return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+//Random constants of a filter kind, by its base
+template <typename FilterType>
+void randomConstants(const FirstOrderFilter*, std::mt19937& rng, double* c)
+{
+	c[0] = std::uniform_real_distribution<double>(0.5, 20.0)(rng);
+}
+template <typename FilterType>
+void randomConstants(const LeadLag*, std::mt19937& rng, double* c)
+{
+	std::uniform_real_distribution<double> timeConstant(0.05, 1.0);
+	c[0] = timeConstant(rng);	c[1] = 1.0;
+	c[2] = timeConstant(rng);	c[3] = 1.0;
+}
+template <typename FilterType>
+void randomConstants(const SecondOrderFilter*, std::mt19937& rng, double* c)
+{
+	double hz = std::uniform_real_distribution<double>(0.5, 20.0)(rng);
+	double zeta = std::uniform_real_distribution<double>(0.3, 1.0)(rng);
+	FilterTraits<FilterType>::naturalFreq(c, hz, zeta);
+}
+template <typename FilterType>
+void randomConstants(std::mt19937& rng, double* c)
+{
+	FilterTraits<FilterType>::defaults(c);
+	randomConstants<FilterType>(static_cast<const FilterType*>(nullptr), rng, c);
+}
+
+//Constants of a filter object
+void setConstants(FirstOrderFilter& filter, const double* c)
+{
+	filter.c1 = c[0];	filter.c2 = c[1];	filter.c3 = c[2];	filter.c4 = c[3];
+}
+void setConstants(SecondOrderFilter& filter, const double* c)
+{
+	filter.c1 = c[0];	filter.c2 = c[1];	filter.c3 = c[2];
+	filter.c4 = c[3];	filter.c5 = c[4];	filter.c6 = c[5];
+}
+
+//Constants of a filter of a bank
+template <typename FilterType>
+void setConstants(FilterBank<FilterType>& bank, size_t i, const double* c, std::false_type)
+{
+	bank.setConstants(i, c[0], c[1], c[2], c[3]);
+}
+template <typename FilterType>
+void setConstants(FilterBank<FilterType>& bank, size_t i, const double* c, std::true_type)
+{
+	bank.setConstants(i, c[0], c[1], c[2], c[3], c[4], c[5]);
+}
+template <typename FilterType>
+void setConstants(FilterBank<FilterType>& bank, size_t i, const double* c)
+{
+	setConstants(bank, i, c, std::integral_constant<bool, FilterBank<FilterType>::SECOND_ORDER>());
+}
+
+//A FilterBank against the filter objects, through the filter sequence
+template <typename FilterType>
+Result runFilterBank(const char* operation, const Options& options)
+{
+	std::mt19937 rng(4321);
+	std::uniform_real_distribution<double> value(-1.0, 1.0);
+	const size_t n = NUM_OPERANDS;
+
+	FilterBank<FilterType> bank(n);
+	std::vector<FilterType> objects(n);
+	double c[6];
+	for (size_t i = 0; i < n; i++)
+	{
+		randomConstants<FilterType>(rng, c);
+		setConstants(bank, i, c);
+		setConstants(objects[i], c);
+	}
+
+	std::vector<double> inputs(n);
+	bool exact = true;
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		double dt = stepDt(step);
+		for (size_t i = 0; i < n; i++)
+		{
+			if (step == STEP_CONSTANTS && i % 3 == 0)
+			{
+				randomConstants<FilterType>(rng, c);
+				setConstants(bank, i, c);
+				setConstants(objects[i], c);
+			}
+			if (step == STEP_RESET && i % 5 == 0)
+			{
+				bank.reset(i);
+				objects[i].reset();
+			}
+		}
+		if (step == STEP_RESET_ALL)
+		{
+			bank.reset();
+			for (FilterType& filter : objects) {
+				filter.reset();
+			}
+		}
+
+		for (size_t i = 0; i < n; i++)
+		{
+			inputs[i] = value(rng);
+			objects[i].filter(inputs[i], dt);
+		}
+		std::memcpy(bank.inputs(), inputs.data(), n * sizeof(double));
+		bank.step(dt);
+
+		for (size_t i = 0; i < n; i++) {
+			exact = exact && sameBits(bank.get(i), objects[i].get());
+		}
+	}
+
+	Result result = { "double", operation, false, 0, 0, exact ? "exact" : "differs" };
+	result.nsScalar = timeOperations([&]() {
+		double sum = 0;
+		for (size_t i = 0; i < n; i++) {
+			sum += objects[i].filter(inputs[i], 0.01)->get();
+		}
+		return sum;
+	}, options.minTimeMs);
+	result.nsOperator = timeOperations([&]() {
+		std::memcpy(bank.inputs(), inputs.data(), n * sizeof(double));
+		bank.step(0.01);
+		return bank.get(n - 1);
+	}, options.minTimeMs);
+	return result;
+}
+
+//A chain of filters against one object per stage, through the filter sequence
+Result runFilterChain(const Options& options)
+{
+	typedef FilterChain<LeadLag, FirstOrderLag, Washout, SecondOrderLowPass> Chain;
+	struct Objects
+	{
+		LeadLag leadLag;
+		FirstOrderLag lag;
+		Washout washout;
+		SecondOrderLowPass lowPass;
+
+		double filter(double input, double dt)
+		{
+			leadLag.filter(input, dt);
+			lag.filter(leadLag.get(), dt);
+			washout.filter(lag.get(), dt);
+			return lowPass.filter(washout.get(), dt)->get();
+		}
+		void reset()
+		{
+			leadLag.reset();	lag.reset();	washout.reset();	lowPass.reset();
+		}
+	};
+
+	std::mt19937 rng(5678);
+	std::uniform_real_distribution<double> value(-1.0, 1.0);
+	const size_t n = NUM_OPERANDS;
+
+	std::vector<Chain> chains(n);
+	std::vector<Objects> objects(n);
+	auto randomize = [&](size_t i)
+	{
+		double c[6];
+		randomConstants<LeadLag>(rng, c);
+		chains[i].stage<0>().setConstants(c);
+		setConstants(objects[i].leadLag, c);
+		randomConstants<FirstOrderLag>(rng, c);
+		chains[i].stage<1>().setConstants(c);
+		setConstants(objects[i].lag, c);
+		randomConstants<Washout>(rng, c);
+		chains[i].stage<2>().setConstants(c);
+		setConstants(objects[i].washout, c);
+		randomConstants<SecondOrderLowPass>(rng, c);
+		chains[i].stage<3>().setConstants(c);
+		setConstants(objects[i].lowPass, c);
+	};
+	for (size_t i = 0; i < n; i++) {
+		randomize(i);
+	}
+
+	std::vector<double> inputs(n);
+	bool exact = true;
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		double dt = stepDt(step);
+		for (size_t i = 0; i < n; i++)
+		{
+			if (step == STEP_CONSTANTS && i % 3 == 0) {
+				randomize(i);
+			}
+			if ((step == STEP_RESET && i % 5 == 0) || step == STEP_RESET_ALL)
+			{
+				chains[i].reset();
+				objects[i].reset();
+			}
+
+			inputs[i] = value(rng);
+			objects[i].filter(inputs[i], dt);
+			chains[i].filter(inputs[i], dt);
+			exact = exact && sameBits(chains[i].get<0>(), objects[i].leadLag.get()) &&
+				sameBits(chains[i].get<1>(), objects[i].lag.get()) &&
+				sameBits(chains[i].get<2>(), objects[i].washout.get()) &&
+				sameBits(chains[i].get(), objects[i].lowPass.get());
+		}
+	}
+
+	Result result = { "double", "FilterChain<LeadLag,FirstOrderLag,Washout,SecondOrderLowPass>", false, 0, 0,
+		exact ? "exact" : "differs" };
+	result.nsScalar = timeOperations([&]() {
+		double sum = 0;
+		for (size_t i = 0; i < n; i++) {
+			sum += objects[i].filter(inputs[i], 0.01);
+		}
+		return sum;
+	}, options.minTimeMs);
+	result.nsOperator = timeOperations([&]() {
+		double sum = 0;
+		for (size_t i = 0; i < n; i++) {
+			sum += chains[i].filter(inputs[i], 0.01);
+		}
+		return sum;
+	}, options.minTimeMs);
+	return result;
+}
+
+//A PIDBank against PID objects of the same types through the filter sequence, with wind-up stops
+//and the gains of half of the controllers scheduled from a table
+template <INTEGRATOR_TYPE Integrator, PID_TYPE Type>
+Result runPIDBank(const char* operation, const Options& options)
+{
+	std::mt19937 rng(8765);
+	std::uniform_real_distribution<double> value(-1.0, 1.0);
+	std::uniform_real_distribution<double> gain(0.0, 2.0);
+	std::uniform_int_distribution<int> stopping(0, 19);
+	const size_t n = NUM_OPERANDS;
+
+	PIDBank<Integrator, Type> bank(n);
+	std::vector<PID> objects(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		double kp = gain(rng), ki = gain(rng), kd = 0.1*gain(rng);
+		bank.setConstants(i, kp, ki, kd);
+		objects[i].setConstants(kp, ki, kd);
+		objects[i].setIntegratorType(Integrator);
+		objects[i].setPIDType(Type);
+	}
+
+	//Kp scheduled on a key per controller
+	Table<double> kpTable(5);
+	kpTable
+		<< 0.0		<< 0.2
+		<< 50.0		<< 0.5
+		<< 100.0	<< 1.0
+		<< 200.0	<< 1.2
+		<< 400.0	<< 0.8;
+	std::vector<double> keys(n);
+	for (size_t i = 0; i < n; i++) {
+		keys[i] = std::uniform_real_distribution<double>(0.0, 400.0)(rng);
+	}
+
+	std::vector<double> errors(n);
+	std::vector<char> stops(n);
+	bool exact = true;
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		double dt = stepDt(step);
+		if (step == STEP_SCHEDULE)
+		{
+			//objects before the scheduled ones keep their gains, the others take the bank's
+			bank.scheduleGain(PID_GAIN::KP, kpTable, keys.data(), n / 2, n - n / 2);
+			for (size_t i = n / 2; i < n; i++)
+			{
+				double kp = kpTable.interp(keys[i]);
+				exact = exact && sameBits(bank.gains(PID_GAIN::KP)[i], kp);
+			}
+		}
+		for (size_t i = 0; i < n; i++)
+		{
+			if (step == STEP_CONSTANTS && i % 3 == 0)
+			{
+				double kp = gain(rng), ki = gain(rng), kd = 0.1*gain(rng);
+				bank.setConstants(i, kp, ki, kd);
+				objects[i].setConstants(kp, ki, kd);
+			}
+			if (step == STEP_SCHEDULE && i >= n / 2)
+			{
+				objects[i].setConstants(bank.gains(PID_GAIN::KP)[i], bank.gains(PID_GAIN::KI)[i],
+					bank.gains(PID_GAIN::KD)[i]);
+			}
+			if (step == STEP_RESET && i % 5 == 0)
+			{
+				bank.reset(i);
+				objects[i].reset();
+			}
+		}
+		if (step == STEP_RESET_ALL)
+		{
+			bank.reset();
+			for (PID& pid : objects) {
+				pid.reset();
+			}
+		}
+
+		for (size_t i = 0; i < n; i++)
+		{
+			errors[i] = value(rng);
+			stops[i] = stopping(rng) == 0;
+			bank.setError(i, errors[i], stops[i] != 0);
+			objects[i].filter(errors[i], dt, stops[i] != 0);
+		}
+		bank.step(dt);
+
+		for (size_t i = 0; i < n; i++) {
+			exact = exact && sameBits(bank.get(i), objects[i].get());
+		}
+	}
+
+	Result result = { "double", operation, false, 0, 0, exact ? "exact" : "differs" };
+	result.nsScalar = timeOperations([&]() {
+		double sum = 0;
+		for (size_t i = 0; i < n; i++) {
+			sum += objects[i].filter(errors[i], 0.01)->get();
+		}
+		return sum;
+	}, options.minTimeMs);
+	result.nsOperator = timeOperations([&]() {
+		std::memcpy(bank.errors(), errors.data(), n * sizeof(double));
+		bank.step(0.01);
+		return bank.get(n - 1);
+	}, options.minTimeMs);
+	return result;
+}
+
+bool runFilters(const Options& options)
+{
+	std::vector<Result> results;
+	results.push_back(runFilterBank<Integrator>("FilterBank<Integrator>", options));
+	results.push_back(runFilterBank<Derivator>("FilterBank<Derivator>", options));
+	results.push_back(runFilterBank<FirstOrderLag>("FilterBank<FirstOrderLag>", options));
+	results.push_back(runFilterBank<Washout>("FilterBank<Washout>", options));
+	results.push_back(runFilterBank<LeadLag>("FilterBank<LeadLag>", options));
+	results.push_back(runFilterBank<SecondOrderLowPass>("FilterBank<SecondOrderLowPass>", options));
+	results.push_back(runFilterBank<SecondOrderHighPass>("FilterBank<SecondOrderHighPass>", options));
+	results.push_back(runFilterBank<BandPass>("FilterBank<BandPass>", options));
+	results.push_back(runFilterBank<Notch>("FilterBank<Notch>", options));
+	results.push_back(runFilterChain(options));
+	results.push_back(runPIDBank<INTEGRATOR_TYPE::RECTANGULAR, PID_TYPE::IDEAL>(
+		"PIDBank<RECTANGULAR,IDEAL>", options));
+	results.push_back(runPIDBank<INTEGRATOR_TYPE::TRAPEZOIDAL, PID_TYPE::STANDARD>(
+		"PIDBank<TRAPEZOIDAL,STANDARD>", options));
+	results.push_back(runPIDBank<INTEGRATOR_TYPE::ADAMS_BASHFORTH_2, PID_TYPE::STANDARD>(
+		"PIDBank<ADAMS_BASHFORTH_2,STANDARD>", options));
+	results.push_back(runPIDBank<INTEGRATOR_TYPE::ADAMS_BASHFORTH_3, PID_TYPE::IDEAL>(
+		"PIDBank<ADAMS_BASHFORTH_3,IDEAL>", options));
+
+	bool exact = true;
+	for (const Result& r : results)
+	{
+		printResult(options, r);
+		exact = exact && r.status == "exact";
+	}
+	return exact;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--format=json") {
+			options.json = true;
+		}
+		else if (arg == "--format=csv") {
+			options.json = false;
+		}
+		else if (arg.compare(0, 11, "--min-time=") == 0) {
+			options.minTimeMs = std::max(0.1, atof(arg.c_str() + 11));
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--format=csv|json] [--min-time=<ms>]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+} //namespace
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+		return 1;
+
+	printHeader(options);
+	bool exact = runType<double>(options);
+	exact = runType<float>(options) && exact;
+	exact = runFilters(options) && exact;
+
+	return exact ? 0 : 1;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -0,0 +1,581 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       TableBenchmark.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FUNCTIONAL DESCRIPTION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Interpolation benchmark for otMath::Table<double> and Table<float>.
+
+Every interpolation method is run on 1D, 2D and 3D tables of 4 to 10000
+breakpoints (cells for 2D/3D tables), with evenly and unevenly spaced
+breakpoints, for sorted, random and frame-coherent key sequences, through the
+plain, cursor and batched interp() calls.  One record is written per case with
+the cost per lookup, the time to build (stream in and finalize) the table and
+the memory used by the table.
+
+Before the benchmark, 1D, 2D and 3D tables are written to a binary table file
+and read back, and copies of the file with a header dimension that does not
+match its sections are checked to be rejected.  The program returns 1 if a
+table file check fails.
+
+Usage: tableBenchmark [--quick] [--format=csv|json] [--min-time=<ms>]
+
+	--quick      fewer table sizes, for a fast smoke run
+	--format     csv (default, with a header line) or json (one object per line)
+	--min-time   minimum measured time per case in ms (default 5)
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "Table.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+using otMath::InterpMethod;
+using otMath::Table;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+//Keys evaluated per timed pass, small enough to stay in cache
+const size_t NUM_KEYS = 4096;
+
+enum class KeyPattern { SORTED, RANDOM, COHERENT };
+enum class LookupApi { SCALAR, CURSOR, BATCH };
+
+struct Options
+{
+	bool quick = false;
+	bool json = false;
+	double minTimeMs = 5.0;
+};
+
+//One benchmark record
+struct Result
+{
+	const char* type;
+	unsigned int dims;
+	InterpMethod method;
+	InterpMethod effectiveMethod;
+	unsigned int size;
+	unsigned int rows, columns, tables;
+	bool uniform;
+	KeyPattern pattern;
+	LookupApi api;
+	double nsPerLookup;
+	double buildUs;
+	size_t memoryBytes;
+	std::string status;
+};
+
+const char* methodName(InterpMethod method)
+{
+	switch (method)
+	{
+	case InterpMethod::INTERP_LINEAR: return "linear";
+	case InterpMethod::INTERP_NEAREST: return "nearest";
+	case InterpMethod::INTERP_PCHIP: return "pchip";
+	case InterpMethod::INTERP_CUBIC: return "cubic";
+	case InterpMethod::INTERP_AKIMA: return "akima";
+	case InterpMethod::INTERP_QUINTIC: return "quintic";
+	case InterpMethod::INTERP_BESSEL: return "bessel";
+	case InterpMethod::INTERP_HERMITE: return "hermite";
+	}
+	return "unknown";
+}
+
+const char* patternName(KeyPattern pattern)
+{
+	return pattern == KeyPattern::SORTED ? "sorted" : pattern == KeyPattern::RANDOM ? "random" : "coherent";
+}
+
+const char* apiName(LookupApi api)
+{
+	return api == LookupApi::SCALAR ? "scalar" : api == LookupApi::CURSOR ? "cursor" : "batch";
+}
+
+template <typename T> const char* typeName();
+template <> const char* typeName<double>() { return "double"; }
+template <> const char* typeName<float>() { return "float"; }
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Breakpoints 0..n-1, unevenly spaced ones stretched by up to +-0.3 of an interval
+template <typename T>
+std::vector<T> makeBreakpoints(unsigned int n, bool uniform)
+{
+	std::vector<T> bp(n);
+	for (unsigned int i = 0; i < n; i++) {
+		bp[i] = (T)(uniform ? i : i + 0.3 * std::sin(1.7 * i));
+	}
+	bp[0] = 0;
+	bp[n - 1] = (T)(n - 1);
+	return bp;
+}
+
+//Smooth test surface
+inline double surface(double x, double y, double z)
+{
+	return std::sin(0.37 * x) + 0.5 * std::cos(0.23 * y) + 0.1 * x * 0.01 * y + 0.25 * std::sin(0.5 * z);
+}
+
+template <typename T>
+Table<T> build1D(unsigned int rows, bool uniform, InterpMethod method)
+{
+	std::vector<T> x = makeBreakpoints<T>(rows, uniform);
+	Table<T> table(rows, method);
+	for (unsigned int i = 0; i < rows; i++) {
+		table << x[i] << (T)surface(x[i], 0, 0);
+	}
+	return table;
+}
+
+template <typename T>
+Table<T> build2D(unsigned int rows, unsigned int columns, bool uniform, InterpMethod method, double z)
+{
+	std::vector<T> x = makeBreakpoints<T>(rows, uniform);
+	std::vector<T> y = makeBreakpoints<T>(columns, uniform);
+	Table<T> table(rows, columns, method);
+	for (unsigned int j = 0; j < columns; j++) {
+		table << y[j];
+	}
+	for (unsigned int i = 0; i < rows; i++)
+	{
+		table << x[i];
+		for (unsigned int j = 0; j < columns; j++) {
+			table << (T)surface(x[i], y[j], z);
+		}
+	}
+	return table;
+}
+
+template <typename T>
+Table<T> build3D(unsigned int rows, unsigned int columns, unsigned int tables, bool uniform, InterpMethod method)
+{
+	std::vector<T> z = makeBreakpoints<T>(tables, uniform);
+	std::vector<Table<T>> layers;
+	layers.reserve(tables);
+	for (unsigned int k = 0; k < tables; k++) {
+		layers.push_back(build2D<T>(rows, columns, uniform, method, z[k]));
+	}
+	return Table<T>(layers, z);
+}
+
+template <typename T>
+Table<T> buildTable(unsigned int dims, unsigned int rows, unsigned int columns, unsigned int tables, bool uniform, InterpMethod method)
+{
+	if (dims == 1)
+		return build1D<T>(rows, uniform, method);
+	if (dims == 2)
+		return build2D<T>(rows, columns, uniform, method, 0);
+	return build3D<T>(rows, columns, tables, uniform, method);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Keys over [0, n-1] in the given pattern.  Coherent keys are a random walk moving less than
+//one interval per key, like a vehicle state sampled every frame.
+template <typename T>
+std::vector<T> makeKeys(unsigned int n, KeyPattern pattern, std::mt19937& rng)
+{
+	std::vector<T> keys(NUM_KEYS);
+	double hi = n - 1;
+	std::uniform_real_distribution<double> uniform(0.0, hi);
+	std::uniform_real_distribution<double> step(-0.5, 0.5);
+	double walk = hi * 0.5;
+	for (size_t k = 0; k < NUM_KEYS; k++)
+	{
+		switch (pattern)
+		{
+		case KeyPattern::SORTED:
+			keys[k] = (T)(hi * k / (NUM_KEYS - 1));
+			break;
+		case KeyPattern::RANDOM:
+			keys[k] = (T)uniform(rng);
+			break;
+		case KeyPattern::COHERENT:
+			walk += step(rng);
+			walk = walk < 0 ? -walk : walk > hi ? 2 * hi - walk : walk;
+			keys[k] = (T)walk;
+			break;
+		}
+	}
+	return keys;
+}
+
+//One timed pass over the keys, returns a sum so the lookups cannot be optimized away
+template <typename T>
+double lookupPass(const Table<T>& table, unsigned int dims, LookupApi api, bool sortedKeys,
+	const std::vector<T>& rowKeys, const std::vector<T>& colKeys, const std::vector<T>& tableKeys, std::vector<T>& out)
+{
+	size_t n = rowKeys.size();
+	switch (api)
+	{
+	case LookupApi::SCALAR:
+		for (size_t k = 0; k < n; k++) {
+			out[k] = dims == 1 ? table.interp(rowKeys[k]) :
+				dims == 2 ? table.interp(rowKeys[k], colKeys[k]) :
+				table.interp(rowKeys[k], colKeys[k], tableKeys[k]);
+		}
+		break;
+	case LookupApi::CURSOR:
+	{
+		typename Table<T>::Cursor cursor;
+		for (size_t k = 0; k < n; k++) {
+			out[k] = dims == 1 ? table.interp(rowKeys[k], cursor) :
+				dims == 2 ? table.interp(rowKeys[k], colKeys[k], cursor) :
+				table.interp(rowKeys[k], colKeys[k], tableKeys[k], cursor);
+		}
+		break;
+	}
+	case LookupApi::BATCH:
+		if (dims == 1)
+			table.interp(rowKeys.data(), out.data(), n, false, sortedKeys);
+		else if (dims == 2)
+			table.interp(rowKeys.data(), colKeys.data(), out.data(), n, false, sortedKeys);
+		else
+			table.interp(rowKeys.data(), colKeys.data(), tableKeys.data(), out.data(), n, false, sortedKeys);
+		break;
+	}
+
+	double sum = 0;
+	for (size_t k = 0; k < n; k++) {
+		sum += out[k];
+	}
+	return sum;
+}
+
+volatile double sink = 0;
+
+//Best time per lookup in ns over 3 trials of at least minTimeMs / 3 each
+template <typename T>
+double timeLookups(const Table<T>& table, unsigned int dims, LookupApi api, KeyPattern pattern,
+	const std::vector<T>& rowKeys, const std::vector<T>& colKeys, const std::vector<T>& tableKeys, double minTimeMs)
+{
+	std::vector<T> out(rowKeys.size());
+	bool sortedKeys = pattern != KeyPattern::RANDOM;
+	double trialTime = minTimeMs / 3.0;
+	double best = 0;
+
+	//warm up caches and let a lazily finalized table build itself
+	sink = sink + lookupPass(table, dims, api, sortedKeys, rowKeys, colKeys, tableKeys, out);
+
+	for (int trial = 0; trial < 3; trial++)
+	{
+		size_t passes = 0;
+		Clock::time_point start = Clock::now();
+		double elapsedMs = 0;
+		do {
+			sink = sink + lookupPass(table, dims, api, sortedKeys, rowKeys, colKeys, tableKeys, out);
+			passes++;
+			elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		} while (elapsedMs < trialTime);
+
+		double ns = elapsedMs * 1.0e6 / (double)(passes * rowKeys.size());
+		if (trial == 0 || ns < best) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+//Average time to build the table in us, building repeatedly for at least minTimeMs
+template <typename T>
+double timeBuild(unsigned int dims, unsigned int rows, unsigned int columns, unsigned int tables, bool uniform, InterpMethod method, double minTimeMs)
+{
+	size_t builds = 0;
+	Clock::time_point start = Clock::now();
+	double elapsedMs = 0;
+	do {
+		Table<T> table = buildTable<T>(dims, rows, columns, tables, uniform, method);
+		sink = sink + table.getNumRows();
+		builds++;
+		elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	} while (elapsedMs < minTimeMs);
+
+	return elapsedMs * 1.0e3 / (double)builds;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void printHeader(const Options& options)
+{
+	if (!options.json) {
+		printf("type,dims,method,effective_method,size,rows,columns,tables,spacing,pattern,api,ns_per_lookup,build_us,memory_bytes,status\n");
+	}
+}
+
+void printResult(const Options& options, const Result& r)
+{
+	if (options.json)
+	{
+		printf("{\"type\":\"%s\",\"dims\":%u,\"method\":\"%s\",\"effective_method\":\"%s\",\"size\":%u,"
+			"\"rows\":%u,\"columns\":%u,\"tables\":%u,\"spacing\":\"%s\",\"pattern\":\"%s\",\"api\":\"%s\","
+			"\"ns_per_lookup\":%.3f,\"build_us\":%.3f,\"memory_bytes\":%zu,\"status\":\"%s\"}\n",
+			r.type, r.dims, methodName(r.method), methodName(r.effectiveMethod), r.size,
+			r.rows, r.columns, r.tables, r.uniform ? "uniform" : "nonuniform", patternName(r.pattern), apiName(r.api),
+			r.nsPerLookup, r.buildUs, r.memoryBytes, r.status.c_str());
+	}
+	else
+	{
+		printf("%s,%u,%s,%s,%u,%u,%u,%u,%s,%s,%s,%.3f,%.3f,%zu,%s\n",
+			r.type, r.dims, methodName(r.method), methodName(r.effectiveMethod), r.size,
+			r.rows, r.columns, r.tables, r.uniform ? "uniform" : "nonuniform", patternName(r.pattern), apiName(r.api),
+			r.nsPerLookup, r.buildUs, r.memoryBytes, r.status.c_str());
+	}
+	fflush(stdout);
+}
+
+//Methods worth running for a number of dimensions (3D tables take the method of their 2D layers)
+std::vector<InterpMethod> methodsFor(unsigned int dims)
+{
+	if (dims == 1)
+	{
+		return { InterpMethod::INTERP_LINEAR, InterpMethod::INTERP_NEAREST, InterpMethod::INTERP_PCHIP, InterpMethod::INTERP_CUBIC,
+			InterpMethod::INTERP_AKIMA, InterpMethod::INTERP_QUINTIC, InterpMethod::INTERP_BESSEL, InterpMethod::INTERP_HERMITE };
+	}
+	return { InterpMethod::INTERP_LINEAR, InterpMethod::INTERP_NEAREST, InterpMethod::INTERP_CUBIC,
+		InterpMethod::INTERP_AKIMA, InterpMethod::INTERP_QUINTIC };
+}
+
+template <typename T>
+void runType(const Options& options)
+{
+	std::vector<unsigned int> sizes;
+	if (options.quick)
+		sizes = { 4, 256, 10000 };
+	else
+		sizes = { 4, 16, 64, 256, 1024, 4096, 10000 };
+
+	const KeyPattern patterns[] = { KeyPattern::SORTED, KeyPattern::RANDOM, KeyPattern::COHERENT };
+	const LookupApi apis[] = { LookupApi::SCALAR, LookupApi::CURSOR, LookupApi::BATCH };
+
+	for (unsigned int dims = 1; dims <= 3; dims++)
+	{
+		for (InterpMethod method : methodsFor(dims))
+		{
+			for (unsigned int size : sizes)
+			{
+				//size is the number of breakpoints of 1D tables and the number of cells of 2D/3D tables
+				unsigned int perAxis = (unsigned int)std::lround(std::pow((double)size, 1.0 / dims));
+				perAxis = std::max(perAxis, 4u);
+				unsigned int rows = dims == 1 ? size : perAxis;
+				unsigned int columns = dims >= 2 ? perAxis : 1;
+				unsigned int tables = dims == 3 ? perAxis : 0;
+
+				for (int spacing = 0; spacing < 2; spacing++)
+				{
+					bool uniform = spacing == 0;
+					Result result;
+					result.type = typeName<T>();
+					result.dims = dims;
+					result.method = method;
+					result.effectiveMethod = method;
+					result.size = size;
+					result.rows = rows;
+					result.columns = columns;
+					result.tables = tables;
+					result.uniform = uniform;
+					result.nsPerLookup = 0;
+					result.buildUs = 0;
+					result.memoryBytes = 0;
+
+					//The Splines library throws for methods it cannot build
+					std::vector<Table<T>> built;
+					try
+					{
+						result.buildUs = timeBuild<T>(dims, rows, columns, tables, uniform, method, options.minTimeMs);
+						built.push_back(buildTable<T>(dims, rows, columns, tables, uniform, method));
+						result.status = "ok";
+					}
+					catch (const std::exception&)
+					{
+						result.status = "build_failed";
+					}
+
+					if (!built.empty())
+					{
+						const Table<T>& table = built[0];
+						result.effectiveMethod = table.getInterpolationMethod();
+						result.memoryBytes = table.getMemoryUsage();
+					}
+
+					std::mt19937 rng(12345u + size * 7u + dims);
+					for (KeyPattern pattern : patterns)
+					{
+						std::vector<T> rowKeys = makeKeys<T>(rows, pattern, rng);
+						std::vector<T> colKeys = makeKeys<T>(columns > 1 ? columns : 2, pattern, rng);
+						std::vector<T> tableKeys = makeKeys<T>(tables > 1 ? tables : 2, pattern, rng);
+						result.pattern = pattern;
+						for (LookupApi api : apis)
+						{
+							result.api = api;
+							if (!built.empty()) {
+								result.nsPerLookup = timeLookups(built[0], dims, api, pattern, rowKeys, colKeys, tableKeys, options.minTimeMs);
+							}
+							printResult(options, result);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Byte offsets of the dimensions in a binary table file header (after the magic, byte order,
+//version, value size and number of dimensions)
+const size_t FILE_NUM_ROWS = 20;
+const size_t FILE_NUM_COLUMNS = 24;
+
+bool readBytes(const char* path, std::vector<char>& bytes)
+{
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return false;
+	bytes.clear();
+	char buffer[4096];
+	size_t n;
+	while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		bytes.insert(bytes.end(), buffer, buffer + n);
+	}
+	fclose(file);
+	return true;
+}
+
+bool writeBytes(const char* path, const std::vector<char>& bytes)
+{
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+	bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+	fclose(file);
+	return written;
+}
+
+//Writes the table to a file and reads it back, then checks that copies of the file with one
+//header dimension changed are rejected.  Returns false if the table does not read back the
+//same or a corrupted file is accepted.
+template <typename T>
+bool checkTableFile(const char* name, const Table<T>& table, unsigned int dims, unsigned int rows, unsigned int columns,
+	unsigned int tables, const std::vector<std::pair<size_t, uint32_t>>& corruptions)
+{
+	const char* path = "tableBenchmark.ottb";
+	bool ok = table.writeFile(path);
+
+	Table<T> read(2);
+	ok = ok && read.readFile(path);
+	for (unsigned int i = 0; ok && i < 64; i++)
+	{
+		T row = (T)(0.13 * i * (rows - 1) / 8.0), column = (T)(0.11 * i * (columns - 1) / 8.0), layer = (T)(0.07 * i * (tables - 1) / 4.0);
+		T expected = dims == 1 ? table.interp(row) : dims == 2 ? table.interp(row, column) : table.interp(row, column, layer);
+		T value = dims == 1 ? read.interp(row) : dims == 2 ? read.interp(row, column) : read.interp(row, column, layer);
+		ok = value == expected;
+	}
+	if (!ok) {
+		fprintf(stderr, "%s %s table file: does not read back the table written\n", typeName<T>(), name);
+	}
+
+	std::vector<char> bytes;
+	if (ok && readBytes(path, bytes))
+	{
+		for (const std::pair<size_t, uint32_t>& corruption : corruptions)
+		{
+			std::vector<char> corrupted(bytes);
+			memcpy(&corrupted[corruption.first], &corruption.second, sizeof(uint32_t));
+			Table<T> rejected(2);
+			if (!writeBytes(path, corrupted) || rejected.readFile(path))
+			{
+				fprintf(stderr, "%s %s table file: header dimension at byte %u set to %u was accepted\n",
+					typeName<T>(), name, (unsigned int)corruption.first, corruption.second);
+				ok = false;
+			}
+		}
+	}
+	remove(path);
+	return ok;
+}
+
+template <typename T>
+bool checkTableFiles()
+{
+	bool ok = checkTableFile<T>("1D", build1D<T>(12, false, InterpMethod::INTERP_CUBIC), 1, 12, 1, 1,
+		{ { FILE_NUM_ROWS, 100000u }, { FILE_NUM_ROWS, 13u }, { FILE_NUM_COLUMNS, 2u } });
+	ok = checkTableFile<T>("2D", build2D<T>(9, 7, false, InterpMethod::INTERP_AKIMA, 0), 2, 9, 7, 1,
+		{ { FILE_NUM_ROWS, 100000u }, { FILE_NUM_ROWS, 8u }, { FILE_NUM_COLUMNS, 8u }, { FILE_NUM_COLUMNS, 6u } }) && ok;
+	ok = checkTableFile<T>("3D", build3D<T>(5, 6, 4, true, InterpMethod::INTERP_LINEAR), 3, 5, 6, 4,
+		{ { FILE_NUM_ROWS, 100000u }, { FILE_NUM_ROWS, 5u }, { FILE_NUM_COLUMNS, 6u } }) && ok;
+	return ok;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--quick") {
+			options.quick = true;
+		}
+		else if (arg == "--format=json") {
+			options.json = true;
+		}
+		else if (arg == "--format=csv") {
+			options.json = false;
+		}
+		else if (arg.compare(0, 11, "--min-time=") == 0) {
+			options.minTimeMs = std::max(0.1, atof(arg.c_str() + 11));
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--quick] [--format=csv|json] [--min-time=<ms>]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+} //namespace
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+		return 1;
+
+	bool valid = checkTableFiles<double>();
+	valid = checkTableFiles<float>() && valid;
+
+	printHeader(options);
+	runType<double>(options);
+	runType<float>(options);
+
+	return valid ? 0 : 1;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -0,0 +1,573 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       WorldBenchmark.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FUNCTIONAL DESCRIPTION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Benchmark and check of the otWorld Ellipsoid conversions on the WGS84 Earth.
+
+ECEF to geodetic: each conversion method of Ellipsoid::toGeodetic3, the array
+conversion (alone and split across a thread pool) and
+GeographicLib::Geocentric::Reverse are run on sets of positions (near the
+surface all over the globe, near the poles, in orbit, a grid of the globe from
+10 km below the surface out to the Moon, and close to the center where the
+array conversion falls back to the scalar one).  One record is written per
+method and set with the cost per conversion and the largest difference from
+GeographicLib in latitude, longitude (as an angle on the parallel) and height.
+
+Entity tracks: sets of entities moving along great circles (a ground vehicle, an
+aircraft, an aircraft over the pole and a satellite), with their positions
+converted a frame at a time as a simulation would, by Ellipsoid::toGeodetic3
+and by a GeodeticConverter per entity.
+
+Geodetic to ECEF: Ellipsoid::toECEF for a Geodetic3 and the array conversion
+are run on the GeographicLib coordinates of the same sets, and their results
+converted back by GeographicLib for the same differences.
+
+The program returns 1 if the closed form conversion is outside the accuracy
+documented in Ellipsoid.h, an array conversion is not within it of the scalar
+conversion, or a GeodeticConverter is not within the accuracy documented in
+GeodeticConverter.h.
+
+Usage: worldBenchmark [--format=csv|json] [--min-time=<ms>]
+
+	--format     csv (default, with a header line) or json (one object per line)
+	--min-time   minimum measured time per case in ms (default 5)
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "Ellipsoid.h"
+#include "GeodeticConverter.h"
+#include "ThreadPool.h"
+#include "GeographicLib/Geocentric.hpp"
+
+#include "Conversions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+using otWorld::Ellipsoid;
+using otWorld::Geodetic3;
+using otWorld::GeodeticConversion;
+using otWorld::GeodeticConverter;
+using otCore::ThreadPool;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+//WGS84
+const double EARTH_A = 6378137.0;
+const double EARTH_F = 1.0 / 298.257223563;
+
+//Random positions per set
+const size_t NUM_POSITIONS = 4096;
+
+//Accuracy of the closed form conversion documented in Ellipsoid.h
+const double CLOSED_FORM_ANGLE_TOLERANCE = 1.0e-15;
+const double CLOSED_FORM_HEIGHT_TOLERANCE = 1.0e-15;
+
+//Entities per track set and frames per entity
+const size_t NUM_ENTITIES = 64;
+const size_t NUM_FRAMES = 256;
+
+//Accuracy of GeodeticConverter documented in GeodeticConverter.h
+const double CONVERTER_ANGLE_TOLERANCE = 1.0e-14;
+const double CONVERTER_HEIGHT_TOLERANCE = 1.0e-15;
+
+struct Options
+{
+	bool json = false;
+	double minTimeMs = 5.0;
+};
+
+//One benchmark record
+struct Result
+{
+	const char* set;
+	const char* method;
+	double ns;
+	double latitudeError;
+	double longitudeError;
+	double heightError;
+	std::string status;
+};
+
+//A set of ECEF positions and their conversion by GeographicLib
+struct PositionSet
+{
+	const char* name;
+	bool nearCenter = false;	//inside the evolute, outside the documented accuracy and the iterative conversion
+	std::vector<Vector3> positions;
+	std::vector<Geodetic3> reference;
+
+	//the same as arrays
+	std::vector<double> x, y, z;
+	std::vector<double> latitudes, longitudes, heights;
+};
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+volatile double sink = 0;
+
+//Best time per operation in ns over 3 trials of at least minTimeMs / 3 each, for
+//passes of count operations
+template <typename Pass>
+double timeOperations(Pass pass, size_t count, double minTimeMs)
+{
+	double trialTime = minTimeMs / 3.0;
+	double best = 0;
+
+	sink = sink + pass();
+
+	for (int trial = 0; trial < 3; trial++)
+	{
+		size_t passes = 0;
+		Clock::time_point start = Clock::now();
+		double elapsedMs = 0;
+		do {
+			sink = sink + pass();
+			passes++;
+			elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		} while (elapsedMs < trialTime);
+
+		double ns = elapsedMs * 1.0e6 / (double)(passes * count);
+		if (trial == 0 || ns < best) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Geodetic3 geographicLibToGeodetic3(const GeographicLib::Geocentric& geocentric, const Vector3& position)
+{
+	double latitude = 0.0, longitude = 0.0, height = 0.0;
+	geocentric.Reverse(position[0], position[1], position[2], latitude, longitude, height);
+	return Geodetic3(latitude * DEG2RAD, longitude * DEG2RAD, height);
+}
+
+//Positions from geodetic coordinates, latitude uniform in its sine (uniform over the area)
+PositionSet makeRandomSet(const char* name, const Ellipsoid& earth, double minLatitudeDeg, double minHeight, double maxHeight)
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<double> sinLatitude(sin(minLatitudeDeg * DEG2RAD), 1.0);
+	std::uniform_real_distribution<double> longitude(-PI, PI);
+	std::uniform_real_distribution<double> height(minHeight, maxHeight);
+	std::bernoulli_distribution south(0.5);
+
+	PositionSet set;
+	set.name = name;
+	for (size_t i = 0; i < NUM_POSITIONS; i++)
+	{
+		double latitude = asin(sinLatitude(rng));
+		if (south(rng)) {
+			latitude = -latitude;
+		}
+		set.positions.push_back(earth.toECEF(Geodetic3(latitude, longitude(rng), height(rng))));
+	}
+	return set;
+}
+
+//Every 0.5 deg of latitude and 2 deg of longitude, from 10 km below the surface out to the Moon
+PositionSet makeGridSet(const Ellipsoid& earth)
+{
+	const double heights[] = { -1.0e4, -100.0, 0.0, 1.0, 100.0, 1.0e4, 1.0e5, 1.0e6, 3.6e7, 3.84e8 };
+
+	PositionSet set;
+	set.name = "globe_grid";
+	for (double height : heights) {
+		for (int i = -180; i <= 180; i++) {
+			for (int j = -90; j < 90; j++) {
+				set.positions.push_back(earth.toECEF(Geodetic3(0.5 * i * DEG2RAD, 2.0 * j * DEG2RAD, height)));
+			}
+		}
+	}
+	return set;
+}
+
+//Positions within 100 km of the center, with points on the axis and in the equatorial plane.
+//Those within about 43 km are inside the evolute of the meridian ellipse.
+PositionSet makeCenterSet()
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<double> coordinate(-1.0e5, 1.0e5);
+
+	PositionSet set;
+	set.name = "center";
+	set.nearCenter = true;
+	set.positions.push_back(Vector3(0.0, 0.0, 5.0e4));
+	set.positions.push_back(Vector3(0.0, 0.0, -5.0e4));
+	set.positions.push_back(Vector3(3.0e4, -4.0e4, 0.0));
+	while (set.positions.size() < NUM_POSITIONS) {
+		set.positions.push_back(Vector3(coordinate(rng), coordinate(rng), coordinate(rng)));
+	}
+	return set;
+}
+
+//Entities moving at speed (m/s) along great circles of radius (m) through random points (or
+//through the poles), positions stored a frame at a time: entity i of frame k at k * NUM_ENTITIES + i
+PositionSet makeTrackSet(const char* name, double radius, double speed, double frameTime, bool overPole)
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<double> angle(-PI, PI);
+	std::uniform_real_distribution<double> sinLatitude(-1.0, 1.0);
+
+	//orthonormal u, w spanning the plane of each great circle, and the starting angle
+	std::vector<Vector3> u, w;
+	std::vector<double> start;
+	for (size_t i = 0; i < NUM_ENTITIES; i++)
+	{
+		double longitude = angle(rng);
+		if (overPole)
+		{
+			u.push_back(Vector3(cos(longitude), sin(longitude), 0.0));
+			w.push_back(Vector3(0.0, 0.0, 1.0));
+			start.push_back(PI / 2.0 - speed * frameTime * NUM_FRAMES / radius / 2.0);
+		}
+		else
+		{
+			double c = sqrt(1.0 - pow(sinLatitude(rng), 2));
+			Vector3 a(c * cos(longitude), c * sin(longitude), sqrt(1.0 - c * c));
+			Vector3 b = (a * Vector3(cos(angle(rng)), sin(angle(rng)), 0.5)).unitVector();	//cross products
+			u.push_back(a);
+			w.push_back(b * a);
+			start.push_back(angle(rng));
+		}
+	}
+
+	PositionSet set;
+	set.name = name;
+	for (size_t k = 0; k < NUM_FRAMES; k++) {
+		for (size_t i = 0; i < NUM_ENTITIES; i++) {
+			double theta = start[i] + speed * frameTime * k / radius;
+			set.positions.push_back((u[i] * cos(theta) + w[i] * sin(theta)) * radius);
+		}
+	}
+	return set;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Measures the largest difference of the conversions of a set from GeographicLib, the status
+//is inaccurate if it is beyond the given accuracy (the closed form's by default).  Heights
+//are compared relative to the distance from the center (at least the radius).
+void measureErrors(const PositionSet& set, const std::vector<Geodetic3>& out, Result& r,
+	double angleTolerance = CLOSED_FORM_ANGLE_TOLERANCE, double heightTolerance = CLOSED_FORM_HEIGHT_TOLERANCE)
+{
+	r.latitudeError = r.longitudeError = r.heightError = 0.0;
+	bool accurate = true;
+	for (size_t i = 0; i < out.size(); i++)
+	{
+		const Geodetic3& ref = set.reference[i];
+		double latitudeError = fabs(out[i].getLatitude() - ref.getLatitude());
+		double longitudeError = fabs(remainder(out[i].getLongitude() - ref.getLongitude(), 2.0 * PI)) * cos(ref.getLatitude());
+		double heightError = fabs(out[i].getHeight() - ref.getHeight());
+		r.latitudeError = std::max(r.latitudeError, latitudeError);
+		r.longitudeError = std::max(r.longitudeError, longitudeError);
+		r.heightError = std::max(r.heightError, heightError);
+
+		double scale = std::max(set.positions[i].len(), EARTH_A);
+		accurate = accurate && latitudeError <= angleTolerance && longitudeError <= angleTolerance &&
+			heightError <= heightTolerance * scale;
+	}
+	r.status = accurate ? "ok" : "inaccurate";
+}
+
+//Times a conversion over a set and measures its largest difference from GeographicLib
+template <typename Convert>
+Result runConversion(const PositionSet& set, const char* method, Convert convert, const Options& options,
+	double angleTolerance = CLOSED_FORM_ANGLE_TOLERANCE, double heightTolerance = CLOSED_FORM_HEIGHT_TOLERANCE)
+{
+	std::vector<Geodetic3> out(set.positions.size());
+	Result r;
+	r.set = set.name;
+	r.method = method;
+	r.ns = timeOperations([&]() {
+		for (size_t i = 0; i < set.positions.size(); i++) {
+			out[i] = convert(set.positions[i]);
+		}
+		return out.back().getHeight();
+	}, set.positions.size(), options.minTimeMs);
+
+	measureErrors(set, out, r, angleTolerance, heightTolerance);
+	return r;
+}
+
+//Times an array conversion over a set and measures its largest difference from GeographicLib,
+//the status is also inaccurate if a result is not within the closed form accuracy of
+//toGeodetic3 for a Vector3 (the only check close to the center)
+Result runBatchConversion(const PositionSet& set, const char* method, const Ellipsoid& earth, ThreadPool* pool, const Options& options)
+{
+	size_t count = set.positions.size();
+	std::vector<double> latitudes(count), longitudes(count), heights(count);
+	Result r;
+	r.set = set.name;
+	r.method = method;
+	r.ns = timeOperations([&]() {
+		earth.toGeodetic3(set.x.data(), set.y.data(), set.z.data(), latitudes.data(), longitudes.data(), heights.data(),
+			count, GeodeticConversion::CLOSED_FORM, pool);
+		return heights.back();
+	}, count, options.minTimeMs);
+
+	std::vector<Geodetic3> out;
+	bool consistent = true;
+	for (size_t i = 0; i < count; i++)
+	{
+		out.push_back(Geodetic3(latitudes[i], longitudes[i], heights[i]));
+
+		Geodetic3 expected = earth.toGeodetic3(set.positions[i], GeodeticConversion::CLOSED_FORM);
+		consistent = consistent && fabs(latitudes[i] - expected.getLatitude()) <= CLOSED_FORM_ANGLE_TOLERANCE &&
+			fabs(remainder(longitudes[i] - expected.getLongitude(), 2.0 * PI)) <= CLOSED_FORM_ANGLE_TOLERANCE &&
+			fabs(heights[i] - expected.getHeight()) <= CLOSED_FORM_HEIGHT_TOLERANCE * std::max(set.positions[i].len(), EARTH_A);
+	}
+	measureErrors(set, out, r);
+	r.status = (consistent && (set.nearCenter || r.status == "ok")) ? "ok" : "inaccurate";
+	return r;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+//Times a geodetic to ECEF conversion of the GeographicLib coordinates of a set and measures the
+//largest difference of its results converted back by GeographicLib, the status is inaccurate if
+//a result is not within the closed form accuracy of toECEF for a Geodetic3
+template <typename Convert>
+Result runToECEF(const PositionSet& set, const char* method, Convert convert,
+	const Ellipsoid& earth, const GeographicLib::Geocentric& geocentric, const Options& options)
+{
+	size_t count = set.reference.size();
+	std::vector<double> x(count), y(count), z(count);
+	Result r;
+	r.set = set.name;
+	r.method = method;
+	r.ns = timeOperations([&]() {
+		convert(x.data(), y.data(), z.data());
+		return z.back();
+	}, count, options.minTimeMs);
+
+	std::vector<Geodetic3> out;
+	PositionSet roundTrip;
+	bool accurate = true;
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector3 position(x[i], y[i], z[i]);
+		out.push_back(geographicLibToGeodetic3(geocentric, position));
+
+		Vector3 expected = earth.toECEF(set.reference[i]);
+		accurate = accurate && (position - expected).len() <= CLOSED_FORM_HEIGHT_TOLERANCE * std::max(expected.len(), EARTH_A);
+	}
+	roundTrip.positions = set.positions;
+	roundTrip.reference = set.reference;
+	measureErrors(roundTrip, out, r);
+	r.status = accurate ? "ok" : "inaccurate";
+	return r;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void printHeader(const Options& options)
+{
+	if (!options.json) {
+		printf("set,method,ns,latitude_error_rad,longitude_error_rad,height_error_m,status\n");
+	}
+}
+
+void printResult(const Options& options, const Result& r)
+{
+	if (options.json)
+	{
+		printf("{\"set\":\"%s\",\"method\":\"%s\",\"ns\":%.3f,\"latitude_error_rad\":%.3g,\"longitude_error_rad\":%.3g,\"height_error_m\":%.3g,\"status\":\"%s\"}\n",
+			r.set, r.method, r.ns, r.latitudeError, r.longitudeError, r.heightError, r.status.c_str());
+	}
+	else
+	{
+		printf("%s,%s,%.3f,%.3g,%.3g,%.3g,%s\n",
+			r.set, r.method, r.ns, r.latitudeError, r.longitudeError, r.heightError, r.status.c_str());
+	}
+	fflush(stdout);
+}
+
+//Conversions on every set, returns false if the closed form or an array conversion is inaccurate
+bool runConversions(const Options& options)
+{
+	Ellipsoid earth(EARTH_A, EARTH_F);
+	const GeographicLib::Geocentric& geocentric = *earth.getGeocentricObj();
+	ThreadPool pool;
+
+	std::vector<PositionSet> sets;
+	sets.push_back(makeRandomSet("surface", earth, -90.0, -500.0, 15000.0));
+	sets.push_back(makeRandomSet("polar", earth, 89.9, -500.0, 15000.0));
+	sets.push_back(makeRandomSet("orbit", earth, -90.0, 2.0e5, 3.6e7));
+	sets.push_back(makeGridSet(earth));
+	sets.push_back(makeCenterSet());
+
+	bool accurate = true;
+	for (PositionSet& set : sets)
+	{
+		for (const Vector3& position : set.positions)
+		{
+			Geodetic3 reference = geographicLibToGeodetic3(geocentric, position);
+			set.reference.push_back(reference);
+			set.x.push_back(position[0]);
+			set.y.push_back(position[1]);
+			set.z.push_back(position[2]);
+			set.latitudes.push_back(reference.getLatitude());
+			set.longitudes.push_back(reference.getLongitude());
+			set.heights.push_back(reference.getHeight());
+		}
+
+		//only the closed form has a documented accuracy
+		if (!set.nearCenter)
+		{
+			Result iterative = runConversion(set, "iterative",
+				[&](const Vector3& position) { return earth.toGeodetic3(position, GeodeticConversion::ITERATIVE); }, options);
+			iterative.status = "-";
+			printResult(options, iterative);
+		}
+		Result closedForm = runConversion(set, "closed_form",
+			[&](const Vector3& position) { return earth.toGeodetic3(position, GeodeticConversion::CLOSED_FORM); }, options);
+		Result closedFormBatch = runBatchConversion(set, "closed_form_batch", earth, nullptr, options);
+		Result closedFormPool = runBatchConversion(set, "closed_form_batch_pool", earth, &pool, options);
+		Result geographicLib = runConversion(set, "geographiclib",
+			[&](const Vector3& position) { return geographicLibToGeodetic3(geocentric, position); }, options);
+		geographicLib.status = "-";
+		if (set.nearCenter) {
+			closedForm.status = "-";
+		}
+		printResult(options, closedForm);
+		printResult(options, closedFormBatch);
+		printResult(options, closedFormPool);
+		printResult(options, geographicLib);
+		accurate = accurate && closedForm.status != "inaccurate" && closedFormBatch.status == "ok" && closedFormPool.status == "ok";
+
+		//geodetic to ECEF, the array conversion checked against the scalar one
+		size_t count = set.reference.size();
+		Result toECEF = runToECEF(set, "to_ecef", [&](double* x, double* y, double* z) {
+			for (size_t i = 0; i < count; i++) {
+				Vector3 position = earth.toECEF(set.reference[i]);
+				x[i] = position[0];
+				y[i] = position[1];
+				z[i] = position[2];
+			}
+		}, earth, geocentric, options);
+		Result toECEFBatch = runToECEF(set, "to_ecef_batch", [&](double* x, double* y, double* z) {
+			earth.toECEF(set.latitudes.data(), set.longitudes.data(), set.heights.data(), x, y, z, count);
+		}, earth, geocentric, options);
+		Result toECEFPool = runToECEF(set, "to_ecef_batch_pool", [&](double* x, double* y, double* z) {
+			earth.toECEF(set.latitudes.data(), set.longitudes.data(), set.heights.data(), x, y, z, count, &pool);
+		}, earth, geocentric, options);
+		toECEF.status = "-";
+		printResult(options, toECEF);
+		printResult(options, toECEFBatch);
+		printResult(options, toECEFPool);
+		accurate = accurate && toECEFBatch.status == "ok" && toECEFPool.status == "ok";
+	}
+
+	//entity tracks, a converter per entity
+	std::vector<PositionSet> tracks;
+	tracks.push_back(makeTrackSet("vehicle_track", EARTH_A, 20.0, 0.02, false));
+	tracks.push_back(makeTrackSet("aircraft_track", EARTH_A + 1.0e4, 250.0, 0.01, false));
+	tracks.push_back(makeTrackSet("polar_track", EARTH_A + 1.0e4, 250.0, 0.01, true));
+	tracks.push_back(makeTrackSet("orbit_track", EARTH_A + 4.0e5, 7670.0, 0.1, false));
+
+	for (PositionSet& set : tracks)
+	{
+		for (const Vector3& position : set.positions) {
+			set.reference.push_back(geographicLibToGeodetic3(geocentric, position));
+		}
+
+		std::vector<GeodeticConverter*> converters;
+		for (size_t i = 0; i < NUM_ENTITIES; i++) {
+			converters.push_back(new GeodeticConverter(earth));
+		}
+		size_t next = 0;	//positions are converted in order, entity next % NUM_ENTITIES
+
+		Result iterative = runConversion(set, "iterative",
+			[&](const Vector3& position) { return earth.toGeodetic3(position, GeodeticConversion::ITERATIVE); }, options);
+		Result closedForm = runConversion(set, "closed_form",
+			[&](const Vector3& position) { return earth.toGeodetic3(position, GeodeticConversion::CLOSED_FORM); }, options);
+		Result converter = runConversion(set, "converter",
+			[&](const Vector3& position) { return converters[next++ % NUM_ENTITIES]->toGeodetic3(position); }, options,
+			CONVERTER_ANGLE_TOLERANCE, CONVERTER_HEIGHT_TOLERANCE);
+		Result geographicLib = runConversion(set, "geographiclib",
+			[&](const Vector3& position) { return geographicLibToGeodetic3(geocentric, position); }, options);
+
+		unsigned long long warm = 0;
+		unsigned long long full = 0;
+		for (GeodeticConverter* c : converters)
+		{
+			warm += c->getNumWarmConversions();
+			full += c->getNumFullConversions();
+			delete c;
+		}
+		fprintf(stderr, "%s: %.1f%% of the converter conversions warm started\n", set.name, 100.0 * warm / (warm + full));
+
+		iterative.status = geographicLib.status = "-";
+		printResult(options, iterative);
+		printResult(options, closedForm);
+		printResult(options, converter);
+		printResult(options, geographicLib);
+		accurate = accurate && closedForm.status == "ok" && converter.status == "ok";
+	}
+	return accurate;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--format=json") {
+			options.json = true;
+		}
+		else if (arg == "--format=csv") {
+			options.json = false;
+		}
+		else if (arg.compare(0, 11, "--min-time=") == 0) {
+			options.minTimeMs = std::max(0.1, atof(arg.c_str() + 11));
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--format=csv|json] [--min-time=<ms>]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+} //namespace
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+		return 1;
+
+	printHeader(options);
+	bool accurate = runConversions(options);
+
+	return accurate ? 0 : 1;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -0,0 +1,107 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       ThreadPool.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef ThreadPool_H
+#define ThreadPool_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+#include <functional>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#if !defined(_WIN32)
+#define CORE_API
+#elif defined(CORE_EXPORTS)
+#define CORE_API __declspec(dllexport)
+#else
+#define CORE_API __declspec(dllimport)
+#endif
+
+namespace otCore {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Pool of worker threads for splitting large loops over arrays.
+
+parallelFor() splits the items of a loop into chunks and runs them on the workers
+and on the calling thread, returning once every chunk is done.  Each thread starts
+on its own contiguous share of the chunks and then steals the chunks left in the
+shares of the others, so a thread that gets cheap chunks takes more of them.
+
+One loop runs at a time: parallelFor() calls from other threads wait for the
+running loop, and a call from inside a chunk runs on that thread alone.
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+ThreadPool pool;	//one thread per hardware thread
+
+pool.parallelFor(count, 4096, [&](size_t begin, size_t end) {
+	for (size_t i = begin; i < end; i++) {
+		out[i] = compute(in[i]);
+	}
+});
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+class CORE_API ThreadPool
+{
+public:
+	/// Constructor takes the number of threads running the loops, the calling thread included
+	/// (0 for the number of hardware threads)
+	explicit ThreadPool(unsigned int numberThreads = 0);
+
+	/// Destructor, waits for the workers to exit
+	~ThreadPool();
+
+	/// Get the number of threads running the loops, the calling thread included
+	unsigned int getNumThreads() const;
+
+	/// Run function(begin, end) over consecutive chunks of chunkSize items (the last one
+	/// smaller) covering the items 0 to count - 1, and return when they are all done.  If the
+	/// function throws, no further chunk starts and the first exception is rethrown here
+	/// once the chunks already running are done
+	void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& function);
+
+private:
+	// Make this object be noncopyable
+	ThreadPool(const ThreadPool& threadPool);
+	const ThreadPool &operator =(const ThreadPool &);
+
+	// Pointer to implementation
+	class Impl;
+	Impl* mImpl;
+};
+
+} //namespace otCore
+
+#endif //ThreadPool_H
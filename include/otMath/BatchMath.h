@@ -0,0 +1,165 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       BatchMath.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef BatchMath_H
+#define BatchMath_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/*
+Transcendental functions for loops over arrays.  The standard library functions are
+calls the compiler cannot vectorize; these are inline, without branches (every
+condition is a bitwise select between computed values), so a loop calling them over
+arrays vectorizes.  Each is within 2 ulp of the standard function over the documented
+range, the caller checks that its arguments are in it.
+
+sin and cos are the fdlibm kernels after a Cody-Waite reduction by pi/2, atan2 is the
+Cephes rational approximation, cbrt refines the fdlibm initial estimate with Halley
+steps and a final Newton step.
+*/
+
+namespace otMath {
+
+/// All bits set if the sign bit of x is set (x negative or -0), otherwise none
+inline uint64_t batchSignMask(double x)
+{
+	uint64_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	return 0 - (bits >> 63);
+}
+
+/// a where mask is set, b elsewhere (bitwise, so no compare or branch)
+inline double batchSelect(uint64_t mask, double a, double b)
+{
+	uint64_t aBits, bBits;
+	std::memcpy(&aBits, &a, sizeof(aBits));
+	std::memcpy(&bBits, &b, sizeof(bBits));
+	uint64_t bits = (aBits & mask) | (bBits & ~mask);
+	double result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+/// Largest |x| batchSinCos reduces exactly
+const double BATCH_SINCOS_MAX = 1.0e5;
+
+/// Sine and cosine of x, for |x| <= BATCH_SINCOS_MAX
+inline void batchSinCos(double x, double& sine, double& cosine)
+{
+	const double TWO_OVER_PI = 6.36619772367581382433e-01;
+	const double PIO2_1 = 1.57079632673412561417e+00;	// first 33 bits of pi/2
+	const double PIO2_2 = 6.07710050630396597660e-11;	// next 33 bits
+	const double PIO2_2T = 2.02226624879595063154e-21;	// pi/2 - PIO2_1 - PIO2_2
+	const double SHIFTER = 6755399441055744.0;			// 1.5 * 2^52, rounds to an integer
+
+	// nearest multiple n of pi/2, the low bits of the shifted value are n mod 4
+	double shifted = x * TWO_OVER_PI + SHIFTER;
+	uint64_t bits;
+	std::memcpy(&bits, &shifted, sizeof(bits));
+	double n = shifted - SHIFTER;
+	double r = ((x - n * PIO2_1) - n * PIO2_2) - n * PIO2_2T;
+
+	// sin and cos of r in [-pi/4, pi/4]
+	double z = r * r;
+	double w = z * z;
+	double sr = 8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 + z * 2.75573137070700676789e-06) +
+		z * w * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10);
+	double sinR = r + z * r * (-1.66666666666666324348e-01 + z * sr);
+	double cr = z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 + z * 2.48015872894767294178e-05)) +
+		w * w * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11));
+	double hz = 0.5 * z;
+	double cw = 1.0 - hz;
+	double cosR = cw + (((1.0 - cw) - hz) + z * cr);
+
+	// back to the quadrant of x: swapped in odd quadrants, negated in quadrants 2 and 3 (sine)
+	// or 1 and 2 (cosine)
+	uint64_t odd = 0 - (bits & 1);
+	double s = batchSelect(odd, cosR, sinR);
+	double c = batchSelect(odd, sinR, cosR);
+	sine = batchSelect(0 - ((bits >> 1) & 1), -s, s);
+	cosine = batchSelect(0 - (((bits + 1) >> 1) & 1), -c, c);
+}
+
+/// Arc tangent of y / x in the quadrant of (x, y), in [-pi, pi]
+inline double batchAtan2(double y, double x)
+{
+	const double PIO4 = 7.85398163397448278999e-01;
+	const double PIO2 = 1.57079632679489655800e+00;
+	const double PI_ = 3.14159265358979311600e+00;
+	const double MOREBITS = 6.123233995736765886130e-17;	// pi/2 - PIO2
+
+	// atan of t = min / max in [0, 1] (0 for x = y = 0), reduced to [0, 0.66] with
+	// atan(t) = pi/4 + atan((t - 1) / (t + 1)).  The conditions are masks from sign bits:
+	// the compiler turns a select feeding a division back into a branch.
+	double ax = std::fabs(x);
+	double ay = std::fabs(y);
+	double t = std::min(ax, ay) / std::max(std::max(ax, ay), DBL_MIN);
+	double reduced = batchSelect(batchSignMask(0.66 - t), 1.0, 0.0);
+	double u = (t - reduced) / (1.0 + reduced * t);
+
+	double z = u * u;
+	double p = (((-8.750608600031904122785e-01 * z - 1.615753718733365076637e+01) * z - 7.500855792314704667340e+01) * z -
+		1.228866684490136173410e+02) * z - 6.485021904942025371773e+01;
+	double q = ((((z + 2.485846490142306297962e+01) * z + 1.650270098316988542046e+02) * z + 4.328810604912902668951e+02) * z +
+		4.853903996359136964868e+02) * z + 1.945506571482613964425e+02;
+	double a = reduced * PIO4 + ((u + u * (z * p / q)) + reduced * (0.5 * MOREBITS));
+
+	// quadrant of (x, y)
+	a = batchSelect(batchSignMask(ax - ay), (PIO2 - a) + MOREBITS, a);
+	a = batchSelect(batchSignMask(x), (PI_ - a) + 2.0 * MOREBITS, a);
+	return std::copysign(a, y);
+}
+
+/// Cube root of x, for normal (not zero or subnormal) |x| below 1e307
+inline double batchCbrt(double x)
+{
+	// estimate to 5 bits from the exponent and leading bits of |x| divided by 3 (fdlibm)
+	double ax = std::fabs(x);
+	uint64_t bits;
+	std::memcpy(&bits, &ax, sizeof(bits));
+	uint32_t high = (uint32_t)(bits >> 32) / 3 + 715094163u;
+	bits = (uint64_t)high << 32;
+	double t;
+	std::memcpy(&t, &bits, sizeof(t));
+
+	// Halley steps, tripling the correct bits to 45
+	for (int i = 0; i < 2; i++) {
+		double t3 = t * t * t;
+		t = t + t * ((ax - t3) / (2.0 * t3 + ax));
+	}
+
+	// rounded to 22 bits so t * t is exact, then a last Halley step as fdlibm (error < 0.667 ulp)
+	std::memcpy(&bits, &t, sizeof(bits));
+	bits = (bits + 0x80000000u) & 0xffffffffc0000000u;
+	std::memcpy(&t, &bits, sizeof(t));
+	double r = ax / (t * t);
+	r = (r - t) / (t + t + r);
+	t = t + t * r;
+
+	return std::copysign(t, x);
+}
+
+} //namespace otMath
+
+#endif //BatchMath_H
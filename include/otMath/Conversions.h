@@ -29,7 +29,9 @@ FORWARD DECLARATIONS
 DEFINITIONS
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
-#ifdef MATH_EXPORTS
+#if !defined(_WIN32)
+#define MATH_API
+#elif defined(MATH_EXPORTS)
 #define MATH_API __declspec(dllexport)
 #else
 #define MATH_API __declspec(dllimport)
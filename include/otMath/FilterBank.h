@@ -0,0 +1,385 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       FilterBank.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef FilterBank_H
+#define FilterBank_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+#include <vector>
+
+#include "FilterTraits.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Bank of many Tustin filters of the same kind, stepped together.
+
+FilterType is one of the filter classes of Filters.h (FirstOrderLag, Washout,
+LeadLag, Integrator, Derivator, SecondOrderLowPass, Notch, ...).  Each filter of
+the bank behaves like an object of that class, but the bank stores the states,
+constants and discrete coefficients of all its filters in separate arrays
+(structure of arrays), and only recomputes the coefficients of a filter when
+its constants change, or of every filter when dt changes.  step() then updates
+every filter in one branch-free loop over those arrays, which the compiler
+vectorizes, with no virtual call per filter.
+
+Constants are numbered as in the filter classes (c1 to c4 for first-order
+filters, c1 to c6 for second-order ones) and default to their values.  Second
+order kinds apply their fixed constants like their runFilter() does.  The
+coefficients come from FilterTraits and the recurrence is the one of the filter
+classes, so outputs are bit-for-bit those of the filter objects when
+floating-point contraction is off (-ffp-contract=off, the /fp:precise default);
+with contraction on they can differ in the last bits.
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+//one lag per actuator
+FilterBank<FirstOrderLag> actuators(numActuators);
+for (size_t i = 0; i < numActuators; i++) {
+	actuators.setConstants(i, 1.0 / timeConstant[i]);
+}
+
+//every frame
+for (size_t i = 0; i < numActuators; i++) {
+	actuators.set(i, commands[i]);
+}
+actuators.step(dt);
+double position = actuators.get(0);
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename FilterType>
+class FilterBank
+{
+public:
+	/// True for banks of second-order filters
+	static const bool SECOND_ORDER = FilterTraits<FilterType>::SECOND_ORDER;
+	/// Number of constants of each filter
+	static const unsigned int NUM_CONSTANTS = FilterTraits<FilterType>::NUM_CONSTANTS;
+
+	/// Constructor takes the number of filters in the bank
+	explicit FilterBank(size_t count = 0)
+	{
+		for (size_t i = 0; i < count; i++) {
+			add();
+		}
+	}
+
+	/// Add a filter with the default constants of FilterType, returns its index
+	size_t add()
+	{
+		double c[6] = { 0, 0, 0, 0, 0, 0 };
+		FilterTraits<FilterType>::defaults(c);
+
+		for (unsigned int k = 0; k < NUM_CONSTANTS; k++) {
+			constants[k].push_back(c[k]);
+		}
+		input.push_back(0);
+		in1.push_back(0);
+		in2.push_back(0);
+		out1.push_back(0);
+		out2.push_back(0);
+		for (unsigned int k = 0; k < 5; k++) {
+			coefficients[k].push_back(0);
+		}
+		held.push_back(0);
+		initGain.push_back(0);
+		initialized.push_back(0);
+		dirty.push_back(1);
+		anyDirty = true;
+		anyUninitialized = true;
+		return input.size() - 1;
+	}
+
+	/// Number of filters in the bank
+	size_t size() const { return input.size(); }
+
+	/// Set the first constant C1 of a filter (1 / tau for lags and washouts, the gain of integrators),
+	/// keeping the others.  Filter types that fix C1 (second-order low-pass) keep their value
+	void setConstants(size_t i, double c_1)
+	{
+		double c[6] = { 0, 0, 0, 0, 0, 0 };
+		for (unsigned int k = 0; k < NUM_CONSTANTS; k++) {
+			c[k] = constants[k][i];
+		}
+		c[0] = c_1;
+		setConstants(i, c);
+	}
+
+	/// Set the constants C1, C2, C3, C4 of a filter
+	void setConstants(size_t i, double c_1, double c_2, double c_3, double c_4)
+	{
+		double c[6] = { c_1, c_2, c_3, c_4, 0, 0 };
+		if (SECOND_ORDER)
+		{
+			c[4] = constants[4][i];
+			c[5] = constants[5][i];
+		}
+		setConstants(i, c);
+	}
+
+	/// Set the constants C1 to C6 of a second-order filter
+	void setConstants(size_t i, double c_1, double c_2, double c_3, double c_4, double c_5, double c_6)
+	{
+		static_assert(SECOND_ORDER, "C5 and C6 only exist for second-order filters");
+		double c[6] = { c_1, c_2, c_3, c_4, c_5, c_6 };
+		setConstants(i, c);
+	}
+
+	/// Set the natural frequency in Hz and the damping ratio of a second-order low-pass,
+	/// high-pass, band-pass or band-stop filter
+	void setNaturalFreq(size_t i, double natural_freq_hz, double damping_ratio_zeta = 0.70711)
+	{
+		double c[6] = { 0, 0, 0, 0, 0, 0 };
+		FilterTraits<FilterType>::naturalFreq(c, natural_freq_hz, damping_ratio_zeta);
+		setConstants(i, c);
+	}
+
+	/// Get constant k (1 for C1) of a filter
+	double getConstant(size_t i, unsigned int k) const { return constants[k - 1][i]; }
+
+	/// Set the input (target) of a filter
+	void set(size_t i, double input_) { input[i] = input_; }
+
+	/// Get the output of a filter
+	double get(size_t i) const { return out1[i]; }
+
+	/// Inputs of every filter, to fill in place before step()
+	double* inputs() { return input.data(); }
+
+	/// Outputs of every filter
+	const double* outputs() const { return out1.data(); }
+
+	/// Initialize a filter at its current input
+	void init(size_t i)
+	{
+		prepare();
+		in1[i] = in2[i] = input[i];
+		out1[i] = out2[i] = initGain[i] * input[i];
+		initialized[i] = 1;
+	}
+
+	/// Initialize a filter at the given input
+	void init(size_t i, double input_)
+	{
+		set(i, input_);
+		init(i);
+	}
+
+	/// Reset the state of a filter, it initializes itself at its next step
+	void reset(size_t i)
+	{
+		input[i] = in1[i] = in2[i] = out1[i] = out2[i] = 0;
+		initialized[i] = 0;
+		anyUninitialized = true;
+	}
+
+	/// Reset the state of every filter
+	void reset()
+	{
+		for (size_t i = 0; i < size(); i++) {
+			reset(i);
+		}
+	}
+
+	/// Run every filter with its current input and the time delta (s)
+	void step(double dt)
+	{
+		if (dt != discretizedDt)
+		{
+			discretizedDt = dt;
+			for (size_t i = 0; i < size(); i++) {
+				dirty[i] = 1;
+			}
+			anyDirty = true;
+		}
+		prepare();
+
+		if (anyUninitialized)
+		{
+			for (size_t i = 0; i < size(); i++)
+			{
+				if (!initialized[i]) {
+					init(i);
+				}
+			}
+			anyUninitialized = false;
+		}
+
+		//filters without a discretization keep their state, the loop runs them anyway
+		for (size_t h = 0; h < heldFilters.size(); h++) {
+			saveState(heldFilters[h], &heldState[h * 4]);
+		}
+
+		if (SECOND_ORDER)
+			stepSecondOrder();
+		else
+			stepFirstOrder();
+
+		for (size_t h = 0; h < heldFilters.size(); h++) {
+			restoreState(heldFilters[h], &heldState[h * 4]);
+		}
+	}
+
+private:
+	void setConstant(size_t i, unsigned int k, double value)
+	{
+		if (constants[k][i] != value)
+		{
+			constants[k][i] = value;
+			dirty[i] = 1;
+			anyDirty = true;
+		}
+	}
+
+	void setConstants(size_t i, double* c)
+	{
+		FilterTraits<FilterType>::fixConstants(c);
+		for (unsigned int k = 0; k < NUM_CONSTANTS; k++) {
+			setConstant(i, k, c[k]);
+		}
+	}
+
+	//Recompute the coefficients of the filters whose constants changed since the last step
+	void prepare()
+	{
+		if (!anyDirty) {
+			return;
+		}
+
+		for (size_t i = 0; i < size(); i++)
+		{
+			if (!dirty[i]) {
+				continue;
+			}
+
+			double c[6] = { 0, 0, 0, 0, 0, 0 };
+			double k[5] = { 0, 0, 0, 0, 0 };
+			for (unsigned int j = 0; j < NUM_CONSTANTS; j++) {
+				c[j] = constants[j][i];
+			}
+			held[i] = !FilterTraits<FilterType>::discretize(c, discretizedDt, k);
+			for (unsigned int j = 0; j < 5; j++) {
+				coefficients[j][i] = k[j];
+			}
+			initGain[i] = FilterTraits<FilterType>::initialGain(c);
+			dirty[i] = 0;
+		}
+		anyDirty = false;
+
+		heldFilters.clear();
+		for (size_t i = 0; i < size(); i++)
+		{
+			if (held[i]) {
+				heldFilters.push_back(i);
+			}
+		}
+		heldState.resize(heldFilters.size() * 4);
+	}
+
+	void saveState(size_t i, double* state) const
+	{
+		state[0] = in1[i];		state[1] = in2[i];
+		state[2] = out1[i];		state[3] = out2[i];
+	}
+
+	void restoreState(size_t i, const double* state)
+	{
+		in1[i] = state[0];		in2[i] = state[1];
+		out1[i] = state[2];		out2[i] = state[3];
+	}
+
+	void stepFirstOrder()
+	{
+		stepFirstOrder(input.data(), coefficients[0].data(), coefficients[1].data(), coefficients[2].data(),
+			in1.data(), out1.data(), size());
+	}
+
+	void stepSecondOrder()
+	{
+		stepSecondOrder(input.data(), coefficients[0].data(), coefficients[1].data(), coefficients[2].data(),
+			coefficients[3].data(), coefficients[4].data(), in1.data(), in2.data(), out1.data(), out2.data(), size());
+	}
+
+	//The arrays never overlap, __restrict spares the compiler checking it before vectorizing
+	static void stepFirstOrder(const double* __restrict x, const double* __restrict ca, const double* __restrict cb,
+		const double* __restrict cc, double* __restrict x1, double* __restrict y1, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			y1[i] = x[i]*ca[i] + x1[i]*cb[i] + y1[i]*cc[i];
+			x1[i] = x[i];
+		}
+	}
+
+	static void stepSecondOrder(const double* __restrict x, const double* __restrict ca, const double* __restrict cb,
+		const double* __restrict cc, const double* __restrict cd, const double* __restrict ce,
+		double* __restrict x1, double* __restrict x2, double* __restrict y1, double* __restrict y2, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			double y = x[i]*ca[i] + x1[i]*cb[i] + x2[i]*cc[i] - y1[i]*cd[i] - y2[i]*ce[i];
+			x2[i] = x1[i];
+			x1[i] = x[i];
+			y2[i] = y1[i];
+			y1[i] = y;
+		}
+	}
+
+	//state, one entry per filter
+	std::vector<double> input;		//current input (target)
+	std::vector<double> in1;		//previous input
+	std::vector<double> in2;		//input before the previous one (second order)
+	std::vector<double> out1;		//current output
+	std::vector<double> out2;		//previous output (second order)
+	std::vector<char> initialized;
+
+	//constants and their discretization
+	std::vector<double> constants[NUM_CONSTANTS];
+	std::vector<double> coefficients[5];	//ca to ce
+	std::vector<char> held;			//no discretization (zero denominator), the filter holds its state
+	std::vector<size_t> heldFilters;
+	std::vector<double> heldState;	//state of the held filters saved around the loop
+	std::vector<double> initGain;	//output of the filter initialized at a unit input
+	std::vector<char> dirty;		//constants changed since the last discretization
+	double discretizedDt = 0;
+	bool anyDirty = false;
+	bool anyUninitialized = false;
+};
+
+} //namespace otMath
+
+#endif //FilterBank_H
@@ -0,0 +1,299 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       FilterChain.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef FilterChain_H
+#define FilterChain_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "FilterTraits.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** One stage of a FilterChain: the constants, discrete coefficients and state
+of a filter of the given kind, without virtual functions.  The coefficients are
+recomputed only when the constants or dt change.
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename FilterType>
+class FilterStage
+{
+public:
+	typedef FilterTraits<FilterType> Traits;
+
+	FilterStage() { Traits::defaults(c); }
+
+	/// Set constant k (1 for C1)
+	void setConstant(unsigned int k, double value)
+	{
+		c[k - 1] = value;
+		Traits::fixConstants(c);
+		dirty = true;
+	}
+
+	/// Set all the constants C1 to C4 (first order) or C1 to C6 (second order)
+	void setConstants(const double* constants)
+	{
+		for (unsigned int k = 0; k < Traits::NUM_CONSTANTS; k++) {
+			c[k] = constants[k];
+		}
+		Traits::fixConstants(c);
+		dirty = true;
+	}
+
+	/// Set the natural frequency in Hz and the damping ratio of second-order kinds
+	void setNaturalFreq(double natural_freq_hz, double damping_ratio_zeta = 0.70711)
+	{
+		Traits::naturalFreq(c, natural_freq_hz, damping_ratio_zeta);
+		dirty = true;
+	}
+
+	/// Get constant k (1 for C1)
+	double getConstant(unsigned int k) const { return c[k - 1]; }
+
+	/// Get the output of the stage
+	double get() const { return y1; }
+
+	/// Reset the state, the stage initializes itself at its next input
+	void reset()
+	{
+		x1 = x2 = y1 = y2 = 0;
+		initialized = false;
+	}
+
+	/// Initialize the stage at the given input
+	void init(double input)
+	{
+		prepare(discretizedDt);
+		x1 = x2 = input;
+		y1 = y2 = gain * input;
+		initialized = true;
+	}
+
+	/// Run the stage with the given input and time delta (s), returns its output
+	double filter(double input, double dt)
+	{
+		prepare(dt);
+		if (!initialized) {
+			init(input);
+		}
+
+		if (!held)
+		{
+			if (Traits::SECOND_ORDER)
+			{
+				double y = input*k[0] + x1*k[1] + x2*k[2] - y1*k[3] - y2*k[4];
+				x2 = x1;
+				y2 = y1;
+				y1 = y;
+			}
+			else {
+				y1 = input*k[0] + x1*k[1] + y1*k[2];
+			}
+			x1 = input;
+		}
+		return y1;
+	}
+
+private:
+	void prepare(double dt)
+	{
+		if (dirty || dt != discretizedDt)
+		{
+			held = !Traits::discretize(c, dt, k);
+			gain = Traits::initialGain(c);
+			discretizedDt = dt;
+			dirty = false;
+		}
+	}
+
+	double c[6] = { 0, 0, 0, 0, 0, 0 };	//constants C1 to C6
+	double k[5] = { 0, 0, 0, 0, 0 };	//coefficients ca to ce
+	double gain = 1.0;					//output initialized at a unit input
+	double discretizedDt = 0;
+	bool dirty = true;
+	bool held = false;					//zero denominator, the stage keeps its state
+	bool initialized = false;
+
+	double x1 = 0, x2 = 0;				//previous inputs
+	double y1 = 0, y2 = 0;				//current and previous output
+};
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Filters in series, composed at compile time.
+
+Stages are filter classes of Filters.h; each stage feeds its output to the next
+one.  The chain keeps the stages as plain FilterStage members and filter() runs
+them in one inlined sequence, with no virtual call, no copy of inputs and
+outputs between objects and no coefficient work unless dt or a constant
+changed.  Each stage gives bit-for-bit the output of the corresponding filter
+object fed the output of the previous one, when floating-point contraction is
+off (-ffp-contract=off, the /fp:precise default).
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+//pitch rate feedback path
+FilterChain<LeadLag, FirstOrderLag, Washout> pitchRate;
+pitchRate.setConstants<0>(0.2, 1.0, 0.05, 1.0);
+pitchRate.setConstants<1>(20.0);
+pitchRate.setConstants<2>(0.5);
+
+double feedback = pitchRate.filter(q, dt);
+double lagged = pitchRate.get<1>();		//output of the lag
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename... Stages>
+class FilterChain
+{
+public:
+	/// Number of stages in the chain
+	static const size_t NUM_STAGES = sizeof...(Stages);
+	static_assert(NUM_STAGES > 0, "a filter chain needs at least one stage");
+
+	/// Stage N of the chain
+	template <size_t N>
+	using Stage = typename std::tuple_element<N, std::tuple<FilterStage<Stages>...>>::type;
+
+	/// Run every stage with the given input and time delta (s), returns the output of the last one
+	double filter(double input, double dt)
+	{
+		return run<0>(input, dt);
+	}
+
+	/// Get the output of the last stage
+	double get() const { return std::get<NUM_STAGES - 1>(stages).get(); }
+
+	/// Get the output of stage N
+	template <size_t N>
+	double get() const { return std::get<N>(stages).get(); }
+
+	/// Access stage N, e.g. to set constants
+	template <size_t N>
+	Stage<N>& stage() { return std::get<N>(stages); }
+	template <size_t N>
+	const Stage<N>& stage() const { return std::get<N>(stages); }
+
+	/// Set the constant C1 of stage N
+	template <size_t N>
+	void setConstants(double c_1)
+	{
+		stage<N>().setConstant(1, c_1);
+	}
+
+	/// Set the constants C1, C2, C3, C4 of stage N
+	template <size_t N>
+	void setConstants(double c_1, double c_2, double c_3, double c_4)
+	{
+		double c[6] = { c_1, c_2, c_3, c_4, stage<N>().getConstant(5), stage<N>().getConstant(6) };
+		stage<N>().setConstants(c);
+	}
+
+	/// Set the constants C1 to C6 of second-order stage N
+	template <size_t N>
+	void setConstants(double c_1, double c_2, double c_3, double c_4, double c_5, double c_6)
+	{
+		double c[6] = { c_1, c_2, c_3, c_4, c_5, c_6 };
+		stage<N>().setConstants(c);
+	}
+
+	/// Set the natural frequency in Hz and the damping ratio of second-order stage N
+	template <size_t N>
+	void setNaturalFreq(double natural_freq_hz, double damping_ratio_zeta = 0.70711)
+	{
+		stage<N>().setNaturalFreq(natural_freq_hz, damping_ratio_zeta);
+	}
+
+	/// Reset every stage
+	void reset()
+	{
+		resetStages<0>();
+	}
+
+	/// Initialize every stage, the first at the given input and each other at the output of the previous one
+	void init(double input)
+	{
+		initStages<0>(input);
+	}
+
+private:
+	template <size_t N>
+	typename std::enable_if<(N < NUM_STAGES), double>::type run(double input, double dt)
+	{
+		return run<N + 1>(std::get<N>(stages).filter(input, dt), dt);
+	}
+	template <size_t N>
+	typename std::enable_if<(N == NUM_STAGES), double>::type run(double input, double)
+	{
+		return input;
+	}
+
+	template <size_t N>
+	typename std::enable_if<(N < NUM_STAGES)>::type resetStages()
+	{
+		std::get<N>(stages).reset();
+		resetStages<N + 1>();
+	}
+	template <size_t N>
+	typename std::enable_if<(N == NUM_STAGES)>::type resetStages() {}
+
+	template <size_t N>
+	typename std::enable_if<(N < NUM_STAGES)>::type initStages(double input)
+	{
+		std::get<N>(stages).init(input);
+		initStages<N + 1>(std::get<N>(stages).get());
+	}
+	template <size_t N>
+	typename std::enable_if<(N == NUM_STAGES)>::type initStages(double) {}
+
+	std::tuple<FilterStage<Stages>...> stages;
+};
+
+} //namespace otMath
+
+#endif //FilterChain_H
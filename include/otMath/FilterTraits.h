@@ -0,0 +1,205 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       FilterTraits.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef FilterTraits_H
+#define FilterTraits_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <type_traits>
+
+#include "Filters.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Tustin discretization of the filter classes of Filters.h, without the objects.
+
+FilterTraits<FilterType> gives the constants, the discrete coefficients and
+the initial output of a filter kind as plain arrays, computed with exactly the
+arithmetic of the kind's runFilter() and init(), so code running the recurrence
+itself (FilterBank, FilterChain) gives bit-for-bit the results of the objects.
+
+Constants c[0] to c[NUM_CONSTANTS - 1] are C1 to C4 (first order) or C1 to C6
+(second order).  The coefficients k[0] to k[4] are ca to ce of the recurrence
+	first order:  y = ca*x + cb*x1 + cc*y1
+	second order: y = ca*x + cb*x1 + cc*x2 - cd*y1 - ce*y2
+where x1, x2 are the previous inputs and y1, y2 the previous outputs.
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename FilterType>
+struct FilterTraits
+{
+	/// True for second-order filter kinds
+	static const bool SECOND_ORDER = std::is_base_of<SecondOrderFilter, FilterType>::value;
+	/// Number of constants of the kind
+	static const unsigned int NUM_CONSTANTS = SECOND_ORDER ? 6 : 4;
+	/// Number of discrete coefficients of the kind
+	static const unsigned int NUM_COEFFICIENTS = SECOND_ORDER ? 5 : 3;
+
+	/// Default constants of the kind
+	static void defaults(double* c)
+	{
+		FilterType filter;
+		getConstants(&filter, c);
+	}
+
+	/// Apply the fixed constants of second-order kinds, as their runFilter() does
+	static void fixConstants(double* c)
+	{
+		fixConstants(static_cast<const FilterType*>(nullptr), c);
+	}
+
+	/// Constants for a natural frequency in Hz and a damping ratio (second-order kinds)
+	static void naturalFreq(double* c, double natural_freq_hz, double damping_ratio_zeta)
+	{
+		static_assert(SECOND_ORDER, "only second-order filters have a natural frequency");
+		Constants filter;
+		filter.fixedConstants();
+		filter.setNaturalFreq(natural_freq_hz, damping_ratio_zeta);
+		getConstants(&filter, c);
+	}
+
+	/// Discrete coefficients for a time delta (s).  Returns false where the denominator is
+	/// zero, in which case the filter holds its state.
+	static bool discretize(const double* c, double dt, double* k)
+	{
+		return discretize(static_cast<const FilterType*>(nullptr), c, dt, k);
+	}
+
+	/// Output of the filter initialized at a unit input
+	static double initialGain(const double* c)
+	{
+		return initialGain(static_cast<const FilterType*>(nullptr), c);
+	}
+
+private:
+	//Gives access to the protected members of the filter classes
+	struct Constants : public FilterType
+	{
+		using FilterType::fixedConstants;
+		using FilterType::setNaturalFreq;
+	};
+
+	static void getConstants(const FirstOrderFilter* filter, double* c)
+	{
+		c[0] = filter->c1;		c[1] = filter->c2;
+		c[2] = filter->c3;		c[3] = filter->c4;
+	}
+	static void getConstants(const SecondOrderFilter* filter, double* c)
+	{
+		c[0] = filter->c1;		c[1] = filter->c2;
+		c[2] = filter->c3;		c[3] = filter->c4;
+		c[4] = filter->c5;		c[5] = filter->c6;
+	}
+
+	static void fixConstants(const FirstOrderFilter*, double*) {}
+	static void fixConstants(const SecondOrderFilter*, double* c)
+	{
+		Constants filter;
+		filter.c1 = c[0];		filter.c2 = c[1];
+		filter.c3 = c[2];		filter.c4 = c[3];
+		filter.c5 = c[4];		filter.c6 = c[5];
+		filter.fixedConstants();
+		getConstants(&filter, c);
+	}
+
+	//Each kind is picked by overload resolution on its class, derived kinds (FirstOrderLowPass,
+	//Notch, ...) use the closest base
+	static bool discretize(const Integrator*, const double* c, double dt, double* k)
+	{
+		k[0] = k[1] = dt*c[0] / 2.00;
+		k[2] = 1.0;
+		return true;
+	}
+	static bool discretize(const Derivator*, const double* c, double dt, double* k)
+	{
+		k[0] = 2.00*c[0] / dt;
+		k[1] = -k[0];
+		k[2] = -1.0;
+		return true;
+	}
+	static bool discretize(const FirstOrderLag*, const double* c, double dt, double* k)
+	{
+		double den = 2.00 + dt*c[0];
+		if (den == 0) {
+			return false;
+		}
+		k[0] = k[1] = dt*c[0] / den;
+		k[2] = (2.00 - dt*c[0]) / den;
+		return true;
+	}
+	static bool discretize(const Washout*, const double* c, double dt, double* k)
+	{
+		double den = 2.00 + dt*c[0];
+		if (den == 0) {
+			return false;
+		}
+		k[0] = 2.00 / den;
+		k[1] = -k[0];
+		k[2] = (2.00 - dt*c[0]) / den;
+		return true;
+	}
+	static bool discretize(const LeadLag*, const double* c, double dt, double* k)
+	{
+		double den = 2.00*c[2] + dt*c[3];
+		if (den == 0) {
+			return false;
+		}
+		k[0] = (2.00*c[0] + dt*c[1]) / den;
+		k[1] = (dt*c[1] - 2.00*c[0]) / den;
+		k[2] = (2.00*c[2] - dt*c[3]) / den;
+		return true;
+	}
+	static bool discretize(const SecondOrderFilter*, const double* c, double dt, double* k)
+	{
+		double den = 4.0*c[3] + 2.0*c[4]*dt + c[5]*dt*dt;
+		if (den == 0) {
+			return false;
+		}
+		k[0] = (4.0*c[0] + 2.0*c[1]*dt + c[2]*dt*dt) / den;
+		k[1] = (2.0*c[2]*dt*dt - 8.0*c[0]) / den;
+		k[2] = (4.0*c[0] - 2.0*c[1]*dt + c[2]*dt*dt) / den;
+		k[3] = (2.0*c[5]*dt*dt - 8.0*c[3]) / den;
+		k[4] = (4.0*c[3] - 2.0*c[4]*dt + c[5]*dt*dt) / den;
+		return true;
+	}
+
+	static double initialGain(const FirstOrderFilter*, const double*) { return 1.0; }
+	static double initialGain(const LeadLag*, const double* c) { return c[3] != 0.0 ? c[1] / c[3] : 0.0; }
+	static double initialGain(const SecondOrderFilter*, const double* c) { return c[5] != 0.0 ? c[2] / c[5] : 0.0; }
+};
+
+} //namespace otMath
+
+#endif //FilterTraits_H
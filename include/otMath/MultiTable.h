@@ -0,0 +1,143 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       MultiTable.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef MultiTable_H
+#define MultiTable_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+
+#include "Table.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+template <typename T>
+class MultiTable;
+}
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+typedef otMath::MultiTable<double> dMultiTable;
+typedef otMath::MultiTable<float> fMultiTable;
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** 1D table with several dependent values (outputs) per breakpoint.
+
+Each row holds one breakpoint and its outputs, stored interleaved so a lookup
+searches the breakpoints and computes the blend weight (or the spline's local
+coordinate) once, then blends all outputs together in one contiguous sweep.
+Each output gives the same result as a 1D Table of that column with the same
+interpolation method.  Splines are built with the Splines library's SplineSet
+(one spline per output over the shared breakpoints) and packed into
+polynomials whose coefficients are interleaved across outputs as well.
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+//engine deck: thrust, fuel flow and EGT per RPM
+MultiTable<double> deck(3, 3, InterpMethod::INTERP_CUBIC);
+
+deck
+<< 2000.0	<< 1200.0	<< 0.10		<< 450.0
+<< 2500.0	<< 2100.0	<< 0.16		<< 520.0
+<< 3000.0	<< 3000.0	<< 0.25		<< 610.0;
+
+double outputs[3];
+deck.interp(2700.0, outputs);
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename T>
+class MATH_API MultiTable
+{
+public:
+	typedef typename Table<T>::Cursor Cursor;
+	typedef typename Table<T>::Prelookup Prelookup;
+
+	/// Constructor takes the number of rows (breakpoints) and the number of outputs per row
+	MultiTable(unsigned int numberRows, unsigned int numberOutputs, InterpMethod method = InterpMethod::INTERP_LINEAR);
+
+	/// Copy constructor
+	MultiTable(const MultiTable<T>& table);
+	/// Copy assignment operator
+	MultiTable& operator=(const MultiTable<T>& table);
+
+	/// Move constructor, takes over the data of the moved table, which is left an empty one-row, one-output table
+	MultiTable(MultiTable<T>&& table) noexcept;
+	/// Move assignment operator, exchanges the data of both tables
+	MultiTable& operator=(MultiTable<T>&& table) noexcept;
+
+	/// Destructor
+	~MultiTable();
+
+	/// Get every interpolated output at the key, out must hold getNumOutputs() values
+	void interp(T key, T* out, bool extrapolate = false) const;
+	/// Get every interpolated output at the key, starting the search from the cursor
+	void interp(T key, T* out, Cursor& cursor, bool extrapolate = false) const;
+	/// Get every interpolated output at a prelocated key (see Table::Prelookup)
+	void interp(const Prelookup& row, T* out, bool extrapolate = false) const;
+	/// Get one interpolated output at the key
+	T interp(T key, unsigned int output, bool extrapolate = false) const;
+
+	/// Locate a key on the breakpoints, starting the search from the prelookup's interval
+	void prelookup(T key, Prelookup& prelookup) const;
+
+	/// Get table element entry at a given row and column index (column 0 holds the breakpoints,
+	/// columns 1 to getNumOutputs() the outputs, rows start at 1)
+	T get(unsigned int row, unsigned int col) const;
+	T operator()(unsigned int row, unsigned int col) const;
+
+	/// Get the current interpolation method for the table
+	InterpMethod getInterpolationMethod() const;
+	/// Change the current interpolation method for the table
+	void changeInterpolationMethod(InterpMethod method);
+
+	/// Get the number of rows in the table
+	unsigned int getNumRows() const;
+
+	/// Get the number of outputs per row
+	unsigned int getNumOutputs() const;
+
+	/// Get the number of bytes used by the table, including its spline polynomials
+	size_t getMemoryUsage() const;
+
+	/// Stream operators to feed table data, each row is its breakpoint followed by its outputs
+	MultiTable<T>& operator<<(const T n);
+	MultiTable<T>& operator<<(const int n);
+
+private:
+	class Impl;
+	Impl* mImpl = nullptr;
+};
+
+} //namespace otMath
+
+#endif //MultiTable_H
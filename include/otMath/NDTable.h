@@ -0,0 +1,339 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       NDTable.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef NDTable_H
+#define NDTable_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** N-dimensional table with multilinear interpolation.
+
+All values live in one contiguous block, row-major with the last axis varying
+fastest, and each axis has its own breakpoints.  A lookup finds the interval of
+every axis (hunting from a caller-owned Cursor, like Table) and blends the 2^N
+corners of the enclosing cell.  Any axis can be switched to nearest neighbor
+selection, which snaps it to one breakpoint and halves the number of corners.
+
+//////////////////////////
+/// 4-D Table example: ///
+//////////////////////////
+
+//Mach, alpha, beta, altitude
+NDTable<double, 4> cl({ 3, 5, 2, 2 });
+
+cl.setBreakpoints(0, { 0.2, 0.6, 0.9 });
+cl.setBreakpoints(1, { -4.0, 0.0, 4.0, 8.0, 12.0 });
+cl.setBreakpoints(2, { 0.0, 10.0 });
+cl.setBreakpoints(3, { 0.0, 10000.0 });
+
+//values in order, last axis (altitude) varying fastest
+cl << 0.01 << 0.01 << 0.02 << 0.02 << ...;
+
+std::array<double, 4> keys = { 0.5, 2.0, 1.0, 3000.0 };
+double value = cl.interp(keys);
+
+//per-entity search hint for successive lookups
+NDTable<double, 4>::Cursor cursor;
+value = cl.interp(keys, cursor);
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename T, unsigned int N>
+class NDTable
+{
+public:
+	static_assert(N >= 1 && N <= 8, "NDTable supports 1 to 8 dimensions");
+
+	/// Search hint owned by the caller of interp(), the interval of the last lookup on each axis
+	struct Cursor
+	{
+		std::array<unsigned int, N> interval;
+
+		Cursor() { reset(); }
+
+		/// Forget the cached intervals, the next lookup does a full search
+		void reset() { interval.fill(~0u); }
+	};
+
+	/// Constructor takes the number of breakpoints along each axis
+	NDTable(const std::array<unsigned int, N>& axisSizes)
+	{
+		size_t count = 1;
+		for (unsigned int d = N; d-- > 0;)
+		{
+			unsigned int n = axisSizes[d] < 1 ? 1 : axisSizes[d];
+			breakpoints[d].assign(n, (T)0);
+			strides[d] = count;
+			count *= n;
+			nearest[d] = false;
+		}
+		values.assign(count, (T)0);
+	}
+
+	/// Set the breakpoints of an axis (must be increasing, one per breakpoint of the axis)
+	void setBreakpoints(unsigned int axis, const std::vector<T>& axisBreakpoints)
+	{
+		if (axis >= N || axisBreakpoints.size() != breakpoints[axis].size())
+		{
+			//TODO: WARNING message for breakpoints not matching the axis size
+			return;
+		}
+		breakpoints[axis] = axisBreakpoints;
+	}
+
+	/// Get the breakpoints of an axis
+	const std::vector<T>& getBreakpoints(unsigned int axis) const { return breakpoints[axis]; }
+
+	/// Get the number of breakpoints along an axis
+	unsigned int getNumBreakpoints(unsigned int axis) const { return (unsigned int)breakpoints[axis].size(); }
+
+	/// Select nearest neighbor (instead of linear) interpolation along an axis
+	void setNearest(unsigned int axis, bool nearestNeighbor)
+	{
+		if (axis < N) {
+			nearest[axis] = nearestNeighbor;
+		}
+	}
+
+	/// Is nearest neighbor interpolation selected along an axis?
+	bool isNearest(unsigned int axis) const { return nearest[axis]; }
+
+	/// Set all values, row-major with the last axis varying fastest
+	void setValues(const std::vector<T>& tableValues)
+	{
+		if (tableValues.size() != values.size())
+		{
+			//TODO: WARNING message for values not matching the table size
+			return;
+		}
+		values = tableValues;
+		insertCtr = values.size();
+	}
+
+	/// Get the total number of values in the table
+	size_t getNumValues() const { return values.size(); }
+
+	/// Get the value at the given breakpoint indices
+	T get(const std::array<unsigned int, N>& index) const
+	{
+		size_t offset = 0;
+		for (unsigned int d = 0; d < N; d++)
+		{
+			if (index[d] >= breakpoints[d].size())
+				return (T)0;
+			offset += index[d] * strides[d];
+		}
+		return values[offset];
+	}
+
+	/// Set the value at the given breakpoint indices
+	void set(const std::array<unsigned int, N>& index, T value)
+	{
+		size_t offset = 0;
+		for (unsigned int d = 0; d < N; d++)
+		{
+			if (index[d] >= breakpoints[d].size())
+			{
+				//TODO: ERROR message informing user of attempting to access invalid table cell
+				return;
+			}
+			offset += index[d] * strides[d];
+		}
+		values[offset] = value;
+	}
+
+	/// Stream operator to feed the table values in order, last axis varying fastest
+	NDTable& operator<<(const T value)
+	{
+		if (insertCtr < values.size()) {
+			values[insertCtr++] = value;
+		}
+		else {
+			//TODO: ERROR message informing user of attempting to access invalid table cell
+		}
+		return *this;
+	}
+
+	/// Get interpolated value
+	T interp(const std::array<T, N>& keys, bool extrapolate = false) const
+	{
+		Cursor cursor;
+		return interp(keys, cursor, extrapolate);
+	}
+
+	/// Get interpolated value, starting the search of each axis from the cursor
+	T interp(const std::array<T, N>& keys, Cursor& cursor, bool extrapolate = false) const
+	{
+		//Cell corner offset and the axes still to blend, with their blend factors
+		size_t base = 0;
+		unsigned int numActive = 0;
+		size_t activeStride[N];
+		T activeFac[N];
+
+		for (unsigned int d = 0; d < N; d++)
+		{
+			const std::vector<T>& bp = breakpoints[d];
+			unsigned int n = (unsigned int)bp.size();
+			T key = keys[d];
+
+			if (n < 2)
+				continue;
+
+			//cannot extrapolate with Nearest Neighbor selection
+			bool axisExtrapolate = extrapolate && !nearest[d];
+
+			if (!axisExtrapolate)
+			{
+				if (key <= bp[0])
+				{
+					cursor.interval[d] = 0;
+					continue;
+				}
+				else if (key >= bp[n - 1])
+				{
+					cursor.interval[d] = n - 2;
+					base += (n - 1) * strides[d];
+					continue;
+				}
+			}
+
+			unsigned int i = findInterval(bp.data(), n, key, cursor.interval[d]);
+
+			T rng = bp[i + 1] - bp[i];
+			T fac = (T)1.0;
+			if (rng != 0.0)
+			{
+				fac = (key - bp[i]) / rng;
+				if (!axisExtrapolate) {
+					fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+				}
+			}
+
+			if (nearest[d])
+			{
+				//snap to the nearest breakpoint, nothing to blend on this axis
+				base += (fac < 0.5 ? i : i + 1) * strides[d];
+				continue;
+			}
+
+			base += i * strides[d];
+			activeStride[numActive] = strides[d];
+			activeFac[numActive] = fac;
+			numActive++;
+		}
+
+		//Gather the corners of the cell, the first active axis is the most significant bit
+		const size_t numCorners = (size_t)1 << numActive;
+		T corner[(size_t)1 << N];
+		for (size_t c = 0; c < numCorners; c++)
+		{
+			size_t offset = base;
+			for (unsigned int a = 0; a < numActive; a++)
+			{
+				if ((c >> (numActive - 1 - a)) & 1) {
+					offset += activeStride[a];
+				}
+			}
+			corner[c] = values[offset];
+		}
+
+		//Blend the corners pairwise, one axis at a time starting from the last
+		for (unsigned int a = numActive; a-- > 0;)
+		{
+			size_t half = (size_t)1 << a;
+			T fac = activeFac[a];
+			for (size_t c = 0; c < half; c++) {
+				corner[c] = fac*(corner[2 * c + 1] - corner[2 * c]) + corner[2 * c];
+			}
+		}
+
+		return corner[0];
+	}
+
+private:
+	/// Find the interval [bp[i], bp[i+1]] containing the key, hunting a few intervals from a valid
+	/// hint, otherwise bisecting
+	static unsigned int findInterval(const T* bp, unsigned int n, T key, unsigned int& hint)
+	{
+		const unsigned int huntSteps = 8;
+		unsigned int i = hint;
+		if (i > n - 2)
+		{
+			i = (unsigned int)(std::upper_bound(bp + 1, bp + n - 1, key) - bp) - 1;
+		}
+		else
+		{
+			unsigned int steps = 0;
+			while (i > 0 && bp[i] > key)
+			{
+				if (++steps > huntSteps) {
+					i = (unsigned int)(std::upper_bound(bp + 1, bp + i, key) - bp) - 1;
+					break;
+				}
+				i--;
+			}
+			while (i < n - 2 && bp[i + 1] < key)
+			{
+				if (++steps > huntSteps) {
+					i = (unsigned int)(std::lower_bound(bp + i + 1, bp + n - 1, key) - bp) - 1;
+					break;
+				}
+				i++;
+			}
+		}
+		hint = i;
+		return i;
+	}
+
+	/// Breakpoints of each axis
+	std::array<std::vector<T>, N> breakpoints;
+	/// Distance in the value block between successive breakpoints of each axis
+	std::array<size_t, N> strides;
+	/// Nearest neighbor selection per axis
+	std::array<bool, N> nearest;
+	/// Table values, row-major with the last axis varying fastest
+	std::vector<T> values;
+	/// Next value filled by the stream operator
+	size_t insertCtr = 0;
+};
+
+} //namespace otMath
+
+#endif //NDTable_H
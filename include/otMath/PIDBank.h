@@ -0,0 +1,276 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       PIDBank.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef PIDBank_H
+#define PIDBank_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "PID.h"
+#include "Table.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+enum class PID_GAIN
+{
+	KP = 0,
+	KI,
+	KD,
+};
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Bank of many PID controllers of the same integrator and PID type, solved together.
+
+The integrator and PID types are template parameters, so step() has no switch on
+them: it solves every controller in one loop over arrays of gains and states
+(structure of arrays), which the compiler vectorizes.  Each controller computes
+the same expressions as a PID object with the same types, gains and errors, so
+its output is bit-for-bit that of the PID when floating-point contraction is off
+(-ffp-contract=off, the /fp:precise default).  With contraction on (e.g. GCC with
+-march=native on an FMA target) the compiler may fuse the vectorized loop and the
+scalar PID differently, and outputs can differ in the last bits.
+
+Gains are set per controller, or scheduled for many controllers at once from a
+Table evaluated in batch at one key per controller (e.g. dynamic pressure, or
+altitude and Mach), writing the gains in place.
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+//altitude hold of every AI aircraft, gains scheduled on airspeed
+PIDBank<INTEGRATOR_TYPE::TRAPEZOIDAL> altitudeHold(numAircraft);
+
+//every frame
+altitudeHold.scheduleGain(PID_GAIN::KP, kpTable, airspeeds);
+altitudeHold.scheduleGain(PID_GAIN::KI, kiTable, airspeeds);
+for (size_t i = 0; i < numAircraft; i++) {
+	altitudeHold.setError(i, targetAltitude[i] - altitude[i]);
+}
+altitudeHold.step(dt);
+double pitchCommand = altitudeHold.get(0);
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <INTEGRATOR_TYPE Integrator = INTEGRATOR_TYPE::ADAMS_BASHFORTH_2, PID_TYPE Type = PID_TYPE::STANDARD>
+class PIDBank
+{
+public:
+	/// Constructor takes the number of controllers in the bank
+	explicit PIDBank(size_t count = 0)
+	{
+		for (size_t i = 0; i < count; i++) {
+			add();
+		}
+	}
+
+	/// Add a controller with the default gains of PID (Kp = 1), returns its index
+	size_t add()
+	{
+		Kp.push_back(1.0);
+		Ki.push_back(0.0);
+		Kd.push_back(0.0);
+		error.push_back(0.0);
+		errorPrev.push_back(0.0);
+		errorPrev2.push_back(0.0);
+		integration.push_back(0.0);
+		output.push_back(0.0);
+		integrating.push_back(INTEGRATING);
+		return Kp.size() - 1;
+	}
+
+	/// Number of controllers in the bank
+	size_t size() const { return Kp.size(); }
+
+	///Set the Constants for the Proportional, Integral, and Derivative terms of a controller
+	void setConstants(size_t i, double kp, double ki = 0, double kd = 0)
+	{
+		Kp[i] = kp;		Ki[i] = ki;		Kd[i] = kd;
+	}
+
+	/// Schedule a gain of the controllers first to first + count - 1 from a 1D table, at one key per
+	/// controller.  The keys are indexed by controller like the gains: keys[first] is the key of controller first
+	void scheduleGain(PID_GAIN gain, const Table<double>& table, const double* keys, size_t first, size_t count, bool extrapolate = false)
+	{
+		table.interp(keys + first, gains(gain) + first, count, extrapolate);
+	}
+
+	/// Schedule a gain of every controller from a 1D table, at one key per controller
+	void scheduleGain(PID_GAIN gain, const Table<double>& table, const double* keys, bool extrapolate = false)
+	{
+		scheduleGain(gain, table, keys, 0, size(), extrapolate);
+	}
+
+	/// Schedule a gain of the controllers first to first + count - 1 from a 2D table, at one pair of keys
+	/// per controller.  The keys are indexed by controller like the gains, as for the 1D table
+	void scheduleGain(PID_GAIN gain, const Table<double>& table, const double* rowKeys, const double* colKeys, size_t first, size_t count, bool extrapolate = false)
+	{
+		table.interp(rowKeys + first, colKeys + first, gains(gain) + first, count, extrapolate);
+	}
+
+	/// Schedule a gain of every controller from a 2D table, at one pair of keys per controller
+	void scheduleGain(PID_GAIN gain, const Table<double>& table, const double* rowKeys, const double* colKeys, bool extrapolate = false)
+	{
+		scheduleGain(gain, table, rowKeys, colKeys, 0, size(), extrapolate);
+	}
+
+	/// Set the error of a controller, and whether it stops integrating (wind-up prevention)
+	void setError(size_t i, double error_, bool stop_ = false)
+	{
+		error[i] = error_;
+		integrating[i] = stop_ ? 0 : INTEGRATING;
+	}
+
+	/// Errors of every controller, to fill in place before step().  Unlike setError(), filling them
+	/// leaves the wind-up stop flags as they are: a controller set to stop keeps stopping until
+	/// setError() or setStop() clears it
+	double* errors() { return error.data(); }
+
+	/// Set whether a controller stops integrating (wind-up prevention), keeping its error
+	void setStop(size_t i, bool stop_)
+	{
+		integrating[i] = stop_ ? 0 : INTEGRATING;
+	}
+
+	/// Gains of every controller, to set in place
+	double* gains(PID_GAIN gain)
+	{
+		return gain == PID_GAIN::KP ? Kp.data() : gain == PID_GAIN::KI ? Ki.data() : Kd.data();
+	}
+
+	///Get the output from a controller
+	double get(size_t i) const { return output[i]; }
+
+	/// Outputs of every controller
+	const double* outputs() const { return output.data(); }
+
+	///Reset a controller fully
+	void reset(size_t i)
+	{
+		integrating[i] = INTEGRATING;
+		integration[i] = 0.0;
+		error[i] = errorPrev[i] = errorPrev2[i] = 0.0;
+		output[i] = 0.0;
+	}
+
+	///Reset every controller fully
+	void reset()
+	{
+		std::fill(integrating.begin(), integrating.end(), INTEGRATING);
+		std::fill(integration.begin(), integration.end(), 0.0);
+		std::fill(error.begin(), error.end(), 0.0);
+		std::fill(errorPrev.begin(), errorPrev.end(), 0.0);
+		std::fill(errorPrev2.begin(), errorPrev2.end(), 0.0);
+		std::fill(output.begin(), output.end(), 0.0);
+	}
+
+	/// Run every controller with its current error and the time delta (s)
+	void step(double dt)
+	{
+		solve(Kp.data(), Ki.data(), Kd.data(), integrating.data(), error.data(), errorPrev.data(), errorPrev2.data(),
+			integration.data(), output.data(), size(), dt);
+	}
+
+private:
+	//Same arithmetic as PID::solve, with the types resolved at compile time.  The arrays never
+	//overlap, __restrict spares the compiler checking it before vectorizing.
+	static void solve(const double* __restrict kp, const double* __restrict ki, const double* __restrict kd,
+		const uint64_t* __restrict mask, const double* __restrict e, double* __restrict e1, double* __restrict e2,
+		double* __restrict integ, double* __restrict out, size_t n, double dt)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			double derivative = (e[i] - e1[i]) / dt;
+
+			double integration_delta = 0;
+			switch (Integrator) {
+			case INTEGRATOR_TYPE::RECTANGULAR:
+				integration_delta = ki[i] * dt * e[i];
+				break;
+			case INTEGRATOR_TYPE::TRAPEZOIDAL:
+				integration_delta = (ki[i] / 2.0) * dt * (e[i] + e1[i]);
+				break;
+			case INTEGRATOR_TYPE::ADAMS_BASHFORTH_2:
+				integration_delta = ki[i] * dt * (1.5*e[i] - 0.5*e1[i]);
+				break;
+			case INTEGRATOR_TYPE::ADAMS_BASHFORTH_3:
+				integration_delta = (ki[i] / 12.0) * dt * (23.0*e[i] - 16.0*e1[i] + 5.0*e2[i]);
+				break;
+			}
+
+			// Reset the integration to 0 if "stop" wind-up condition is true.  Masking the bits
+			// gives exactly +0.0 without a branch, which would keep the loop from vectorizing.
+			double integration = integ[i] + integration_delta;
+			uint64_t bits;
+			std::memcpy(&bits, &integration, sizeof(bits));
+			bits &= mask[i];
+			std::memcpy(&integration, &bits, sizeof(bits));
+			integ[i] = integration;
+
+			if (Type == PID_TYPE::IDEAL) {
+				out[i] = kp[i]*e[i] + integration + kd[i]*derivative;
+			}
+			else {
+				out[i] = kp[i]*(e[i] + integration + kd[i]*derivative);
+			}
+
+			e2[i] = e1[i];
+			e1[i] = e[i];
+		}
+	}
+
+	//gains
+	std::vector<double> Kp, Ki, Kd;
+
+	//state, one entry per controller
+	std::vector<double> error;			//current error
+	std::vector<double> errorPrev;		//previous error
+	std::vector<double> errorPrev2;		//error before the last error
+	std::vector<double> integration;	//total integration value
+	std::vector<double> output;			//current result
+	std::vector<uint64_t> integrating;	//INTEGRATING, or 0 to stop integrating and reset the integrator to 0
+
+	static const uint64_t INTEGRATING = ~(uint64_t)0;
+};
+
+template <INTEGRATOR_TYPE Integrator, PID_TYPE Type>
+const uint64_t PIDBank<Integrator, Type>::INTEGRATING;
+
+} //namespace otMath
+
+#endif //PIDBank_H
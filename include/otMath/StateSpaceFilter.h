@@ -0,0 +1,163 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       StateSpaceFilter.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef StateSpaceFilter_H
+#define StateSpaceFilter_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+template <typename T>
+class StateSpaceFilter;
+}
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#if !defined(_WIN32)
+#define MATH_API
+#elif defined(MATH_EXPORTS)
+#define MATH_API __declspec(dllexport)
+#else
+#define MATH_API __declspec(dllimport)
+#endif
+
+typedef otMath::StateSpaceFilter<double> dStateSpaceFilter;
+typedef otMath::StateSpaceFilter<float> fStateSpaceFilter;
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Discrete state-space filter of any order, designed from a continuous system.
+
+The continuous system is given as a transfer function (numerator and denominator
+coefficients in s, from the highest power down), as state-space matrices A, B, C, D,
+or as a series of transfer functions appended one after the other (e.g. the second
+order sections of a Butterworth cascade or of structural-mode notches, which keeps
+a high-order design well conditioned).  discretize() then computes the discrete
+system once with the Tustin (bilinear) transform, optionally prewarped so the
+discrete response matches the continuous one exactly at a given frequency.
+
+The same filter runs on several channels at once (e.g. the three axes of a sensor).
+The state is stored channel-innermost, so each step of the recurrence is a loop
+over channels that the compiler vectorizes.  filter() processes one sample per
+channel, or a whole buffer of samples (interleaved by channel) per call.
+
+Designs are computed in double precision, float filters only store and run in float.
+A design that cannot be discretized leaves the previous discrete system in place.
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+//3 axis accelerometer model, 4th order Butterworth at 60 Hz sampled at 1 kHz
+StateSpaceFilter<double> accel(3);
+double wc = 2.0 * PI * 60.0;
+accel.setTransferFunction({ wc*wc }, { 1.0, 0.76537*wc, wc*wc });
+accel.appendTransferFunction({ wc*wc }, { 1.0, 1.84776*wc, wc*wc });
+accel.discretize(0.001, 60.0);
+
+double in[3], out[3];
+accel.filter(in, out);
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename T>
+class MATH_API StateSpaceFilter
+{
+public:
+	/// Constructor takes the number of channels filtered in parallel, the filter passes its
+	/// input through until it is designed and discretized
+	explicit StateSpaceFilter(unsigned int numberChannels = 1);
+
+	/// Copy constructor
+	StateSpaceFilter(const StateSpaceFilter<T>& filter);
+	/// Copy assignment operator
+	StateSpaceFilter& operator=(const StateSpaceFilter<T>& filter);
+
+	/// Move constructor, takes over the data of the moved filter, which is left a new one-channel filter
+	StateSpaceFilter(StateSpaceFilter<T>&& filter) noexcept;
+	/// Move assignment operator, exchanges the data of both filters
+	StateSpaceFilter& operator=(StateSpaceFilter<T>&& filter) noexcept;
+
+	/// Destructor
+	~StateSpaceFilter();
+
+	/// Design from a continuous transfer function num(s) / den(s), coefficients from the highest
+	/// power of s down.  Returns false if it is not proper (numerator of higher degree).
+	bool setTransferFunction(const std::vector<double>& numerator, const std::vector<double>& denominator);
+
+	/// Append a continuous transfer function in series after the current design
+	bool appendTransferFunction(const std::vector<double>& numerator, const std::vector<double>& denominator);
+
+	/// Design from continuous state-space matrices of the given order: A (order x order, row major),
+	/// B (order x 1), C (1 x order) and D
+	bool setStateSpace(unsigned int order, const double* A, const double* B, const double* C, double D);
+
+	/// Discretize the design with the Tustin transform for the time delta (s).  With a prewarp
+	/// frequency (Hz, below the Nyquist frequency) the discrete response matches the continuous
+	/// one at that frequency.  Returns false if the design has no Tustin equivalent for dt.
+	bool discretize(double dt, double prewarpHz = 0.0);
+
+	/// Filter one sample per channel, in and out hold getNumChannels() values.  out may be in
+	/// (filtering in place), otherwise the arrays must not overlap
+	void filter(const T* in, T* out);
+
+	/// Filter numSamples samples per channel, interleaved by channel (in[sample * channels + channel]).
+	/// out may be in, otherwise the arrays must not overlap
+	void filter(const T* in, T* out, size_t numSamples);
+
+	/// Filter one sample of a single channel filter
+	T filter(T in);
+
+	/// Reset the state to zero
+	void reset();
+
+	/// Initialize every channel at the steady state of a constant input (zero state for designs
+	/// without one, e.g. integrators)
+	void init(const T* in);
+
+	/// Get the order (number of states) of the design
+	unsigned int getOrder() const;
+
+	/// Get the number of channels
+	unsigned int getNumChannels() const;
+
+	/// Get the discrete system: Ad (order x order, row major), Bd, Cd and Dd
+	void getDiscrete(std::vector<double>& Ad, std::vector<double>& Bd, std::vector<double>& Cd, double& Dd) const;
+
+private:
+	class Impl;
+	Impl* mImpl = nullptr;
+};
+
+} //namespace otMath
+
+#endif //StateSpaceFilter_H
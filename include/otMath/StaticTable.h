@@ -0,0 +1,256 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       StaticTable.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef StaticTable_H
+#define StaticTable_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "Table.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+/// Axes with at most this many breakpoints are searched by counting, without branches
+static const size_t STATIC_TABLE_COUNT_SEARCH_MAX = 32;
+
+/// Interval [bp[i], bp[i+1]] of a compile-time sized axis containing the key (clamped to the
+/// first/last interval), the same interval a Table finds by bisection
+template <typename T, size_t N>
+inline unsigned int staticTableInterval(const std::array<T, N>& bp, T key)
+{
+	if (N <= STATIC_TABLE_COUNT_SEARCH_MAX)
+	{
+		//unrolled by the compiler, N is known
+		unsigned int i = 0;
+		for (size_t k = 1; k + 1 < N; k++) {
+			i += bp[k] <= key ? 1u : 0u;
+		}
+		return i;
+	}
+	return (unsigned int)(std::upper_bound(bp.begin() + 1, bp.end() - 1, key) - bp.begin()) - 1;
+}
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Fixed size 1D and 2D tables known at compile time.
+
+The breakpoints and values are std::arrays given to a constexpr constructor, so a
+StaticTable can be a constexpr (or static const) object with no heap allocation,
+and its size and interpolation method are template parameters, so interp() has no
+method switch and inlines into the caller.  Small axes are searched without
+branches.  Lookups give the same results as a Table of the same data and method,
+and the interface matches Table (interp(), get(), getNumRows(), ...) so the two can
+be swapped.  Only linear and nearest neighbor interpolation are supported, use a
+Table for splines.
+
+//////////////////////////
+/// 1-D Table example: ///
+//////////////////////////
+
+static constexpr StaticTable<double, 3> thrustCurve(
+	{ { 0.0, 0.5, 1.0 } },		//throttle
+	{ { 0.0, 0.6, 1.0 } });		//thrust fraction
+
+double value = thrustCurve.interp(0.25); //returns 0.3
+
+//////////////////////////
+/// 2-D Table example: ///
+//////////////////////////
+
+static constexpr StaticTable2D<double, 2, 2> cl(
+	{ { 0.0, 1.0 } },			//row breakpoints
+	{ { 0.0, 1.0 } },			//column breakpoints
+	{ { 4.0, 5.0,				//values, row-major
+		5.0, 6.0 } });
+
+double value = cl.interp(0.5, 0.5); //returns 5.0
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename T, size_t N, InterpMethod Method = InterpMethod::INTERP_LINEAR>
+class StaticTable
+{
+public:
+	static_assert(N >= 2, "StaticTable needs at least 2 breakpoints");
+	static_assert(Method == InterpMethod::INTERP_LINEAR || Method == InterpMethod::INTERP_NEAREST,
+		"StaticTable supports linear and nearest neighbor interpolation");
+
+	/// Constructor takes the breakpoints (increasing) and the value at each breakpoint
+	constexpr StaticTable(const std::array<T, N>& tableBreakpoints, const std::array<T, N>& tableValues)
+		: breakpoints(tableBreakpoints), values(tableValues) {}
+
+	/// Get interpolated value
+	T interp(T key, bool extrapolate = false) const
+	{
+		//cannot extrapolate with Nearest Neighbor selection
+		if (Method == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+		if (!extrapolate)
+		{
+			if (key <= breakpoints[0])
+				return values[0];
+			if (key >= breakpoints[N - 1])
+				return values[N - 1];
+		}
+
+		unsigned int i = staticTableInterval(breakpoints, key);
+
+		T fac = (T)1.0;
+		T rng = breakpoints[i + 1] - breakpoints[i];
+		if (rng != 0.0)
+		{
+			fac = (key - breakpoints[i]) / rng;
+			if (!extrapolate) {
+				fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+			}
+		}
+
+		if (Method == InterpMethod::INTERP_NEAREST)
+			return fac < 0.5 ? values[i] : values[i + 1];
+
+		return fac*(values[i + 1] - values[i]) + values[i];
+	}
+
+	/// Get table element entry at a given row and column index, in the layout of Table
+	/// (column 0 holds the breakpoints, column 1 the values, rows start at 1)
+	T get(unsigned int row, unsigned int col) const
+	{
+		if (row < 1 || row > N || col > 1)
+			return (T)0;
+		return col == 0 ? breakpoints[row - 1] : values[row - 1];
+	}
+	T operator()(unsigned int row, unsigned int col) const { return get(row, col); }
+
+	/// Get the interpolation method of the table
+	constexpr InterpMethod getInterpolationMethod() const { return Method; }
+
+	/// Get the number of rows in the table
+	constexpr unsigned int getNumRows() const { return (unsigned int)N; }
+
+	/// Get the number of columns in the table
+	constexpr unsigned int getNumColumns() const { return 1; }
+
+	/// Get the breakpoints
+	constexpr const std::array<T, N>& getBreakpoints() const { return breakpoints; }
+
+	/// Get the values
+	constexpr const std::array<T, N>& getValues() const { return values; }
+
+private:
+	std::array<T, N> breakpoints;
+	std::array<T, N> values;
+};
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename T, size_t R, size_t C, InterpMethod Method = InterpMethod::INTERP_LINEAR>
+class StaticTable2D
+{
+public:
+	static_assert(R >= 2 && C >= 2, "StaticTable2D needs at least 2 breakpoints on each axis");
+	static_assert(Method == InterpMethod::INTERP_LINEAR || Method == InterpMethod::INTERP_NEAREST,
+		"StaticTable2D supports linear and nearest neighbor interpolation");
+
+	/// Constructor takes the row and column breakpoints (increasing) and the values, row-major
+	constexpr StaticTable2D(const std::array<T, R>& tableRowBreakpoints, const std::array<T, C>& tableColumnBreakpoints,
+		const std::array<T, R * C>& tableValues)
+		: rowBreakpoints(tableRowBreakpoints), columnBreakpoints(tableColumnBreakpoints), values(tableValues) {}
+
+	/// Get interpolated value
+	T interp(T rowKey, T colKey, bool extrapolate = false) const
+	{
+		//cannot extrapolate with Nearest Neighbor selection
+		if (Method == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+
+		unsigned int r = staticTableInterval(rowBreakpoints, rowKey);
+		unsigned int c = staticTableInterval(columnBreakpoints, colKey);
+
+		T rFac = (rowKey - rowBreakpoints[r]) / (rowBreakpoints[r + 1] - rowBreakpoints[r]);
+		T cFac = (colKey - columnBreakpoints[c]) / (columnBreakpoints[c + 1] - columnBreakpoints[c]);
+
+		if (!extrapolate)
+		{
+			rFac = rFac > 1.0 ? (T)1.0 : rFac < 0.0 ? (T)0.0 : rFac;
+			cFac = cFac > 1.0 ? (T)1.0 : cFac < 0.0 ? (T)0.0 : cFac;
+		}
+
+		size_t lowerRow = (size_t)r * C + c;
+		size_t upperRow = lowerRow + C;
+
+		if (Method == InterpMethod::INTERP_NEAREST)
+			return values[(rFac < 0.5 ? lowerRow : upperRow) + (cFac < 0.5 ? 0 : 1)];
+
+		T lowerColVal = rFac*(values[upperRow] - values[lowerRow]) + values[lowerRow];
+		T upperColVal = rFac*(values[upperRow + 1] - values[lowerRow + 1]) + values[lowerRow + 1];
+		return lowerColVal + cFac*(upperColVal - lowerColVal);
+	}
+
+	/// Get table element entry at a given row and column index, in the layout of Table
+	/// (row 0 holds the column breakpoints, column 0 the row breakpoints)
+	T get(unsigned int row, unsigned int col) const
+	{
+		if (row > R || col > C || (row == 0 && col == 0))
+			return (T)0;
+		if (row == 0)
+			return columnBreakpoints[col - 1];
+		if (col == 0)
+			return rowBreakpoints[row - 1];
+		return values[(size_t)(row - 1) * C + (col - 1)];
+	}
+	T operator()(unsigned int row, unsigned int col) const { return get(row, col); }
+
+	/// Get the interpolation method of the table
+	constexpr InterpMethod getInterpolationMethod() const { return Method; }
+
+	/// Get the number of rows in the table
+	constexpr unsigned int getNumRows() const { return (unsigned int)R; }
+
+	/// Get the number of columns in the table
+	constexpr unsigned int getNumColumns() const { return (unsigned int)C; }
+
+private:
+	std::array<T, R> rowBreakpoints;
+	std::array<T, C> columnBreakpoints;
+	std::array<T, R * C> values;
+};
+
+} //namespace otMath
+
+#endif //StaticTable_H
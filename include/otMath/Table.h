@@ -17,6 +17,8 @@ SENTRY
 INCLUDES
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
+#include <cstddef>
+#include <string>
 #include <vector>
 
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -32,7 +34,9 @@ class Table;
 DEFINITIONS
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
-#ifdef MATH_EXPORTS
+#if !defined(_WIN32)
+#define MATH_API
+#elif defined(MATH_EXPORTS)
 #define MATH_API __declspec(dllexport)
 #else
 #define MATH_API __declspec(dllimport)
@@ -55,6 +59,13 @@ enum class InterpMethod
 	INTERP_HERMITE, //1D only
 };
 
+enum class TableAxis
+{
+	AXIS_ROW = 0, //row breakpoints, the 1st key
+	AXIS_COLUMN, //column breakpoints, the 2nd key
+	AXIS_TABLE, //3rd dimension breakpoints, the 3rd key
+};
+
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 CLASS DOCUMENTATION
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
@@ -133,6 +144,60 @@ Table<double> new3DTable = new Table<double>(newTablesPointers, newTableBreakPoi
 
 double value = new3DTable->interp(0.5, 0.5, 0.5); //returns 6.5
 
+//////////////////////////
+/// Concurrent lookups ///
+//////////////////////////
+
+//interp() does not modify the table, so one table can be shared between threads.
+//Each caller can keep its own Cursor so repeated lookups near the last one stay fast.
+//To replace a table while other threads are interpolating it, see TableHandle.
+
+Table<double>::Cursor cursor;
+double value = new2DTable->interp(0.5, 0.5, cursor);
+
+//////////////////////////
+///  Batched lookups:  ///
+//////////////////////////
+
+//Evaluate many keys in one call, e.g. one per entity each frame
+
+std::vector<double> keys = { 0.1, 0.2, 0.7 };
+std::vector<double> values(keys.size());
+new1DTable->interp(keys.data(), values.data(), keys.size());
+
+//////////////////////////
+///    Prelookups:     ///
+//////////////////////////
+
+//Tables sharing breakpoints (e.g. every aero coefficient on Mach and alpha) locate the keys
+//once per frame and evaluate from the prelookups, see also TableGroup
+
+Table<double>::Prelookup mach, alpha;
+cl.prelookup(machKey, TableAxis::AXIS_ROW, mach);
+cl.prelookup(alphaKey, TableAxis::AXIS_COLUMN, alpha);
+double clValue = cl.interp(mach, alpha);
+double cdValue = cd.interp(mach, alpha);
+
+//////////////////////////
+///  Compiled tables:  ///
+//////////////////////////
+
+//Trade the spline evaluation for a dense linear table in the hot loop, keeping the
+//spline table to validate against
+double maxDeviation;
+Table<double> fastCl = clQuintic.compile(1.0e-6, &maxDeviation);
+double value = fastCl.interp(mach, alpha);
+
+//////////////////////////
+///    Table files:    ///
+//////////////////////////
+
+//Convert a text table once, then map the binary file on later runs
+Table<double> aeroTable(2, 2);
+if (!aeroTable.readFile("aero.ottb") && aeroTable.readCSV("aero.csv", InterpMethod::INTERP_CUBIC)) {
+	aeroTable.writeFile("aero.ottb");
+}
+
 @author Cory Parks
 */
 
@@ -161,9 +226,50 @@ public:
 	/// Copy assignment constructor
 	const Table &operator=(const Table<T> &table);
 
+	/// Move constructor, takes over the data of the moved table, which is left an empty one-row table
+	Table(Table<T>&& table) noexcept;
+
+	/// Move assignment operator, exchanges the data of both tables
+	Table &operator=(Table<T>&& table) noexcept;
+
 	/// Destructor
 	~Table();
 
+	/// Search hint owned by the caller of interp().  Holds the breakpoint interval of the
+	/// last lookup on each axis so successive, nearby lookups hunt from there instead of
+	/// searching the whole axis.  Give each thread (or each entity) its own Cursor and a
+	/// single table can be evaluated concurrently without locking.
+	struct Cursor
+	{
+		unsigned int row = ~0u;
+		unsigned int column = ~0u;
+		unsigned int table = ~0u;
+
+		/// Forget the cached intervals, the next lookup does a full search
+		void reset() { row = column = table = ~0u; }
+	};
+
+	/// Location of a key on one breakpoint axis, found once with prelookup() and shared by
+	/// every table with the same breakpoints on that axis (see hasSameBreakpoints()), which
+	/// then interpolate without searching.  Keep one Prelookup per axis from lookup to
+	/// lookup, its interval is the search hint for the next key like a Cursor's.
+	struct Prelookup
+	{
+		/// Interval [bp[index], bp[index + 1]] holding the key (clamped to the first/last interval)
+		unsigned int index = ~0u;
+		/// Position of the key in the interval, (key - bp[index]) / (bp[index + 1] - bp[index]), not clamped
+		T fraction = 0;
+		/// Distance of the key from bp[index]
+		T offset = 0;
+		/// Is the key at or before the first breakpoint?
+		bool below = false;
+		/// Is the key at or after the last breakpoint?
+		bool above = false;
+
+		/// Forget the cached interval, the next prelookup does a full search
+		void reset() { index = ~0u; }
+	};
+
 	/// Get interpolated value from a 1D table
 	T interp(T key, bool extrapolate = false) const;
 	/// Get interpolated value from a 2D table
@@ -171,6 +277,62 @@ public:
 	/// Get interpolated value from a 3D table
 	T interp(T rowKey, T colKey, T tableKey, bool extrapolate = false) const;
 
+	/// Get interpolated value from a 1D table, starting the search from the cursor
+	T interp(T key, Cursor& cursor, bool extrapolate = false) const;
+	/// Get interpolated value from a 2D table, starting the search from the cursor
+	T interp(T rowKey, T colKey, Cursor& cursor, bool extrapolate = false) const;
+	/// Get interpolated value from a 3D table, starting the search from the cursor
+	T interp(T rowKey, T colKey, T tableKey, Cursor& cursor, bool extrapolate = false) const;
+
+	/// Get interpolated value from a 1D table and its derivative, gradient[0] = d/dkey.  Derivatives
+	/// are analytic: the slope of the blended interval, or the derivative of the spline polynomial.
+	/// They are zero for nearest neighbor tables and outside the breakpoints unless extrapolating,
+	/// and one-sided (from the interval the key is found in) on a breakpoint.
+	T interpWithGradient(T key, T gradient[1], bool extrapolate = false) const;
+	/// Get interpolated value from a 2D table and its partial derivatives, gradient[0] = d/drowKey, gradient[1] = d/dcolKey
+	T interpWithGradient(T rowKey, T colKey, T gradient[2], bool extrapolate = false) const;
+	/// Get interpolated value from a 3D table and its partial derivatives, gradient[2] = d/dtableKey
+	T interpWithGradient(T rowKey, T colKey, T tableKey, T gradient[3], bool extrapolate = false) const;
+
+	/// Get interpolated value and derivative from a 1D table, starting the search from the cursor
+	T interpWithGradient(T key, T gradient[1], Cursor& cursor, bool extrapolate = false) const;
+	/// Get interpolated value and partial derivatives from a 2D table, starting the search from the cursor
+	T interpWithGradient(T rowKey, T colKey, T gradient[2], Cursor& cursor, bool extrapolate = false) const;
+	/// Get interpolated value and partial derivatives from a 3D table, starting the search from the cursor
+	T interpWithGradient(T rowKey, T colKey, T tableKey, T gradient[3], Cursor& cursor, bool extrapolate = false) const;
+
+	/// Locate a key on one breakpoint axis of the table, starting the search from the prelookup's interval
+	void prelookup(T key, TableAxis axis, Prelookup& prelookup) const;
+	/// Get interpolated value from a 1D table at a prelocated key
+	T interp(const Prelookup& row, bool extrapolate = false) const;
+	/// Get interpolated value from a 2D table at prelocated keys
+	T interp(const Prelookup& row, const Prelookup& column, bool extrapolate = false) const;
+	/// Get interpolated value from a 3D table at prelocated keys
+	T interp(const Prelookup& row, const Prelookup& column, const Prelookup& table, bool extrapolate = false) const;
+
+	/// Does the table have exactly the same breakpoints as another table on the given axis, so a
+	/// prelookup on one is valid for the other?  Tables that both lack the axis match, and the
+	/// layers of a 3D table must all share the row (and column) breakpoints for those to match.
+	bool hasSameBreakpoints(const Table<T>& table, TableAxis axis) const;
+
+	/// Interpolate a batch of keys from a 1D table: out[i] = interp(keys[i]).  Linear and
+	/// nearest neighbor tables are blended several keys at a time with SIMD instructions.
+	/// When sortedKeys is set the keys are expected to be in order (or at least close
+	/// to each other) and the breakpoints are swept in one pass instead of searched per key.
+	void interp(const T* keys, T* out, size_t count, bool extrapolate = false, bool sortedKeys = false) const;
+	/// Interpolate a batch of keys from a 2D table: out[i] = interp(rowKeys[i], colKeys[i])
+	void interp(const T* rowKeys, const T* colKeys, T* out, size_t count, bool extrapolate = false, bool sortedKeys = false) const;
+	/// Interpolate a batch of keys from a 3D table: out[i] = interp(rowKeys[i], colKeys[i], tableKeys[i])
+	void interp(const T* rowKeys, const T* colKeys, const T* tableKeys, T* out, size_t count, bool extrapolate = false, bool sortedKeys = false) const;
+
+	/// Resample the table onto evenly spaced breakpoints and return it as a linear table, which
+	/// finds its cells directly and blends them linearly.  Breakpoints are added until the linear
+	/// table stays within tolerance of this one (measured between the new breakpoints, see NOTES in
+	/// Table.cpp) or it would need more than maxValues values per layer.  maxDeviation receives the
+	/// largest difference measured.  Inside the breakpoint range the compiled table follows the
+	/// splines; when extrapolating it continues its end cells linearly.
+	Table<T> compile(T tolerance, T* maxDeviation = nullptr, size_t maxValues = 1 << 20) const;
+
 	/// Get table element entry at a given row and column index
 	T get(unsigned int row, unsigned int col) const;
 	T operator()(unsigned int row, unsigned int col) const;
@@ -189,10 +351,32 @@ public:
 	/// Get the number of tables in this root table
 	unsigned int getNumTables() const;
 
+	/// Get the number of bytes used by the table, including its spline polynomials
+	/// (the data is shared with copies of the table, so each copy reports all of it)
+	size_t getMemoryUsage() const;
+
 	/// Stream operators to feed table data
 	Table<T>& operator<<(const T n);
 	Table<T>& operator<<(const int n);
 
+	/// Replace the table with the one in a binary table file (see writeFile()).  The file is
+	/// memory mapped and its values and spline polynomials are used in place, so only the parts
+	/// of the table actually looked up are ever read from disk.  The file must not change while
+	/// the table (or a copy of it) uses it.  Returns false, leaving the table unchanged, if the
+	/// file cannot be read or was written for the other value type (float/double).
+	bool readFile(const std::string& filePath);
+
+	/// Write the table to a binary table file, including its spline polynomials.  The file is
+	/// written as filePath.tmp and then replaces filePath, so other tables mapping the old file
+	/// keep reading it.  Returns false for the file the table itself is read from.
+	bool writeFile(const std::string& filePath) const;
+
+	/// Replace the table with one read from a comma separated text file, laid out like the
+	/// stream operators: a 1D table is one "breakpoint, value" pair per line, a 2D table
+	/// starts with a line of column breakpoints (optionally after an empty corner field),
+	/// then one line per row with its breakpoint followed by its values.
+	bool readCSV(const std::string& filePath, InterpMethod method = InterpMethod::INTERP_LINEAR);
+
 private:
 	class Impl;
 	Impl* mImpl = nullptr;
@@ -0,0 +1,189 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       TableGroup.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef TableGroup_H
+#define TableGroup_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+#include <vector>
+
+#include "Table.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Tables sharing the same breakpoints, evaluated together.
+
+Every table added to the group must have the same number of dimensions and exactly
+the same breakpoints as the first one on each of its axes (on every layer of a 3D
+table), which add() checks once.  interp() then locates the keys a single time per
+axis and evaluates every table from those prelookups, so a model with dozens of
+coefficient tables on the same axes pays for one search per axis instead of one per
+table.  The group holds copies of the tables, which share their data with the originals.
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+TableGroup<double> aero;
+size_t cl = aero.add(clTable);	//2D tables on Mach and alpha
+size_t cd = aero.add(cdTable);
+size_t cm = aero.add(cmTable);
+
+//once per frame, keeping the lookup from frame to frame
+TableGroup<double>::Lookup lookup;
+double coefficients[3];
+aero.interp(mach, alpha, lookup, coefficients);
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename T>
+class TableGroup
+{
+public:
+	typedef typename Table<T>::Prelookup Prelookup;
+
+	/// Value returned by add() for a table whose breakpoints differ from the group's
+	static const size_t INVALID_INDEX = ~(size_t)0;
+
+	/// Prelookups of the keys on each axis, also the search hints for the next keys
+	struct Lookup
+	{
+		Prelookup row;
+		Prelookup column;
+		Prelookup table;
+
+		/// Forget the cached intervals, the next lookup does a full search
+		void reset() { row.reset(); column.reset(); table.reset(); }
+	};
+
+	/// Add a table to the group.  Returns its index (its slot in the interp() output), or
+	/// INVALID_INDEX if its dimensions or breakpoints differ from the tables already added,
+	/// or if it is a 3D table whose layers do not all have the same breakpoints.
+	size_t add(const Table<T>& table)
+	{
+		//locate() searches the first table's axes, so every table (the first included) needs one
+		//set of breakpoints per axis: a 3D table whose layers differ has none to share
+		if (!table.hasSameBreakpoints(table, TableAxis::AXIS_ROW) ||
+			!table.hasSameBreakpoints(table, TableAxis::AXIS_COLUMN))
+		{
+			//TODO: WARNING message for adding a table whose layers have different breakpoints to a table group
+			return INVALID_INDEX;
+		}
+
+		if (!tables.empty())
+		{
+			const Table<T>& first = tables[0];
+			if (dimensions(table) != dimensions(first) ||
+				!table.hasSameBreakpoints(first, TableAxis::AXIS_ROW) ||
+				!table.hasSameBreakpoints(first, TableAxis::AXIS_COLUMN) ||
+				!table.hasSameBreakpoints(first, TableAxis::AXIS_TABLE))
+			{
+				//TODO: WARNING message for adding a table with different breakpoints to a table group
+				return INVALID_INDEX;
+			}
+		}
+
+		tables.push_back(table);
+		return tables.size() - 1;
+	}
+
+	/// Number of tables in the group
+	size_t size() const { return tables.size(); }
+
+	/// Table at the given index
+	const Table<T>& operator[](size_t index) const { return tables[index]; }
+
+	/// Locate the keys of the group's axes once, searching from the lookup's intervals
+	void locate(T rowKey, Lookup& lookup) const
+	{
+		if (!tables.empty()) {
+			tables[0].prelookup(rowKey, TableAxis::AXIS_ROW, lookup.row);
+		}
+	}
+	void locate(T rowKey, T colKey, Lookup& lookup) const
+	{
+		locate(rowKey, lookup);
+		if (!tables.empty() && dimensions(tables[0]) > 1) {
+			tables[0].prelookup(colKey, TableAxis::AXIS_COLUMN, lookup.column);
+		}
+	}
+	void locate(T rowKey, T colKey, T tableKey, Lookup& lookup) const
+	{
+		locate(rowKey, colKey, lookup);
+		if (!tables.empty() && dimensions(tables[0]) > 2) {
+			tables[0].prelookup(tableKey, TableAxis::AXIS_TABLE, lookup.table);
+		}
+	}
+
+	/// Evaluate every table at located keys: out[i] is the value of the i-th table
+	void interp(const Lookup& lookup, T* out, bool extrapolate = false) const
+	{
+		for (size_t i = 0; i < tables.size(); i++) {
+			out[i] = tables[i].interp(lookup.row, lookup.column, lookup.table, extrapolate);
+		}
+	}
+
+	/// Locate the keys and evaluate every table of a 1D group
+	void interp(T key, Lookup& lookup, T* out, bool extrapolate = false) const
+	{
+		locate(key, lookup);
+		interp(lookup, out, extrapolate);
+	}
+	/// Locate the keys and evaluate every table of a 2D group
+	void interp(T rowKey, T colKey, Lookup& lookup, T* out, bool extrapolate = false) const
+	{
+		locate(rowKey, colKey, lookup);
+		interp(lookup, out, extrapolate);
+	}
+	/// Locate the keys and evaluate every table of a 3D group
+	void interp(T rowKey, T colKey, T tableKey, Lookup& lookup, T* out, bool extrapolate = false) const
+	{
+		locate(rowKey, colKey, tableKey, lookup);
+		interp(lookup, out, extrapolate);
+	}
+
+private:
+	//Number of dimensions of a table (only 3D tables have a number of tables)
+	static unsigned int dimensions(const Table<T>& table)
+	{
+		return table.getNumTables() > 0 ? 3 : table.getNumColumns() > 1 ? 2 : 1;
+	}
+
+	std::vector<Table<T>> tables;
+};
+
+} //namespace otMath
+
+#endif //TableGroup_H
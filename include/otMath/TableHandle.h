@@ -0,0 +1,224 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       TableHandle.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef TableHandle_H
+#define TableHandle_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Table.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Table that can be replaced while other threads are interpolating it.
+
+The handle owns the current version of the table behind an atomic pointer.  A loader
+thread builds a new table in the background and publish() makes it current with a single
+atomic exchange; lookups already running keep using the version they acquired.
+
+Each thread reading the table registers a Reader and calls acquire() once per frame: it
+announces the epoch it is reading in and loads the current pointer, without locking or
+waiting on the loader.  The reference stays valid until the reader's next acquire() or
+release().  Versions replaced by publish() are retired, and reclaim() deletes those that
+no reader can still hold, i.e. once every reader has acquired again or released since the
+version was replaced (the grace period).  publish() reclaims what it can, it never waits
+for the readers either, so a slow frame only delays when an old version is freed.
+
+Publish tables whose data is complete (streamed in or read from a file) so their splines
+are built on the loader thread rather than by the first lookup after the swap.  Cursors
+stay valid across versions (a stale hint only costs a search), Prelookups do not: compare
+getVersion() with the version seen last frame and locate the keys again when it changed.
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+TableHandle<double> aero(initialTable);
+
+//physics thread
+TableHandle<double>::Reader reader(aero);
+
+void updatePhysics(float dt)
+{
+	const Table<double>& cl = reader.acquire();
+	double value = cl.interp(mach, alpha, cursor);
+	...
+}
+
+//loader thread
+Table<double> tuned;
+tuned.readFile("aero.ottb");
+aero.publish(std::move(tuned));
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+template <typename T>
+class TableHandle
+{
+public:
+	/// A thread reading the handle's table, must not outlive the handle
+	class Reader
+	{
+	public:
+		/// Register a reader of the handle
+		explicit Reader(TableHandle<T>& handle) : handle(handle)
+		{
+			std::lock_guard<std::mutex> lock(handle.mutex);
+			handle.readers.push_back(&epoch);
+		}
+
+		/// Unregister the reader, releasing the version it holds
+		~Reader()
+		{
+			std::lock_guard<std::mutex> lock(handle.mutex);
+			handle.readers.erase(std::find(handle.readers.begin(), handle.readers.end(), &epoch));
+		}
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		/// Get the current version of the table, valid until the next acquire() or release()
+		const Table<T>& acquire()
+		{
+			//the epoch must be visible before the pointer is loaded (see reclaim())
+			epoch.store(handle.epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+			return *handle.current.load(std::memory_order_seq_cst);
+		}
+
+		/// Let the versions acquired so far be reclaimed, e.g. while the reader idles
+		void release()
+		{
+			epoch.store(0, std::memory_order_release);
+		}
+
+	private:
+		TableHandle<T>& handle;
+		std::atomic<uint64_t> epoch{ 0 };	//epoch of the last acquire(), 0 while released
+	};
+
+	/// Constructor takes the first version of the table
+	explicit TableHandle(const Table<T>& table) : current(new Table<T>(table)) {}
+	explicit TableHandle(Table<T>&& table) : current(new Table<T>(std::move(table))) {}
+
+	/// Destructor deletes every version, all readers must be gone
+	~TableHandle()
+	{
+		delete current.load();
+		for (auto& version : retired) {
+			delete version.second;
+		}
+	}
+
+	TableHandle(const TableHandle&) = delete;
+	TableHandle& operator=(const TableHandle&) = delete;
+
+	/// Make a new version of the table current, returns its version number.  The version it
+	/// replaces is deleted once no reader can hold it anymore.
+	uint64_t publish(const Table<T>& table) { return publish(new Table<T>(table)); }
+	uint64_t publish(Table<T>&& table) { return publish(new Table<T>(std::move(table))); }
+
+	/// Delete the retired versions that no reader holds, returns the number still waiting
+	size_t reclaim()
+	{
+		std::vector<const Table<T>*> expired;
+		size_t waiting;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			//a reader that announced an epoch before a version was replaced may still hold
+			//it, one that announced a later epoch loaded the pointer after the exchange
+			uint64_t oldest = ~(uint64_t)0;
+			for (const std::atomic<uint64_t>* reader : readers)
+			{
+				uint64_t e = reader->load(std::memory_order_seq_cst);
+				if (e != 0 && e < oldest) {
+					oldest = e;
+				}
+			}
+
+			auto keep = std::partition(retired.begin(), retired.end(),
+				[oldest](const std::pair<uint64_t, const Table<T>*>& version) { return version.first > oldest; });
+			for (auto it = keep; it != retired.end(); ++it) {
+				expired.push_back(it->second);
+			}
+			retired.erase(keep, retired.end());
+			waiting = retired.size();
+		}
+
+		//delete outside the lock so registering readers never wait on it
+		for (const Table<T>* table : expired) {
+			delete table;
+		}
+		return waiting;
+	}
+
+	/// Number of versions published so far (0 for the first table)
+	uint64_t getVersion() const
+	{
+		return epoch.load(std::memory_order_acquire) - 1;
+	}
+
+private:
+	uint64_t publish(const Table<T>* table)
+	{
+		uint64_t version;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			const Table<T>* old = current.exchange(table, std::memory_order_seq_cst);
+			//readers announcing this epoch or later see the new table, earlier ones may hold the old one
+			version = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+			retired.push_back(std::make_pair(version, old));
+		}
+		reclaim();
+		return version - 1;
+	}
+
+	std::atomic<const Table<T>*> current;
+	std::atomic<uint64_t> epoch{ 1 };
+
+	std::mutex mutex;	//serializes publish(), reclaim() and reader registration, never taken by acquire()
+	std::vector<const std::atomic<uint64_t>*> readers;
+	std::vector<std::pair<uint64_t, const Table<T>*>> retired;	//replaced versions and the epoch they were replaced in
+};
+
+} //namespace otMath
+
+#endif //TableHandle_H
@@ -22,6 +22,8 @@ SENTRY
 INCLUDES
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
+#include <cstddef>
+
 #include "Geodetic3.h"
 #include "Geodetic2.h"
 #include "otMath.h"
@@ -34,11 +36,17 @@ namespace GeographicLib {
 class Geocentric;
 }
 
+namespace otCore {
+class ThreadPool;
+}
+
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 DEFINITIONS
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
-#ifdef WORLD_EXPORTS
+#if !defined(_WIN32)
+#define WORLD_API
+#elif defined(WORLD_EXPORTS)
 #define WORLD_API __declspec(dllexport)
 #else
 #define WORLD_API __declspec(dllimport)
@@ -46,6 +54,32 @@ DEFINITIONS
 
 namespace otWorld {
 
+/// Methods for converting ECEF coordinates (X,Y,Z) to geodetic coordinates (lat,lon,alt)
+enum class GeodeticConversion
+{
+	/// Newton iteration onto the surface of the ellipsoid.  Works for any ellipsoid, but the
+	/// number of iterations depends on the position
+	ITERATIVE = 0,
+	/// Closed form solution (Vermeille), fixed cost with no iteration.  Needs an ellipsoid of
+	/// revolution flattened at the poles (equal X and Y radii, Z radius not larger), other
+	/// ellipsoids use ITERATIVE.  For the Earth, from 10 km below the surface out to the Moon,
+	/// within 1e-15 rad in latitude and longitude and 1e-15 of the distance from the center in
+	/// height (6 nm at the surface) of GeographicLib::Geocentric
+	CLOSED_FORM,
+};
+
+/// Methods for the distance and bearings between two geodetic coordinates
+enum class GeodesicSolution
+{
+	/// Great circle on the sphere of the mean radius, as getEstimatedDistanceAndBearing
+	/// (error up to about 0.5%)
+	ESTIMATED = 0,
+	/// Vincenty's iteration, as getDistanceAndBearing (may not converge near antipodal points)
+	VINCENTY,
+	/// Karney's solution, as getExactDistanceAndBearing
+	EXACT,
+};
+
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 CLASS DOCUMENTATION
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
@@ -76,6 +110,7 @@ public:
 	/// Fairly intensive iterative function that is usually quite accurate..
 	/// Only use this function when a good destination and/or final bearing value is necessary.
 	/// Use getEstimatedDestinationPoint function instead to get a quicker estimate.
+	/// The destination keeps the height of the origin.  For many points along the same geodesic, use a GeodesicRoute.
 	void getDestinationPoint(const Geodetic3& origin, Geodetic3& destination,
 		double distance, double initialBearing, double& finalBearing) const;
 
@@ -159,9 +194,58 @@ public:
 	/// Convert the given ECEF coordinates (X,Y,Z) to geodetic coordinates (lat,lon,alt) the Geodetic3 structure
 	Geodetic3 toGeodetic3(const Vector3& position) const;
 
+	/// Convert the given ECEF coordinates (X,Y,Z) to geodetic coordinates (lat,lon,alt) the Geodetic3 structure,
+	/// with the given conversion method instead of the ellipsoid's
+	Geodetic3 toGeodetic3(const Vector3& position, GeodeticConversion conversion) const;
+
 	/// Convert the given ECEF coordinates (X,Y,Z) to geodetic coordinates (lat,lon) the Geodetic2 structure
 	Geodetic2 toGeodetic2(const Vector3& position) const;
 
+	/// Convert the given ECEF coordinates (X,Y,Z) to geodetic coordinates (lat,lon) the Geodetic2 structure,
+	/// with the given conversion method instead of the ellipsoid's
+	Geodetic2 toGeodetic2(const Vector3& position, GeodeticConversion conversion) const;
+
+	/// Set the conversion method used by toGeodetic3 and toGeodetic2 (ITERATIVE by default)
+	void setGeodeticConversion(GeodeticConversion conversion);
+
+	/// Return the conversion method used by toGeodetic3 and toGeodetic2
+	GeodeticConversion getGeodeticConversion(void) const;
+
+	/// Convert count geodetic coordinates given as separate arrays (lat,lon,alt) to ECEF coordinates
+	/// in separate arrays (X,Y,Z).  The sines and cosines are computed a batch at a time with
+	/// vectorized instructions, within 2e-16 of the results of toECEF for a Geodetic3 for angles
+	/// up to 1e5 rad.  Given a thread pool, large batches are split across its threads.
+	void toECEF(const double* latitudes, const double* longitudes, const double* heights,
+		double* x, double* y, double* z, size_t count, otCore::ThreadPool* pool = nullptr) const;
+
+	/// Convert count ECEF coordinates given as separate arrays (X,Y,Z) to geodetic coordinates in
+	/// separate arrays (lat,lon,alt) with the ellipsoid's conversion method.  With CLOSED_FORM the
+	/// roots and arc tangents are computed a batch at a time with vectorized instructions, to the
+	/// accuracy of CLOSED_FORM, positions it does not handle (close to the center) falling back to
+	/// toGeodetic3.  Given a thread pool, large batches are split across its threads.
+	void toGeodetic3(const double* x, const double* y, const double* z,
+		double* latitudes, double* longitudes, double* heights, size_t count, otCore::ThreadPool* pool = nullptr) const;
+
+	/// Convert count ECEF coordinates given as separate arrays (X,Y,Z) to geodetic coordinates in
+	/// separate arrays (lat,lon,alt), with the given conversion method instead of the ellipsoid's
+	void toGeodetic3(const double* x, const double* y, const double* z,
+		double* latitudes, double* longitudes, double* heights, size_t count,
+		GeodeticConversion conversion, otCore::ThreadPool* pool = nullptr) const;
+
+	/// Get the distances and bearings from each of numOrigins origins to each of numDestinations
+	/// destinations, given as separate arrays (lat,lon), in matrices of numOrigins rows by
+	/// numDestinations columns: distances[i * numDestinations + j] is from origin i to destination j.
+	/// The bearings are in [0, 2 pi) as for getDistanceAndBearing, their matrices may be null.
+	/// The ESTIMATED solution also gives the final bearing (getEstimatedDistanceAndBearing returns 0).
+	/// If maxDistance > 0, the estimate is a prefilter for the other solutions: pairs estimated
+	/// further than maxDistance by more than the error of the estimate are only estimated, so only
+	/// pairs within maxDistance are solved.  Given a thread pool, the rows are split across its threads.
+	void getDistanceAndBearingMatrix(const double* originLatitudes, const double* originLongitudes, size_t numOrigins,
+		const double* destinationLatitudes, const double* destinationLongitudes, size_t numDestinations,
+		double* distances, double* initialBearings, double* finalBearings,
+		GeodesicSolution solution = GeodesicSolution::EXACT, double maxDistance = 0.0,
+		otCore::ThreadPool* pool = nullptr) const;
+
 	/// Scale the given position Vector3 down to the geodetic surface to find the position on the surface of the ellipsoid
 	Vector3 ScaleToGeodeticSurface(const Vector3& position) const;
 
@@ -0,0 +1,165 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       GeodesicRoute.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef GeodesicRoute_H
+#define GeodesicRoute_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+
+#include "Geodetic2.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otWorld {
+class Ellipsoid;
+}
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#if !defined(_WIN32)
+#define WORLD_API
+#elif defined(WORLD_EXPORTS)
+#define WORLD_API __declspec(dllexport)
+#else
+#define WORLD_API __declspec(dllimport)
+#endif
+
+namespace otWorld {
+
+/// Spacing of the points sampled along a route
+enum class RouteSpacing
+{
+	/// Equal distances along the route
+	DISTANCE = 0,
+	/// Equal arc lengths on the auxiliary sphere of the geodesics (cheaper, the distances
+	/// between points vary by up to the flattening, 0.3% on the Earth)
+	ARC_LENGTH,
+};
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Route of geodesic legs between waypoints, for sampling many points along it.
+
+Each leg is a GeographicLib::GeodesicLine (or GeodesicLineExact) built once from its
+endpoints, which holds the series of the direct problem for that geodesic, so a point
+along it costs a series evaluation instead of the full direct problem of
+Ellipsoid::getDestinationPoint.
+
+Legs are cached by their endpoints: setting waypoints again (a flight plan edited or
+re-sent) only builds the legs whose endpoints changed.  Legs no longer in the route
+stay cached, up to the maximum number of cached legs, beyond which the least
+recently used are dropped first.
+
+The route copies the shape of the ellipsoid, which needs equal X and Y radii (as
+for the geodesic functions of Ellipsoid); otherwise it has no legs.  Latitudes,
+longitudes and bearings are in radians, bearings in [0, 2 pi) as for
+Ellipsoid::getDistanceAndBearing, longitudes in [-pi, pi].
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+GeodesicRoute route(earth);
+route.setWaypoints(waypoints, numWaypoints);
+
+route.sample(256, latitudes, longitudes);	//the route for display
+Geodetic2 position = route.getPoint(distanceFlown, &bearing);
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+class WORLD_API GeodesicRoute
+{
+public:
+	/// Constructor given the ellipsoid and whether the legs are GeodesicLineExact (for flattenings
+	/// beyond 0.01) instead of GeodesicLine (accurate to 15 nm for |f| < 0.01, as the Earth)
+	explicit GeodesicRoute(const Ellipsoid& ellipsoid, bool exact = false);
+
+	/// Destructor
+	~GeodesicRoute();
+
+	/// Set the waypoints of the route, with a leg from each to the next.  Returns false and
+	/// leaves the route empty if the ellipsoid has no geodesics
+	bool setWaypoints(const Geodetic2* waypoints, size_t count);
+
+	/// Add a waypoint at the end of the route.  Returns false if the ellipsoid has no geodesics
+	bool addWaypoint(const Geodetic2& waypoint);
+
+	/// Remove the waypoints (the legs stay cached)
+	void clearWaypoints(void);
+
+	/// Return the number of waypoints
+	size_t getNumWaypoints(void) const;
+
+	/// Return the given waypoint
+	Geodetic2 getWaypoint(size_t index) const;
+
+	/// Return the length of the route (m)
+	double getLength(void) const;
+
+	/// Return the length of the given leg, from waypoint leg to waypoint leg + 1 (m)
+	double getLegLength(size_t leg) const;
+
+	/// Return the point at the given distance along the route (m, clamped to the route) and
+	/// optionally the bearing of the route there
+	Geodetic2 getPoint(double distance, double* bearing = nullptr) const;
+
+	/// Sample count points along the route with the given spacing, the first at the first
+	/// waypoint and the last at the last one, into separate arrays.  bearings may be null
+	void sample(size_t count, double* latitudes, double* longitudes, double* bearings = nullptr,
+		RouteSpacing spacing = RouteSpacing::DISTANCE) const;
+
+	/// Sample the points at count distances along the route (m, clamped to the route, in any
+	/// order) into separate arrays.  bearings may be null
+	void sample(const double* distances, size_t count, double* latitudes, double* longitudes,
+		double* bearings = nullptr) const;
+
+	/// Set the largest number of cached legs, legs not in the route are dropped beyond it, least recently
+	/// used first (1024 by default)
+	void setMaxCachedLegs(size_t maxCachedLegs);
+
+	/// Return the largest number of cached legs
+	size_t getMaxCachedLegs(void) const;
+
+	/// Return the number of cached legs
+	size_t getNumCachedLegs(void) const;
+
+	/// Return the number of legs built (not found in the cache) since construction
+	unsigned long long getNumLegsBuilt(void) const;
+
+private:
+	// Make this object be noncopyable because it holds a pointer
+	GeodesicRoute(const GeodesicRoute& route);
+	const GeodesicRoute &operator =(const GeodesicRoute &);
+
+	// Pointer to implementation
+	class Impl;
+	Impl* mImpl;
+};
+
+} //namespace otWorld
+
+#endif //GeodesicRoute_H
@@ -34,7 +34,9 @@ FORWARD DECLARATIONS
 DEFINITIONS
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
-#ifdef WORLD_EXPORTS
+#if !defined(_WIN32)
+#define WORLD_API
+#elif defined(WORLD_EXPORTS)
 #define WORLD_API __declspec(dllexport)
 #else
 #define WORLD_API __declspec(dllimport)
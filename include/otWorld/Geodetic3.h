@@ -36,7 +36,9 @@ namespace otWorld {
 DEFINITIONS
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
-#ifdef WORLD_EXPORTS
+#if !defined(_WIN32)
+#define WORLD_API
+#elif defined(WORLD_EXPORTS)
 #define WORLD_API __declspec(dllexport)
 #else
 #define WORLD_API __declspec(dllimport)
@@ -0,0 +1,129 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       GeodeticConverter.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef GeodeticConverter_H
+#define GeodeticConverter_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "Geodetic3.h"
+#include "Geodetic2.h"
+#include "otMath.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otWorld {
+class Ellipsoid;
+}
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#if !defined(_WIN32)
+#define WORLD_API
+#elif defined(WORLD_EXPORTS)
+#define WORLD_API __declspec(dllexport)
+#else
+#define WORLD_API __declspec(dllimport)
+#endif
+
+namespace otWorld {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** ECEF to geodetic conversion for the successive positions of one entity.
+
+Converts like the ITERATIVE method of Ellipsoid::toGeodetic3 (Newton iteration onto
+the surface), but starts the iteration from the scale factor found for the previous
+position instead of an estimate, and finds the latitude and longitude as small
+increments from the previous ones (from the angles between the cached surface normal
+and the new one) instead of with asin and atan2.  For an entity moving a few meters per call this converges in
+one step.  Moves longer than the warm start limit, and every 64th conversion (which
+bounds the build up of rounding in the increments), take the full conversion.
+
+The iteration also stops on a tighter test, so results are more accurate than those
+of Ellipsoid::toGeodetic3: for entities moving near the Earth (up to low orbit),
+within 1e-14 rad in latitude and longitude and 1e-15 of the distance from the center
+in height (6 nm at the surface) of GeographicLib::Geocentric.
+
+Use one converter per entity; it keeps a reference to the ellipsoid, which must
+outlive it, and reads the radii from the ellipsoid on each conversion rather than
+copying them.
+
+//////////////////////////
+///      Example:      ///
+//////////////////////////
+
+GeodeticConverter converter(earth);
+
+for (each frame) {
+	Geodetic3 geodetic = converter.toGeodetic3(position);
+}
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+class WORLD_API GeodeticConverter
+{
+public:
+	/// Constructor given the ellipsoid and the longest move from the previous position (m)
+	/// warm started, longer ones take the full conversion
+	explicit GeodeticConverter(const Ellipsoid& ellipsoid, double maxWarmStep = 10000.0);
+
+	/// Destructor
+	~GeodeticConverter();
+
+	/// Convert the given ECEF coordinates (X,Y,Z) to geodetic coordinates (lat,lon,alt) the Geodetic3 structure
+	Geodetic3 toGeodetic3(const Vector3& position);
+
+	/// Convert the given ECEF coordinates (X,Y,Z) to geodetic coordinates (lat,lon) the Geodetic2 structure
+	Geodetic2 toGeodetic2(const Vector3& position);
+
+	/// Forget the previous position, the next conversion is a full one
+	void reset(void);
+
+	/// Set the longest move from the previous position (m) warm started
+	void setMaxWarmStep(double maxWarmStep);
+
+	/// Return the longest move from the previous position (m) warm started
+	double getMaxWarmStep(void) const;
+
+	/// Return the number of warm started conversions since construction
+	unsigned long long getNumWarmConversions(void) const;
+
+	/// Return the number of full conversions since construction
+	unsigned long long getNumFullConversions(void) const;
+
+private:
+	// Make this object be noncopyable because it holds a pointer
+	GeodeticConverter(const GeodeticConverter& converter);
+	const GeodeticConverter &operator =(const GeodeticConverter &);
+
+	// Pointer to implementation
+	class Impl;
+	Impl* mImpl;
+};
+
+} //namespace otWorld
+
+#endif //GeodeticConverter_H
@@ -59,6 +59,13 @@ public:
 
 	bool parseCelestialBodyConfig(const std::string& file);
 
+	/// Convert the internal gravity factor arrays of a celestial body config (internalGravityFactorTable
+	/// radiusFraction and gravityFraction) to the binary table file it names (internalGravityFactorTable.file,
+	/// absolute or relative to the folder of the config).  The config only reads that file once the
+	/// arrays are removed from it.  Returns false if the config has no arrays or no file name, or the
+	/// file cannot be written.
+	bool writeInternalGravityFactorTable(const std::string& file) const;
+
 	///Main update function for the celestial bodies called automatically by the simulator
 	///once per physics frame update.
 	///DO NOT CALL THIS FUNCTION
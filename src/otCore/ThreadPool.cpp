@@ -0,0 +1,261 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       ThreadPool.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+Pool of worker threads for splitting large loops over arrays.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+NOTES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+The chunks of a loop are split into one contiguous share per thread.  A share is
+an atomic counter of its next chunk and its end, any thread claims a chunk of it by
+incrementing the counter (on a cache line of its own).  Each thread claims the chunks of
+its own share first and then those left in the others' shares, in turn from the
+next thread, so stealing takes no more than a failed increment per share.
+
+A worker joins a loop under the mutex only while the loop is posted, and the
+calling thread takes the loop down under the same mutex once no worker is left in
+it, so no worker can claim a chunk of the next loop with the function of a
+finished one.
+
+If the function throws, on any thread, the first exception is kept and every share
+is exhausted so no chunk starts after it.  The calling thread still waits for the
+workers to leave the chunks they are running and takes the loop down before
+rethrowing it, so the pool is ready for the next loop.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otCore {
+
+// true while the thread runs chunks of a loop, nested loops then run inline
+static thread_local bool runningChunks = false;
+
+// Chunks of a loop a thread starts with, [next, end), aligned so the counters of
+// two shares are never on the same cache line
+struct alignas(64) Share
+{
+	std::atomic<size_t> next{ 0 };
+	size_t end = 0;
+};
+
+class ThreadPool::Impl
+{
+public:
+	std::vector<std::thread> workers;
+	Share* shares = nullptr;			// one per thread, the calling thread's first
+	std::unique_ptr<char[]> shareStorage;	// holds the shares, new[] only aligns to 16 bytes before C++17
+
+	std::mutex loopMutex;				// held by the thread running a loop
+	std::mutex mutex;					// protects the posted loop and the counters below
+	std::condition_variable posted;		// a loop was posted, or the pool is quitting
+	std::condition_variable finished;	// the last worker left the loop
+
+	// posted loop, function is null when there is none
+	const std::function<void(size_t, size_t)>* function = nullptr;
+	size_t count = 0;
+	size_t chunkSize = 1;
+
+	unsigned int generation = 0;		// incremented for each loop
+	unsigned int activeWorkers = 0;		// workers running chunks of the posted loop
+	bool quit = false;
+	std::exception_ptr error;			// first exception thrown by the function in the posted loop
+
+	void runChunks(unsigned int thread);
+	void abandon(std::exception_ptr exception);
+	void workerLoop(unsigned int thread);
+};
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void ThreadPool::Impl::runChunks(unsigned int thread)
+{
+	runningChunks = true;
+	unsigned int numThreads = (unsigned int)workers.size() + 1;
+	for (unsigned int i = 0; i < numThreads; i++)
+	{
+		Share& share = shares[(thread + i) % numThreads];
+		for (;;)
+		{
+			size_t chunk = share.next.fetch_add(1);
+			if (chunk >= share.end) break;
+			size_t begin = chunk * chunkSize;
+			try {
+				(*function)(begin, std::min(begin + chunkSize, count));
+			}
+			catch (...) {
+				abandon(std::current_exception());
+				break;
+			}
+		}
+	}
+	runningChunks = false;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void ThreadPool::Impl::abandon(std::exception_ptr exception)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!error) {
+			error = exception;
+		}
+	}
+
+	// no chunk starts after the exception, the counters only ever grow past the end
+	unsigned int numThreads = (unsigned int)workers.size() + 1;
+	for (unsigned int i = 0; i < numThreads; i++) {
+		shares[i].next = shares[i].end;
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void ThreadPool::Impl::workerLoop(unsigned int thread)
+{
+	unsigned int seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;)
+	{
+		posted.wait(lock, [&]() { return quit || (function && generation != seen); });
+		if (quit) return;
+
+		seen = generation;
+		activeWorkers++;
+		lock.unlock();
+
+		runChunks(thread);
+
+		lock.lock();
+		if (--activeWorkers == 0) {
+			finished.notify_one();
+		}
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ThreadPool::ThreadPool(unsigned int numberThreads) : mImpl(new ThreadPool::Impl())
+{
+	if (numberThreads == 0) {
+		numberThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// the thread calling parallelFor is one of them, thread 0
+	size_t space = (numberThreads + 1) * sizeof(Share);
+	mImpl->shareStorage.reset(new char[space]);
+	void* storage = mImpl->shareStorage.get();
+	std::align(alignof(Share), numberThreads * sizeof(Share), storage, space);
+	mImpl->shares = static_cast<Share*>(storage);
+	for (unsigned int i = 0; i < numberThreads; i++) {
+		new (&mImpl->shares[i]) Share();
+	}
+	for (unsigned int i = 1; i < numberThreads; i++) {
+		mImpl->workers.emplace_back(&ThreadPool::Impl::workerLoop, mImpl, i);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mImpl->mutex);
+		mImpl->quit = true;
+	}
+	mImpl->posted.notify_all();
+	for (std::thread& worker : mImpl->workers) {
+		worker.join();
+	}
+
+	delete mImpl;
+	mImpl = nullptr;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+unsigned int ThreadPool::getNumThreads() const
+{
+	return (unsigned int)mImpl->workers.size() + 1;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void ThreadPool::parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& function)
+{
+	if (count == 0) return;
+	if (chunkSize == 0) chunkSize = 1;
+
+	// a single chunk, no workers, or a loop inside a chunk: run it here
+	if (count <= chunkSize || mImpl->workers.empty() || runningChunks)
+	{
+		for (size_t begin = 0; begin < count; begin += chunkSize) {
+			function(begin, std::min(begin + chunkSize, count));
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> loopLock(mImpl->loopMutex);
+	{
+		std::lock_guard<std::mutex> lock(mImpl->mutex);
+		mImpl->function = &function;
+		mImpl->count = count;
+		mImpl->chunkSize = chunkSize;
+
+		size_t numChunks = (count + chunkSize - 1) / chunkSize;
+		size_t numThreads = mImpl->workers.size() + 1;
+		for (size_t i = 0; i < numThreads; i++)
+		{
+			mImpl->shares[i].next = numChunks * i / numThreads;
+			mImpl->shares[i].end = numChunks * (i + 1) / numThreads;
+		}
+		mImpl->generation++;
+	}
+	mImpl->posted.notify_all();
+
+	mImpl->runChunks(0);
+
+	// every chunk is claimed, wait for the workers still running one and take the loop down
+	std::unique_lock<std::mutex> lock(mImpl->mutex);
+	mImpl->finished.wait(lock, [&]() { return mImpl->activeWorkers == 0; });
+	mImpl->function = nullptr;
+
+	std::exception_ptr error = mImpl->error;
+	mImpl->error = nullptr;
+	if (error)
+	{
+		lock.unlock();
+		std::rethrow_exception(error);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+} //namespace otCore
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -0,0 +1,190 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       MappedFile.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef MappedFile_H
+#define MappedFile_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Read-only memory mapping of a whole file.  Internal to otMath.
+
+The file is mapped, not read: pages are loaded by the OS the first time they
+are touched, so data that is never looked at is never read from disk.  The
+mapping starts on a page boundary and stays valid until close() or destruction.
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+class MappedFile
+{
+public:
+	MappedFile() {}
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/// Map the file at the given path, returns false if it cannot be opened or is empty
+	bool open(const std::string& filePath)
+	{
+		close();
+#ifdef _WIN32
+		fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+
+		mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mappingHandle != NULL) {
+			view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		}
+		if (view == nullptr)
+		{
+			close();
+			return false;
+		}
+		viewSize = (size_t)fileSize.QuadPart;
+#else
+		fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+		if (fileDescriptor < 0)
+			return false;
+
+		struct stat fileStat;
+		if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			close();
+			return false;
+		}
+
+		void* block = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+		if (block == MAP_FAILED)
+		{
+			close();
+			return false;
+		}
+		view = block;
+		viewSize = (size_t)fileStat.st_size;
+#endif
+		return true;
+	}
+
+	/// Unmap the file
+	void close()
+	{
+#ifdef _WIN32
+		if (view) UnmapViewOfFile(view);
+		if (mappingHandle != NULL) CloseHandle(mappingHandle);
+		if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+		mappingHandle = NULL;
+		fileHandle = INVALID_HANDLE_VALUE;
+#else
+		if (view) munmap(view, viewSize);
+		if (fileDescriptor >= 0) ::close(fileDescriptor);
+		fileDescriptor = -1;
+#endif
+		view = nullptr;
+		viewSize = 0;
+	}
+
+	/// First byte of the mapped file
+	const unsigned char* data() const { return (const unsigned char*)view; }
+
+	/// Size of the mapped file in bytes
+	size_t size() const { return viewSize; }
+
+	/// Is the file at the given path the mapped one (the same file, not only the same name)?
+	bool isFile(const std::string& filePath) const
+	{
+		if (view == nullptr)
+			return false;
+#ifdef _WIN32
+		HANDLE other = CreateFileA(filePath.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (other == INVALID_HANDLE_VALUE)
+			return false;
+		BY_HANDLE_FILE_INFORMATION mapped, info;
+		bool same = GetFileInformationByHandle(fileHandle, &mapped) && GetFileInformationByHandle(other, &info) &&
+			mapped.dwVolumeSerialNumber == info.dwVolumeSerialNumber &&
+			mapped.nFileIndexHigh == info.nFileIndexHigh && mapped.nFileIndexLow == info.nFileIndexLow;
+		CloseHandle(other);
+		return same;
+#else
+		struct stat mapped, info;
+		return fstat(fileDescriptor, &mapped) == 0 && stat(filePath.c_str(), &info) == 0 &&
+			mapped.st_dev == info.st_dev && mapped.st_ino == info.st_ino;
+#endif
+	}
+
+	/// Replace the file at filePath with the one at sourcePath, in a single step so readers see
+	/// either file whole.  A file mapped elsewhere keeps its old contents on POSIX systems, and
+	/// is not replaced (returning false) on Windows.
+	static bool replaceFile(const std::string& sourcePath, const std::string& filePath)
+	{
+#ifdef _WIN32
+		return MoveFileExA(sourcePath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		return std::rename(sourcePath.c_str(), filePath.c_str()) == 0;
+#endif
+	}
+
+private:
+#ifdef _WIN32
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE mappingHandle = NULL;
+#else
+	int fileDescriptor = -1;
+#endif
+	void* view = nullptr;
+	size_t viewSize = 0;
+};
+
+} //namespace otMath
+
+#endif //MappedFile_H
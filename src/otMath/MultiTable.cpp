@@ -0,0 +1,641 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       MultiTable.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+MultiTable class implementation.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+NOTES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+The values are one aligned block, row-major, so the outputs of a row are
+adjacent and a lookup blends two contiguous rows.  Spline polynomials are
+packed per interval as order rows of numOutputs coefficients (the coefficients
+of t^k for every output are adjacent), so Horner's rule runs across all
+outputs at once.  The inner loops over outputs have no dependencies between
+iterations and are left to the compiler to vectorize.
+
+As with Table, lookups never write to the table and the splines are built as
+soon as the last value is streamed in.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "MultiTable.h"
+#include "TableStorage.h"
+#include "Splines.hh"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+template <typename T>
+class MultiTable<T>::Impl
+{
+public:
+	Impl(unsigned int numberRows, unsigned int numberOutputs, InterpMethod method)
+	{
+		numRows = numberRows < 1 ? 1 : numberRows;
+		numOutputs = numberOutputs < 1 ? 1 : numberOutputs;
+		if (supportsMethod(method)) {
+			interpMethod = method;
+		}
+		else {
+			//TODO: WARNING message for using unsupported Interpolation Method
+			interpMethod = InterpMethod::INTERP_LINEAR;
+		}
+		breakpoints.allocate(numRows);
+		values.allocate((size_t)numRows * numOutputs);
+	}
+
+	Impl(const Impl& impl)
+	{
+		*this = impl;
+	}
+
+	Impl& operator=(const Impl& impl)
+	{
+		if (this != &impl)
+		{
+			numRows = impl.numRows;
+			numOutputs = impl.numOutputs;
+			interpMethod = impl.interpMethod;
+			insertCtr = impl.insertCtr;
+			breakpoints = impl.breakpoints;
+			values = impl.values;
+			order = impl.order;
+			coefficients = impl.coefficients;
+			spacing = impl.spacing;
+			prepared.store(impl.prepared.load(std::memory_order_acquire));
+		}
+		return *this;
+	}
+
+	//Every 1D method except Hermite, which needs derivatives the table does not have
+	static bool supportsMethod(InterpMethod method)
+	{
+		return method != InterpMethod::INTERP_HERMITE;
+	}
+
+	//Has all the table data been streamed in?
+	bool dataComplete() const
+	{
+		return insertCtr >= (size_t)numRows * (numOutputs + 1);
+	}
+
+	//Build one spline per output over the shared breakpoints and pack their polynomials
+	void buildSplines()
+	{
+		order = 0;
+		coefficients.release();
+
+		if (interpMethod <= InterpMethod::INTERP_NEAREST || numRows < 2)
+			return;
+
+		Splines::SplineType type;
+		switch (interpMethod)
+		{
+		case InterpMethod::INTERP_PCHIP: type = Splines::PCHIP_TYPE; break;
+		case InterpMethod::INTERP_CUBIC: type = Splines::CUBIC_TYPE; break;
+		case InterpMethod::INTERP_AKIMA: type = Splines::AKIMA_TYPE; break;
+		case InterpMethod::INTERP_BESSEL: type = Splines::BESSEL_TYPE; break;
+		case InterpMethod::INTERP_QUINTIC: type = Splines::QUINTIC_TYPE; break;
+		default:
+			//TODO: WARNING message for using unsupported Interpolation Method
+			return;
+		}
+
+		size_t n = numRows;
+		size_t outputs = numOutputs;
+		std::vector<Splines::valueType> x(breakpoints.data(), breakpoints.data() + n);
+		std::vector<std::vector<Splines::valueType>> y(outputs, std::vector<Splines::valueType>(n));
+		std::vector<std::string> names(outputs);
+		std::vector<const char*> headers(outputs);
+		std::vector<const Splines::valueType*> columns(outputs);
+		std::vector<Splines::SplineType> types(outputs, type);
+		for (size_t j = 0; j < outputs; j++)
+		{
+			for (size_t i = 0; i < n; i++) {
+				y[j][i] = values[i * outputs + j];
+			}
+			names[j] = std::to_string(j);
+			headers[j] = names[j].c_str();
+			columns[j] = y[j].data();
+		}
+
+		Splines::SplineSet splineSet;
+		splineSet.build((Splines::sizeType)outputs, (Splines::sizeType)n, headers.data(), types.data(), x.data(), columns.data(), nullptr);
+
+		order = type == Splines::QUINTIC_TYPE ? 6 : 4;
+
+		//node derivatives of every output
+		std::vector<Splines::valueType> dx(n * outputs), dxx(order == 6 ? n * outputs : 0);
+		for (size_t j = 0; j < outputs; j++)
+		{
+			Splines::Spline* spline = splineSet.getSpline((Splines::sizeType)j);
+			for (Splines::sizeType i = 0; i < (Splines::sizeType)n; i++)
+			{
+				if (order == 6)
+				{
+					const Splines::QuinticSplineBase* quintic = static_cast<const Splines::QuinticSplineBase*>(spline);
+					dx[i * outputs + j] = quintic->ypNode(i);
+					dxx[i * outputs + j] = quintic->yppNode(i);
+				}
+				else {
+					dx[i * outputs + j] = static_cast<const Splines::CubicSplineBase*>(spline)->ypNode(i);
+				}
+			}
+		}
+
+		coefficients.allocate((n - 1) * order * outputs);
+		Splines::valueType basis[6][6];
+		for (size_t i = 0; i + 1 < n; i++)
+		{
+			hermiteMonomials(order, x[i + 1] - x[i], basis);
+			T* c = coefficients.data() + i * order * outputs;
+			for (size_t j = 0; j < outputs; j++)
+			{
+				Splines::valueType node[6] = { y[j][i], y[j][i + 1], dx[i * outputs + j], dx[(i + 1) * outputs + j], 0, 0 };
+				if (order == 6) {
+					node[4] = dxx[i * outputs + j];
+					node[5] = dxx[(i + 1) * outputs + j];
+				}
+
+				for (unsigned int k = 0; k < order; k++)
+				{
+					Splines::valueType sum = 0;
+					for (unsigned int m = 0; m < order; m++) {
+						sum += basis[m][k] * node[m];
+					}
+					c[k * outputs + j] = (T)sum;
+				}
+			}
+		}
+	}
+
+	//Build the splines and detect the breakpoint spacing, see Table
+	void finalize()
+	{
+		std::lock_guard<std::mutex> lock(prepareMutex);
+		if (!prepared.load(std::memory_order_relaxed))
+		{
+			buildSplines();
+			spacing.detect(breakpoints.data(), numRows);
+			prepared.store(true, std::memory_order_release);
+		}
+	}
+
+	void prepare()
+	{
+		if (!prepared.load(std::memory_order_acquire)) {
+			finalize();
+		}
+	}
+
+	//Copy the outputs of a row
+	void copyRow(unsigned int row, T* out) const
+	{
+		const T* v = values.data() + (size_t)row * numOutputs;
+		for (unsigned int j = 0; j < numOutputs; j++) {
+			out[j] = v[j];
+		}
+	}
+
+	//Interpolate every output in interval i, at offset t = key - bp[i] and fraction fac of the interval
+	void interpInterval(unsigned int i, T t, T fac, T* out, bool extrapolate) const
+	{
+		unsigned int outputs = numOutputs;
+
+		if (order > 0)
+		{
+			//Spline interpolation, Horner's rule across all outputs
+			const T* c = coefficients.data() + (size_t)i * order * outputs;
+			const T* top = c + (size_t)(order - 1) * outputs;
+			for (unsigned int j = 0; j < outputs; j++) {
+				out[j] = top[j];
+			}
+			for (int k = (int)order - 2; k >= 0; k--)
+			{
+				const T* ck = c + (size_t)k * outputs;
+				for (unsigned int j = 0; j < outputs; j++) {
+					out[j] = out[j] * t + ck[j];
+				}
+			}
+			return;
+		}
+
+		if (!extrapolate) {
+			fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+		}
+
+		if (interpMethod == InterpMethod::INTERP_NEAREST)
+		{
+			copyRow(fac < 0.5 ? i : i + 1, out);
+			return;
+		}
+
+		const T* lo = values.data() + (size_t)i * outputs;
+		const T* hi = lo + outputs;
+		for (unsigned int j = 0; j < outputs; j++) {
+			out[j] = fac*(hi[j] - lo[j]) + lo[j];
+		}
+	}
+
+	//Interpolate a single output in interval i, as interpInterval for its column only
+	T interpIntervalOutput(unsigned int i, T t, T fac, unsigned int output, bool extrapolate) const
+	{
+		unsigned int outputs = numOutputs;
+
+		if (order > 0)
+		{
+			const T* c = coefficients.data() + (size_t)i * order * outputs + output;
+			T out = c[(size_t)(order - 1) * outputs];
+			for (int k = (int)order - 2; k >= 0; k--) {
+				out = out * t + c[(size_t)k * outputs];
+			}
+			return out;
+		}
+
+		if (!extrapolate) {
+			fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+		}
+
+		if (interpMethod == InterpMethod::INTERP_NEAREST) {
+			return values[(size_t)(fac < 0.5 ? i : i + 1) * outputs + output];
+		}
+
+		T lo = values[(size_t)i * outputs + output];
+		T hi = values[(size_t)(i + 1) * outputs + output];
+		return fac*(hi - lo) + lo;
+	}
+
+	//Interpolate every output at the key
+	void interp(T key, T* out, Cursor& cursor, bool extrapolate) const
+	{
+		const T* x = breakpoints.data();
+		unsigned int n = numRows;
+
+		if (n < 2)
+		{
+			copyRow(0, out);
+			return;
+		}
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (interpMethod == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+		//check for extrapolation
+		if (!extrapolate)
+		{
+			if (key <= x[0])
+			{
+				cursor.row = 0;
+				copyRow(0, out);
+				return;
+			}
+			else if (key >= x[n - 1])
+			{
+				cursor.row = n - 2;
+				copyRow(n - 1, out);
+				return;
+			}
+		}
+
+		unsigned int i = findInterval(x, n, key, cursor.row, spacing);
+		T rng = x[i + 1] - x[i];
+		T t = key - x[i];
+		interpInterval(i, t, rng != 0.0 ? t / rng : (T)1.0, out, extrapolate);
+	}
+
+	//Interpolate a single output at the key
+	T interp(T key, unsigned int output, bool extrapolate) const
+	{
+		const T* x = breakpoints.data();
+		unsigned int n = numRows;
+
+		if (n < 2) {
+			return values[output];
+		}
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (interpMethod == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+		//check for extrapolation
+		if (!extrapolate)
+		{
+			if (key <= x[0]) {
+				return values[output];
+			}
+			else if (key >= x[n - 1]) {
+				return values[(size_t)(n - 1) * numOutputs + output];
+			}
+		}
+
+		unsigned int hint = ~0u;
+		unsigned int i = findInterval(x, n, key, hint, spacing);
+		T rng = x[i + 1] - x[i];
+		T t = key - x[i];
+		return interpIntervalOutput(i, t, rng != 0.0 ? t / rng : (T)1.0, output, extrapolate);
+	}
+
+	//Interpolate every output at a prelocated key
+	void interp(const Prelookup& row, T* out, bool extrapolate) const
+	{
+		if (numRows < 2)
+		{
+			copyRow(0, out);
+			return;
+		}
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (interpMethod == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+		//check for extrapolation
+		if (!extrapolate)
+		{
+			if (row.below)
+			{
+				copyRow(0, out);
+				return;
+			}
+			else if (row.above)
+			{
+				copyRow(numRows - 1, out);
+				return;
+			}
+		}
+
+		interpInterval(row.index, row.offset, row.fraction, out, extrapolate);
+	}
+
+	//Number of rows
+	unsigned int numRows = 0;
+	//Number of outputs per row
+	unsigned int numOutputs = 0;
+	//Method used for all outputs
+	InterpMethod interpMethod = InterpMethod::INTERP_LINEAR;
+	//Number of values streamed in so far (breakpoints included)
+	size_t insertCtr = 0;
+
+	AlignedArray<T> breakpoints;
+	//numRows rows of numOutputs values
+	AlignedArray<T> values;
+
+	//Coefficients per output of each polynomial (4 = cubic, 6 = quintic, 0 = no splines)
+	unsigned int order = 0;
+	//order * numOutputs coefficients per interval, coefficient [k * numOutputs + j] multiplies
+	//t^k for output j, with t = x - x[i]
+	AlignedArray<T> coefficients;
+
+	AxisSpacing<T> spacing;
+
+	//Set once the splines and spacing match the data, see Table
+	std::atomic<bool> prepared{ false };
+	std::mutex prepareMutex;
+};
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+MultiTable<T>::MultiTable(unsigned int numberRows, unsigned int numberOutputs, InterpMethod method)
+{
+	mImpl = new MultiTable::Impl(numberRows, numberOutputs, method);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+MultiTable<T>::MultiTable(const MultiTable<T>& table)
+{
+	mImpl = new MultiTable::Impl(*table.mImpl);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+MultiTable<T>& MultiTable<T>::operator=(const MultiTable<T>& table)
+{
+	if (this != &table)
+	{
+		if (mImpl) {
+			*mImpl = *table.mImpl;
+		}
+		else {
+			mImpl = new MultiTable::Impl(*table.mImpl);
+		}
+	}
+	return *this;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+MultiTable<T>::MultiTable(MultiTable<T>&& table) noexcept
+{
+	//the moved table is left an empty one-row, one-output table, usable like any other
+	mImpl = table.mImpl;
+	table.mImpl = new MultiTable::Impl(1, 1, InterpMethod::INTERP_LINEAR);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+MultiTable<T>& MultiTable<T>::operator=(MultiTable<T>&& table) noexcept
+{
+	std::swap(mImpl, table.mImpl);
+	return *this;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+MultiTable<T>::~MultiTable()
+{
+	delete mImpl;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void MultiTable<T>::interp(T key, T* out, bool extrapolate) const
+{
+	Cursor cursor;
+	interp(key, out, cursor, extrapolate);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void MultiTable<T>::interp(T key, T* out, Cursor& cursor, bool extrapolate) const
+{
+	mImpl->prepare();
+	mImpl->interp(key, out, cursor, extrapolate);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void MultiTable<T>::interp(const Prelookup& row, T* out, bool extrapolate) const
+{
+	mImpl->prepare();
+	mImpl->interp(row, out, extrapolate);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T MultiTable<T>::interp(T key, unsigned int output, bool extrapolate) const
+{
+	if (output >= mImpl->numOutputs)
+	{
+		//TODO: ERROR message informing user of attempting to access invalid output
+		return (T)0;
+	}
+
+	mImpl->prepare();
+	return mImpl->interp(key, output, extrapolate);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void MultiTable<T>::prelookup(T key, Prelookup& prelookup) const
+{
+	mImpl->prepare();
+
+	const T* bp = mImpl->breakpoints.data();
+	unsigned int n = mImpl->numRows;
+	if (n < 2)
+	{
+		prelookup.index = 0;
+		prelookup.fraction = prelookup.offset = 0;
+		prelookup.below = prelookup.above = true;
+		return;
+	}
+
+	unsigned int i = findInterval(bp, n, key, prelookup.index, mImpl->spacing);
+	T rng = bp[i + 1] - bp[i];
+	prelookup.offset = key - bp[i];
+	prelookup.fraction = rng != 0.0 ? prelookup.offset / rng : (T)1.0;
+	prelookup.below = key <= bp[0];
+	prelookup.above = key >= bp[n - 1];
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T MultiTable<T>::get(unsigned int row, unsigned int col) const
+{
+	if (row < 1 || row > mImpl->numRows || col > mImpl->numOutputs)
+		return (T)0;
+
+	if (col == 0)
+		return mImpl->breakpoints[row - 1];
+	return mImpl->values[(size_t)(row - 1) * mImpl->numOutputs + (col - 1)];
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T MultiTable<T>::operator()(unsigned int row, unsigned int col) const
+{
+	return get(row, col);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+InterpMethod MultiTable<T>::getInterpolationMethod() const
+{
+	return mImpl->interpMethod;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void MultiTable<T>::changeInterpolationMethod(InterpMethod method)
+{
+	if (method == mImpl->interpMethod)
+		return;
+
+	if (Impl::supportsMethod(method))
+	{
+		mImpl->interpMethod = method;
+		mImpl->prepared.store(false);
+		if (mImpl->dataComplete()) {
+			mImpl->finalize(); //rebuild the splines for the new method now rather than on the next lookup
+		}
+	}
+	else {
+		//TODO: WARNING message for using unsupported Interpolation Method
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+unsigned int MultiTable<T>::getNumRows() const
+{
+	return mImpl->numRows;
+}
+
+template <typename T>
+unsigned int MultiTable<T>::getNumOutputs() const
+{
+	return mImpl->numOutputs;
+}
+
+template <typename T>
+size_t MultiTable<T>::getMemoryUsage() const
+{
+	return sizeof(MultiTable<T>) + sizeof(MultiTable<T>::Impl) +
+		(mImpl->breakpoints.size() + mImpl->values.size() + mImpl->coefficients.size()) * sizeof(T);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+MultiTable<T>& MultiTable<T>::operator<<(const T n)
+{
+	Impl& impl = *mImpl;
+	if (impl.dataComplete())
+	{
+		//TODO: ERROR message informing user of attempting to access invalid array cell
+		return *this;
+	}
+
+	size_t rowSize = (size_t)impl.numOutputs + 1;
+	size_t row = impl.insertCtr / rowSize;
+	size_t col = impl.insertCtr % rowSize;
+	if (col == 0) {
+		impl.breakpoints[row] = n;
+	}
+	else {
+		impl.values[row * impl.numOutputs + (col - 1)] = n;
+	}
+	impl.insertCtr++;
+
+	impl.prepared.store(false);
+	if (impl.dataComplete()) {
+		impl.finalize(); //last value is in, build the splines before the first lookup
+	}
+	return *this;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+MultiTable<T>& MultiTable<T>::operator<<(const int n)
+{
+	*this << (T)n;
+	return *this;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+// Declare float and double types so the compiler can build these templates
+template class MATH_API MultiTable<float>;
+template class MATH_API MultiTable<double>;
+
+} //namespace otMath
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
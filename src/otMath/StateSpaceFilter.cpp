@@ -0,0 +1,576 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       StateSpaceFilter.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+StateSpaceFilter class implementation.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+NOTES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Transfer functions are realized in controllable canonical form, and series
+connections stack the state vectors of both systems, so a cascade of sections
+keeps the (well conditioned) realization of each section.
+
+With s = (2 / T) (z - 1) / (z + 1) and M = I - A T / 2, the Tustin equivalent is
+
+	Ad = M^-1 (I + A T / 2)		Bd = M^-1 B T
+	Cd = C M^-1					Dd = D + Cd B T / 2
+
+(the realization scipy's cont2discrete uses for the bilinear method).  T is dt,
+or 2 tan(w dt / 2) / w when prewarping at w rad/s, which maps the continuous
+frequency w exactly onto the discrete one.
+
+The state is stored as order rows of numChannels values.  A step computes
+y = Cd x + Dd u and x = Ad x + Bd u one row at a time with loops over the
+channels, which have no dependencies between iterations.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "StateSpaceFilter.h"
+#include "Conversions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+
+namespace {
+
+//Solve M X = R in place (M n x n, R n x m, both row major) by Gaussian elimination with
+//partial pivoting.  Returns false if M is singular.
+bool solve(std::vector<double> M, unsigned int n, std::vector<double>& R, unsigned int m)
+{
+	for (unsigned int col = 0; col < n; col++)
+	{
+		unsigned int pivot = col;
+		for (unsigned int row = col + 1; row < n; row++)
+		{
+			if (std::fabs(M[row * n + col]) > std::fabs(M[pivot * n + col])) {
+				pivot = row;
+			}
+		}
+		if (M[pivot * n + col] == 0.0) {
+			return false;
+		}
+		if (pivot != col)
+		{
+			for (unsigned int k = 0; k < n; k++) {
+				std::swap(M[col * n + k], M[pivot * n + k]);
+			}
+			for (unsigned int k = 0; k < m; k++) {
+				std::swap(R[col * m + k], R[pivot * m + k]);
+			}
+		}
+
+		for (unsigned int row = col + 1; row < n; row++)
+		{
+			double f = M[row * n + col] / M[col * n + col];
+			if (f == 0.0) {
+				continue;
+			}
+			for (unsigned int k = col; k < n; k++) {
+				M[row * n + k] -= f * M[col * n + k];
+			}
+			for (unsigned int k = 0; k < m; k++) {
+				R[row * m + k] -= f * R[col * m + k];
+			}
+		}
+	}
+
+	for (unsigned int col = n; col-- > 0;)
+	{
+		for (unsigned int k = 0; k < m; k++)
+		{
+			double sum = R[col * m + k];
+			for (unsigned int j = col + 1; j < n; j++) {
+				sum -= M[col * n + j] * R[j * m + k];
+			}
+			R[col * m + k] = sum / M[col * n + col];
+		}
+	}
+	return true;
+}
+
+//Continuous or discrete single input, single output system
+struct System
+{
+	unsigned int order = 0;
+	std::vector<double> A;	//order x order, row major
+	std::vector<double> B;	//order
+	std::vector<double> C;	//order
+	double D = 1.0;
+};
+
+//Controllable canonical realization of num(s) / den(s), coefficients from the highest power
+bool realize(const std::vector<double>& numerator, const std::vector<double>& denominator, System& sys)
+{
+	//drop leading zeros
+	size_t nd = 0, nn = 0;
+	while (nd < denominator.size() && denominator[nd] == 0.0) nd++;
+	while (nn < numerator.size() && numerator[nn] == 0.0) nn++;
+	std::vector<double> den(denominator.begin() + nd, denominator.end());
+	std::vector<double> num(numerator.begin() + nn, numerator.end());
+
+	if (den.empty() || num.size() > den.size()) {
+		return false;
+	}
+
+	unsigned int n = (unsigned int)den.size() - 1;
+	std::vector<double> b(n + 1, 0.0);
+	for (size_t i = 0; i < num.size(); i++) {
+		b[n + 1 - num.size() + i] = num[i] / den[0];
+	}
+
+	sys.order = n;
+	sys.A.assign((size_t)n * n, 0.0);
+	sys.B.assign(n, 0.0);
+	sys.C.assign(n, 0.0);
+	sys.D = b[0];
+	for (unsigned int j = 0; j < n; j++)
+	{
+		double a = den[j + 1] / den[0];
+		sys.A[j] = -a;
+		sys.C[j] = b[j + 1] - a * b[0];
+	}
+	for (unsigned int i = 1; i < n; i++) {
+		sys.A[i * n + i - 1] = 1.0;
+	}
+	if (n > 0) {
+		sys.B[0] = 1.0;
+	}
+	return true;
+}
+
+//Series connection, the output of first feeds the input of second
+System series(const System& first, const System& second)
+{
+	unsigned int n1 = first.order, n2 = second.order, n = n1 + n2;
+	System sys;
+	sys.order = n;
+	sys.A.assign((size_t)n * n, 0.0);
+	sys.B.assign(n, 0.0);
+	sys.C.assign(n, 0.0);
+
+	for (unsigned int i = 0; i < n1; i++)
+	{
+		for (unsigned int j = 0; j < n1; j++) {
+			sys.A[i * n + j] = first.A[i * n1 + j];
+		}
+		sys.B[i] = first.B[i];
+		sys.C[i] = second.D * first.C[i];
+	}
+	for (unsigned int i = 0; i < n2; i++)
+	{
+		for (unsigned int j = 0; j < n1; j++) {
+			sys.A[(n1 + i) * n + j] = second.B[i] * first.C[j];
+		}
+		for (unsigned int j = 0; j < n2; j++) {
+			sys.A[(n1 + i) * n + n1 + j] = second.A[i * n2 + j];
+		}
+		sys.B[n1 + i] = second.B[i] * first.D;
+		sys.C[n1 + i] = second.C[i];
+	}
+	sys.D = second.D * first.D;
+	return sys;
+}
+
+//Vectorizable steps over the channels, the arrays of a step never overlap
+template <typename T>
+void scale(T* out, T k, unsigned int count)
+{
+	for (unsigned int c = 0; c < count; c++) {
+		out[c] *= k;
+	}
+}
+
+template <typename T>
+void scale(T* __restrict out, const T* __restrict in, T k, unsigned int count)
+{
+	for (unsigned int c = 0; c < count; c++) {
+		out[c] = k * in[c];
+	}
+}
+
+template <typename T>
+void accumulate(T* __restrict out, const T* __restrict in, T k, unsigned int count)
+{
+	for (unsigned int c = 0; c < count; c++) {
+		out[c] += k * in[c];
+	}
+}
+
+} //namespace
+
+template <typename T>
+class StateSpaceFilter<T>::Impl
+{
+public:
+	Impl(unsigned int numberChannels)
+	{
+		numChannels = numberChannels < 1 ? 1 : numberChannels;
+		discrete.D = 1.0;
+		apply();
+	}
+
+	//Use the discrete system for the filter, keeping the state if the order did not change
+	void apply()
+	{
+		unsigned int n = discrete.order;
+		Ad.assign(discrete.A.begin(), discrete.A.end());
+		Bd.assign(discrete.B.begin(), discrete.B.end());
+		Cd.assign(discrete.C.begin(), discrete.C.end());
+		Dd = (T)discrete.D;
+
+		if (state.size() != (size_t)n * numChannels)
+		{
+			state.assign((size_t)n * numChannels, 0);
+			next.assign((size_t)n * numChannels, 0);
+		}
+
+		//steady state of a unit input, solving (I - Ad) x = Bd
+		steady.clear();
+		if (n > 0)
+		{
+			std::vector<double> M((size_t)n * n);
+			std::vector<double> x(discrete.B);
+			for (unsigned int i = 0; i < n; i++)
+			{
+				for (unsigned int j = 0; j < n; j++) {
+					M[i * n + j] = (i == j ? 1.0 : 0.0) - discrete.A[i * n + j];
+				}
+			}
+			if (solve(M, n, x, 1)) {
+				steady.assign(x.begin(), x.end());
+			}
+		}
+	}
+
+	bool discretize(double dt, double prewarpHz)
+	{
+		if (!(dt > 0.0))
+		{
+			//TODO: WARNING message for discretizing with a time delta that is not positive
+			return false;
+		}
+
+		double period = dt;
+		if (prewarpHz > 0.0)
+		{
+			double w = 2.0 * PI * prewarpHz;
+			if (w * dt >= PI)
+			{
+				//TODO: WARNING message for prewarping at or above the Nyquist frequency
+				return false;
+			}
+			period = 2.0 * std::tan(w * dt / 2.0) / w;
+		}
+
+		unsigned int n = continuous.order;
+		System sys;
+		sys.order = n;
+		sys.D = continuous.D;
+		if (n > 0)
+		{
+			//M = I - A T/2, Ad = M^-1 (I + A T/2), Bd = M^-1 B T
+			std::vector<double> M((size_t)n * n);
+			std::vector<double> R((size_t)n * (n + 1));
+			for (unsigned int i = 0; i < n; i++)
+			{
+				for (unsigned int j = 0; j < n; j++)
+				{
+					double a = continuous.A[i * n + j] * period / 2.0;
+					M[i * n + j] = (i == j ? 1.0 : 0.0) - a;
+					R[i * (n + 1) + j] = (i == j ? 1.0 : 0.0) + a;
+				}
+				R[i * (n + 1) + n] = continuous.B[i] * period;
+			}
+			if (!solve(M, n, R, n + 1))
+			{
+				//TODO: WARNING message for a design without a Tustin equivalent (pole at s = 2 / dt)
+				return false;
+			}
+
+			//Cd = C M^-1, solving M^T Cd^T = C^T
+			std::vector<double> MT((size_t)n * n);
+			for (unsigned int i = 0; i < n; i++)
+			{
+				for (unsigned int j = 0; j < n; j++) {
+					MT[i * n + j] = M[j * n + i];
+				}
+			}
+			std::vector<double> Ct(continuous.C);
+			solve(MT, n, Ct, 1);
+
+			sys.A.resize((size_t)n * n);
+			sys.B.resize(n);
+			for (unsigned int i = 0; i < n; i++)
+			{
+				for (unsigned int j = 0; j < n; j++) {
+					sys.A[i * n + j] = R[i * (n + 1) + j];
+				}
+				sys.B[i] = R[i * (n + 1) + n];
+			}
+			sys.C = Ct;
+
+			//Dd = D + Cd B T/2
+			for (unsigned int i = 0; i < n; i++) {
+				sys.D += Ct[i] * continuous.B[i] * period / 2.0;
+			}
+		}
+
+		discrete = sys;
+		apply();
+		return true;
+	}
+
+	void filter(const T* in, T* out)
+	{
+		unsigned int n = discrete.order;
+		unsigned int channels = numChannels;
+
+		//x = Ad x + Bd u, into next so the old state and the input stay for the output
+		for (unsigned int i = 0; i < n; i++)
+		{
+			T* row = &next[(size_t)i * channels];
+			scale(row, in, Bd[i], channels);
+			for (unsigned int j = 0; j < n; j++)
+			{
+				T a = Ad[(size_t)i * n + j];
+				if (a != 0) {
+					accumulate(row, &state[(size_t)j * channels], a, channels);
+				}
+			}
+		}
+
+		//y = Cd x + Dd u, the last read of the input, which out may overwrite in place
+		if (out == in) {
+			scale(out, Dd, channels);
+		}
+		else {
+			scale(out, in, Dd, channels);
+		}
+		for (unsigned int j = 0; j < n; j++) {
+			accumulate(out, &state[(size_t)j * channels], Cd[j], channels);
+		}
+		state.swap(next);
+	}
+
+	void init(const T* in)
+	{
+		unsigned int n = discrete.order;
+		for (unsigned int i = 0; i < n; i++)
+		{
+			T gain = steady.empty() ? (T)0 : (T)steady[i];
+			scale(&state[(size_t)i * numChannels], in, gain, numChannels);
+		}
+	}
+
+	unsigned int numChannels = 1;
+
+	System continuous;		//design
+	System discrete;		//Tustin equivalent of the design
+
+	//discrete system and state in the filter's precision
+	std::vector<T> Ad, Bd, Cd;
+	T Dd = 1;
+	std::vector<T> state;	//order rows of numChannels
+	std::vector<T> next;
+	std::vector<double> steady;	//steady state of a unit input, empty if there is none
+};
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+StateSpaceFilter<T>::StateSpaceFilter(unsigned int numberChannels)
+{
+	mImpl = new StateSpaceFilter::Impl(numberChannels);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+StateSpaceFilter<T>::StateSpaceFilter(const StateSpaceFilter<T>& filter)
+{
+	mImpl = new StateSpaceFilter::Impl(*filter.mImpl);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+StateSpaceFilter<T>& StateSpaceFilter<T>::operator=(const StateSpaceFilter<T>& filter)
+{
+	if (this != &filter)
+	{
+		if (mImpl) {
+			*mImpl = *filter.mImpl;
+		}
+		else {
+			mImpl = new StateSpaceFilter::Impl(*filter.mImpl);
+		}
+	}
+	return *this;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+StateSpaceFilter<T>::StateSpaceFilter(StateSpaceFilter<T>&& filter) noexcept
+{
+	//the moved filter is left a new one-channel filter, usable like any other
+	mImpl = filter.mImpl;
+	filter.mImpl = new StateSpaceFilter::Impl(1);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+StateSpaceFilter<T>& StateSpaceFilter<T>::operator=(StateSpaceFilter<T>&& filter) noexcept
+{
+	std::swap(mImpl, filter.mImpl);
+	return *this;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+StateSpaceFilter<T>::~StateSpaceFilter()
+{
+	delete mImpl;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+bool StateSpaceFilter<T>::setTransferFunction(const std::vector<double>& numerator, const std::vector<double>& denominator)
+{
+	System sys;
+	if (!realize(numerator, denominator, sys))
+	{
+		//TODO: WARNING message for a transfer function that is not proper
+		return false;
+	}
+	mImpl->continuous = sys;
+	return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+bool StateSpaceFilter<T>::appendTransferFunction(const std::vector<double>& numerator, const std::vector<double>& denominator)
+{
+	System sys;
+	if (!realize(numerator, denominator, sys))
+	{
+		//TODO: WARNING message for a transfer function that is not proper
+		return false;
+	}
+	mImpl->continuous = series(mImpl->continuous, sys);
+	return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+bool StateSpaceFilter<T>::setStateSpace(unsigned int order, const double* A, const double* B, const double* C, double D)
+{
+	System sys;
+	sys.order = order;
+	sys.A.assign(A, A + (size_t)order * order);
+	sys.B.assign(B, B + order);
+	sys.C.assign(C, C + order);
+	sys.D = D;
+	mImpl->continuous = sys;
+	return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+bool StateSpaceFilter<T>::discretize(double dt, double prewarpHz)
+{
+	return mImpl->discretize(dt, prewarpHz);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void StateSpaceFilter<T>::filter(const T* in, T* out)
+{
+	mImpl->filter(in, out);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void StateSpaceFilter<T>::filter(const T* in, T* out, size_t numSamples)
+{
+	size_t channels = mImpl->numChannels;
+	for (size_t s = 0; s < numSamples; s++) {
+		mImpl->filter(in + s * channels, out + s * channels);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T StateSpaceFilter<T>::filter(T in)
+{
+	if (mImpl->numChannels != 1)
+	{
+		//TODO: WARNING message for filtering a single sample with a multi-channel filter
+		return in;
+	}
+	T out;
+	mImpl->filter(&in, &out);
+	return out;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void StateSpaceFilter<T>::reset()
+{
+	std::fill(mImpl->state.begin(), mImpl->state.end(), (T)0);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void StateSpaceFilter<T>::init(const T* in)
+{
+	mImpl->init(in);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+unsigned int StateSpaceFilter<T>::getOrder() const
+{
+	return mImpl->discrete.order;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+unsigned int StateSpaceFilter<T>::getNumChannels() const
+{
+	return mImpl->numChannels;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void StateSpaceFilter<T>::getDiscrete(std::vector<double>& Ad, std::vector<double>& Bd, std::vector<double>& Cd, double& Dd) const
+{
+	Ad = mImpl->discrete.A;
+	Bd = mImpl->discrete.B;
+	Cd = mImpl->discrete.C;
+	Dd = mImpl->discrete.D;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+// Declare float and double types so the compiler can build these templates
+template class MATH_API StateSpaceFilter<float>;
+template class MATH_API StateSpaceFilter<double>;
+
+} //namespace otMath
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
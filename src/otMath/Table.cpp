@@ -14,286 +14,1812 @@ Table class implementation.
 NOTES
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
-
+Table data is kept in flat storage: the breakpoints of each axis live in their
+own vectors and all table values live in one aligned, contiguous block.  A
+table is made of one or more 2D "layers" (a 1D table is a single layer with one
+column, a 3D table is one layer per 3rd dimension breakpoint).  Each layer
+stores its values row-major at an offset into the value block, so a lookup
+touches only the breakpoint vectors and the cells it blends.
+
+Lookups never write to the table.  The interval search hint lives in a
+Table::Cursor owned by the caller, and splines are not kept as Spline objects
+(which cache their last interval internally).  The table is finalized as soon
+as its last value is streamed in: the Splines library supplies the node
+derivatives, which are converted to packed polynomial coefficients per
+interval (per cell for 2D layers) and evaluated with Horner's rule.  Tables
+never completely filled are finalized by their first lookup, under a lock.
+
+Axes whose breakpoints are evenly spaced (within UNIFORM_TOLERANCE of the
+spacing) find the interval of a key directly from (key - origin) * invSpacing,
+so large tables cost the same as small ones even when keys jump around.  Other
+axes hunt from the cursor, or bisect when the cursor is not set.
+
+The data block (TableData) is shared between copies of a table through a
+reference count, so copying a finalized table is O(1) and never rebuilds its
+splines.  A table detaches its own copy of the block before modifying it
+(streaming values or changing the interpolation method), copy-on-write.
+
+A table can be compiled into a linear table on evenly spaced breakpoints, for
+spline accuracy at the cost of a linear lookup.  Each axis is refined by halving
+its spacing until the samples blended linearly stay within the tolerance of the
+source: the deviation is measured at the quarter points of each 1D interval, at
+the center and edge midpoints of each 2D cell, so it is a measurement and not a
+bound, though a tight one for smooth splines.
+
+Tables can be written to and read from a binary table file laid out like the
+flat storage, with the packed spline polynomials included.  Reading maps the
+file and views its values and polynomials in place; a table read that way
+takes its own copy of the data before being modified.
 
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 INCLUDES
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
 #include "Table.h"
+#include "TableKernels.h"
+#include "TableStorage.h"
+#include "MappedFile.h"
 #include "Splines.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 CLASS IMPLEMENTATION
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
-namespace otMath {
+namespace otMath {
+
+//One 2D slice of table data.  1D and 2D tables have a single layer, 3D tables have one per table breakpoint.
+template <typename T>
+struct TableLayer
+{
+	//Number of rows of data
+	unsigned int numRows = 0;
+	//Number of columns of data (1 for 1D layers)
+	unsigned int numColumns = 0;
+	//Offset of the first row breakpoint in the row breakpoint vector
+	size_t rowOffset = 0;
+	//Offset of the first column breakpoint in the column breakpoint vector (2D layers only)
+	size_t columnOffset = 0;
+	//Offset of the first value in the value block, values are stored row-major
+	size_t valueOffset = 0;
+	//Interpolation method of the layer
+	InterpMethod interpMethod = InterpMethod::INTERP_LINEAR;
+	//Spacing of the row and column breakpoints
+	AxisSpacing<T> rowSpacing, columnSpacing;
+};
+
+//Gives access to the node derivatives of a bi-quintic spline that the Splines library keeps protected
+class BiQuinticSplineNodes : public Splines::BiQuinticSpline
+{
+public:
+	const std::vector<Splines::valueType>& dxxyNodes() const { return DXXY; }
+	const std::vector<Splines::valueType>& dxyyNodes() const { return DXYY; }
+	const std::vector<Splines::valueType>& dxxyyNodes() const { return DXXYY; }
+};
+
+//Packed spline polynomials of one layer.  The Splines library only supplies the node derivatives
+//when the table is finalized; they are converted to one polynomial per interval (1D layers) or per
+//cell (2D layers) in the local coordinates of the interval, evaluated with Horner's rule.
+template <typename T>
+struct TableSplines
+{
+	//Coefficients per axis of each polynomial (4 = cubic, 6 = quintic, 0 = no splines)
+	unsigned int order = 0;
+	//order coefficients per interval (1D), order*order per cell (2D, cells stored row-major).
+	//Coefficient [k] (1D) or [k*order + l] (2D) multiplies t^k (times u^l) with t = x - x[i], u = y - y[j].
+	AlignedArray<T> coefficients;
+
+	void clear()
+	{
+		order = 0;
+		coefficients.release();
+	}
+
+	void build1D(const std::vector<Splines::valueType>& x, const std::vector<Splines::valueType>& y, InterpMethod method)
+	{
+		clear();
+		size_t n = x.size();
+		std::vector<Splines::valueType> dx(n), dxx;
+
+		std::unique_ptr<Splines::CubicSplineBase> cubic;
+		switch (method)
+		{
+		case InterpMethod::INTERP_PCHIP: cubic.reset(new Splines::PchipSpline()); break;
+		case InterpMethod::INTERP_CUBIC: cubic.reset(new Splines::CubicSpline()); break;
+		case InterpMethod::INTERP_AKIMA: cubic.reset(new Splines::AkimaSpline()); break;
+		case InterpMethod::INTERP_BESSEL: cubic.reset(new Splines::BesselSpline()); break;
+		case InterpMethod::INTERP_HERMITE: cubic.reset(new Splines::HermiteSpline()); break;
+		case InterpMethod::INTERP_QUINTIC:
+		{
+			Splines::QuinticSpline quintic;
+			quintic.build(x, y);
+			dxx.resize(n);
+			for (Splines::sizeType i = 0; i < (Splines::sizeType)n; i++) {
+				dx[i] = quintic.ypNode(i);
+				dxx[i] = quintic.yppNode(i);
+			}
+			order = 6;
+			break;
+		}
+		default:
+			//TODO: WARNING message for using unsupported Interpolation Method
+			return;
+		}
+
+		if (cubic)
+		{
+			cubic->build(x, y);
+			for (Splines::sizeType i = 0; i < (Splines::sizeType)n; i++) {
+				dx[i] = cubic->ypNode(i);
+			}
+			order = 4;
+		}
+
+		coefficients.allocate((n - 1) * order);
+		Splines::valueType basis[6][6];
+		for (size_t i = 0; i + 1 < n; i++)
+		{
+			Splines::valueType node[6] = { y[i], y[i + 1], dx[i], dx[i + 1], 0, 0 };
+			if (order == 6) {
+				node[4] = dxx[i];
+				node[5] = dxx[i + 1];
+			}
+
+			hermiteMonomials(order, x[i + 1] - x[i], basis);
+			T* c = coefficients.data() + i * order;
+			for (unsigned int k = 0; k < order; k++)
+			{
+				Splines::valueType sum = 0;
+				for (unsigned int j = 0; j < order; j++) {
+					sum += basis[j][k] * node[j];
+				}
+				c[k] = (T)sum;
+			}
+		}
+	}
+
+	void build2D(const std::vector<Splines::valueType>& x, const std::vector<Splines::valueType>& y,
+		const std::vector<Splines::valueType>& z, InterpMethod method)
+	{
+		clear();
+		Splines::sizeType nx = (Splines::sizeType)x.size();
+		Splines::sizeType ny = (Splines::sizeType)y.size();
+		size_t count = (size_t)nx * ny;
+		std::vector<Splines::valueType> dx(count), dy(count), dxy(count);
+		std::vector<Splines::valueType> dxx, dyy, dxxy, dxyy, dxxyy;
+
+		if (method == InterpMethod::INTERP_QUINTIC)
+		{
+			BiQuinticSplineNodes quintic;
+			quintic.build(x, y, z);
+			dxx.resize(count);
+			dyy.resize(count);
+			for (Splines::sizeType i = 0; i < nx; i++) {
+				for (Splines::sizeType j = 0; j < ny; j++) {
+					size_t k = (size_t)i * ny + j;
+					dx[k] = quintic.DxNode(i, j);
+					dxx[k] = quintic.DxxNode(i, j);
+					dy[k] = quintic.DyNode(i, j);
+					dyy[k] = quintic.DyyNode(i, j);
+					dxy[k] = quintic.DxyNode(i, j);
+				}
+			}
+			dxxy = quintic.dxxyNodes();
+			dxyy = quintic.dxyyNodes();
+			dxxyy = quintic.dxxyyNodes();
+			order = 6;
+		}
+		else
+		{
+			std::unique_ptr<Splines::BiCubicSplineBase> cubic;
+			switch (method)
+			{
+			case InterpMethod::INTERP_CUBIC: cubic.reset(new Splines::BiCubicSpline()); break;
+			case InterpMethod::INTERP_AKIMA: cubic.reset(new Splines::Akima2Dspline()); break;
+			default:
+				//TODO: WARNING message for using unsupported Interpolation Method
+				return;
+			}
+
+			cubic->build(x, y, z);
+			for (Splines::sizeType i = 0; i < nx; i++) {
+				for (Splines::sizeType j = 0; j < ny; j++) {
+					size_t k = (size_t)i * ny + j;
+					dx[k] = cubic->DxNode(i, j);
+					dy[k] = cubic->DyNode(i, j);
+					dxy[k] = cubic->DxyNode(i, j);
+				}
+			}
+			order = 4;
+		}
+
+		size_t cellSize = (size_t)order * order;
+		coefficients.allocate((size_t)(nx - 1) * (ny - 1) * cellSize);
+		Splines::valueType bx[6][6], by[6][6], M[6][6], BM[6][6];
+		for (Splines::sizeType i = 0; i + 1 < nx; i++)
+		{
+			hermiteMonomials(order, x[i + 1] - x[i], bx);
+			for (Splines::sizeType j = 0; j + 1 < ny; j++)
+			{
+				hermiteMonomials(order, y[j + 1] - y[j], by);
+
+				//Node data of the cell corners, laid out like the Splines library bilinear3/bilinear5 forms
+				size_t i00 = (size_t)i * ny + j;
+				size_t i01 = i00 + 1;
+				size_t i10 = i00 + ny;
+				size_t i11 = i10 + 1;
+				size_t corners[2][2] = { { i00, i01 }, { i10, i11 } };
+				const std::vector<Splines::valueType>* crossData[3][3] = {
+					{ &z, &dy, &dyy },
+					{ &dx, &dxy, &dxyy },
+					{ &dxx, &dxxy, &dxxyy } };
+				for (unsigned int a = 0; a < order; a++) {
+					for (unsigned int b = 0; b < order; b++) {
+						M[a][b] = (*crossData[a / 2][b / 2])[corners[a % 2][b % 2]];
+					}
+				}
+
+				//C = bx^T * M * by
+				for (unsigned int k = 0; k < order; k++) {
+					for (unsigned int b = 0; b < order; b++) {
+						Splines::valueType sum = 0;
+						for (unsigned int a = 0; a < order; a++) {
+							sum += bx[a][k] * M[a][b];
+						}
+						BM[k][b] = sum;
+					}
+				}
+				T* c = coefficients.data() + ((size_t)i * (ny - 1) + j) * cellSize;
+				for (unsigned int k = 0; k < order; k++) {
+					for (unsigned int l = 0; l < order; l++) {
+						Splines::valueType sum = 0;
+						for (unsigned int b = 0; b < order; b++) {
+							sum += BM[k][b] * by[b][l];
+						}
+						c[k * order + l] = (T)sum;
+					}
+				}
+			}
+		}
+	}
+
+	//Evaluate the polynomial of interval i at t = x - x[i]
+	T evaluate(unsigned int i, T t) const
+	{
+		const T* c = coefficients.data() + (size_t)i * order;
+		T result = c[order - 1];
+		for (int k = (int)order - 2; k >= 0; k--) {
+			result = result * t + c[k];
+		}
+		return result;
+	}
+
+	//Evaluate the polynomial of cell (i, j) at t = x - x[i], u = y - y[j], numCells cells per row
+	T evaluate(unsigned int i, unsigned int j, unsigned int numCells, T t, T u) const
+	{
+		const T* c = coefficients.data() + ((size_t)i * numCells + j) * order * order;
+		T result = 0;
+		for (int k = (int)order - 1; k >= 0; k--)
+		{
+			const T* row = c + k * order;
+			T rowVal = row[order - 1];
+			for (int l = (int)order - 2; l >= 0; l--) {
+				rowVal = rowVal * u + row[l];
+			}
+			result = result * t + rowVal;
+		}
+		return result;
+	}
+
+	//Evaluate the polynomial of interval i and its derivative dt at t = x - x[i]
+	T evaluate(unsigned int i, T t, T& dt) const
+	{
+		const T* c = coefficients.data() + (size_t)i * order;
+		T result = c[order - 1];
+		dt = (T)(order - 1) * c[order - 1];
+		for (int k = (int)order - 2; k >= 0; k--)
+		{
+			result = result * t + c[k];
+			if (k >= 1) {
+				dt = dt * t + (T)k * c[k];
+			}
+		}
+		return result;
+	}
+
+	//Evaluate the polynomial of cell (i, j) and its partial derivatives dt, du at t = x - x[i], u = y - y[j]
+	T evaluate(unsigned int i, unsigned int j, unsigned int numCells, T t, T u, T& dt, T& du) const
+	{
+		const T* c = coefficients.data() + ((size_t)i * numCells + j) * order * order;
+		T result = 0;
+		dt = du = 0;
+		for (int k = (int)order - 1; k >= 0; k--)
+		{
+			const T* row = c + k * order;
+			T rowVal = row[order - 1];
+			T rowDu = (T)(order - 1) * row[order - 1];
+			for (int l = (int)order - 2; l >= 0; l--)
+			{
+				rowVal = rowVal * u + row[l];
+				if (l >= 1) {
+					rowDu = rowDu * u + (T)l * row[l];
+				}
+			}
+			if (k >= 1) {
+				dt = dt * t + (T)k * rowVal;
+			}
+			du = du * t + rowDu;
+			result = result * t + rowVal;
+		}
+		return result;
+	}
+};
+
+//Cells of a linear or nearest neighbor lookup, as offsets into the value block, and the
+//factors they are blended with
+template <typename T>
+struct CellBlend
+{
+	size_t c00, c01, c10, c11;
+	T rowFac, colFac;
+};
+
+//Number of keys located and blended at a time by the batched lookups
+static const size_t BATCH_BLOCK = 256;
+
+//Binary table file: a header, one record per layer, then the breakpoint, value and spline
+//coefficient sections.  Every section starts at a multiple of TABLE_FILE_ALIGNMENT bytes, so
+//the sections of a mapped file (which starts on a page boundary) can be used in place.
+static const char TABLE_FILE_MAGIC[4] = { 'O', 'T', 'T', 'B' };
+static const uint32_t TABLE_FILE_VERSION = 1;
+//Written in the byte order of the machine writing the file, a mismatch when reading it back
+//means the file comes from a machine of the other endianness
+static const uint32_t TABLE_FILE_BYTE_ORDER = 0x01020304;
+static const uint64_t TABLE_FILE_ALIGNMENT = 64;
+
+enum TableFileSection
+{
+	SECTION_ROW_BREAKPOINTS = 0,
+	SECTION_COLUMN_BREAKPOINTS,
+	SECTION_TABLE_BREAKPOINTS,
+	SECTION_VALUES,
+	SECTION_COEFFICIENTS,
+	NUM_TABLE_FILE_SECTIONS
+};
+
+struct TableFileHeader
+{
+	char magic[4];
+	uint32_t byteOrder;
+	uint32_t version;
+	//Size of one breakpoint or value in bytes (4 = float, 8 = double)
+	uint32_t valueSize;
+	uint32_t dimensions;
+	uint32_t numRows;
+	uint32_t numColumns;
+	uint32_t numTables;
+	uint32_t interpMethod;
+	uint32_t numLayers;
+	//Byte offset of the layer records
+	uint64_t layerOffset;
+	//Byte offset and number of elements of each section
+	uint64_t sectionOffset[NUM_TABLE_FILE_SECTIONS];
+	uint64_t sectionCount[NUM_TABLE_FILE_SECTIONS];
+};
+
+struct TableFileLayer
+{
+	uint32_t numRows;
+	uint32_t numColumns;
+	uint32_t interpMethod;
+	//Order of the precomputed spline polynomials, 0 when the file has none for the layer
+	uint32_t splineOrder;
+	//Element offsets into the row breakpoint, column breakpoint and value sections
+	uint64_t rowOffset;
+	uint64_t columnOffset;
+	uint64_t valueOffset;
+	//Element offset into the coefficient section and number of coefficients of the layer
+	uint64_t coefficientOffset;
+	uint64_t coefficientCount;
+};
+
+static_assert(sizeof(TableFileHeader) == 128 && sizeof(TableFileLayer) == 56, "Table file records must not be padded");
+
+//Round a file offset up to the section alignment
+inline uint64_t alignFileOffset(uint64_t offset)
+{
+	return (offset + TABLE_FILE_ALIGNMENT - 1) / TABLE_FILE_ALIGNMENT * TABLE_FILE_ALIGNMENT;
+}
+
+//Write zeros up to the given file offset
+inline void padFile(std::ostream& file, uint64_t& position, uint64_t offset)
+{
+	static const char zeros[TABLE_FILE_ALIGNMENT] = {};
+	while (position < offset)
+	{
+		uint64_t n = std::min<uint64_t>(offset - position, TABLE_FILE_ALIGNMENT);
+		file.write(zeros, (std::streamsize)n);
+		position += n;
+	}
+}
+
+//Data of a table, shared between copies of the table.  A table that is changed while its data is
+//shared first takes its own copy (copy-on-write), so copies are cheap and never rebuild splines.
+template <typename T>
+class TableData
+{
+public:
+	typedef typename Table<T>::Cursor Cursor;
+	typedef typename Table<T>::Prelookup Prelookup;
+	typedef otMath::TableLayer<T> TableLayer;
+	typedef otMath::AxisSpacing<T> AxisSpacing;
+	typedef otMath::CellBlend<T> CellBlend;
+	typedef otMath::TableSplines<T> TableSplines;
+
+	//Located cells of a block of batched lookups, laid out for the blend kernels
+	struct BatchCells
+	{
+		int c00[BATCH_BLOCK], c01[BATCH_BLOCK], c10[BATCH_BLOCK], c11[BATCH_BLOCK];
+		T rowFac[BATCH_BLOCK], colFac[BATCH_BLOCK];
+
+		void set(size_t k, const TableData& impl, const TableLayer& layer, T rowVal, T colVal, Cursor& cursor, bool extrapolate)
+		{
+			CellBlend blend;
+			impl.locateLayer(layer, rowVal, colVal, cursor, extrapolate, blend);
+			c00[k] = (int)blend.c00;
+			c01[k] = (int)blend.c01;
+			c10[k] = (int)blend.c10;
+			c11[k] = (int)blend.c11;
+			rowFac[k] = blend.rowFac;
+			colFac[k] = blend.colFac;
+		}
+
+		void blend(const T* values, T* out, size_t n) const
+		{
+			TableKernels::blend2D(values, c00, c01, c10, c11, rowFac, colFac, out, n);
+		}
+	};
+
+	//Number of dimensions of data
+	unsigned int dimensions = 0;
+	//Number of Rows of data
+	unsigned int numRows = 0;
+	//Number of Columns of data (1 for 1D tables)
+	unsigned int numColumns = 0;
+	//Number of tables of 2D data
+	unsigned int numTables = 0;
+	//Row counter for data insertion
+	unsigned int rowInsertCtr = 0;
+	//Column counter for data insertion
+	unsigned int columnInsertCtr = 0;
+	//Interpolation method
+	InterpMethod interpMethod = InterpMethod::INTERP_LINEAR;
+	//Have splines been built and axis spacings detected for the current data?
+	std::atomic<bool> prepared{ false };
+	//Serializes finalizing the table against lookups that find it not finalized yet
+	mutable std::mutex prepareMutex;
+
+	//Row breakpoints of every layer, stored back to back
+	std::vector<T> rowBreakpoints;
+	//Column breakpoints of every layer, stored back to back (empty for 1D tables)
+	std::vector<T> columnBreakpoints;
+	//Breakpoints of the 3rd dimension (3D tables only)
+	std::vector<T> tableBreakpoints;
+	//Spacing of the 3rd dimension breakpoints
+	AxisSpacing tableSpacing;
+	//Contiguous block of the values of every layer
+	AlignedArray<T> values;
+	//2D slices of the table data (constitutes the 3rd dimension in 3D tables)
+	std::vector<TableLayer> layers;
+	//Splines of each layer
+	std::vector<TableSplines> splines;
+	//Table file the values and spline coefficients are viewed from, when read from a binary file
+	std::shared_ptr<MappedFile> mappedFile;
+
+	//Allocate the flat storage for a single 1D or 2D layer
+	void allocateStorage()
+	{
+		TableLayer layer;
+		layer.numRows = numRows;
+		layer.numColumns = numColumns;
+		layer.interpMethod = interpMethod;
+
+		layers.assign(1, layer);
+		rowBreakpoints.assign(numRows, (T)0);
+		columnBreakpoints.assign(dimensions == 2 ? numColumns : 0, (T)0);
+		tableBreakpoints.clear();
+		values.allocate((size_t)numRows * numColumns);
+		splines.assign(1, TableSplines());
+	}
+
+	//Append the layers of a 1D or 2D table as one 2D slice of a 3D table
+	void appendLayer(const TableData& table)
+	{
+		if (table.layers.empty())
+			return;
+
+		const TableLayer& source = table.layers[0];
+		TableLayer layer = source;
+		layer.rowOffset = rowBreakpoints.size();
+		layer.columnOffset = columnBreakpoints.size();
+		layer.valueOffset = 0;
+		for (const TableLayer& l : layers) {
+			layer.valueOffset += (size_t)l.numRows * l.numColumns;
+		}
+		layers.push_back(layer);
+
+		rowBreakpoints.insert(rowBreakpoints.end(), table.rowBreakpoints.begin() + source.rowOffset,
+			table.rowBreakpoints.begin() + source.rowOffset + source.numRows);
+		if (table.dimensions == 2) {
+			columnBreakpoints.insert(columnBreakpoints.end(), table.columnBreakpoints.begin() + source.columnOffset,
+				table.columnBreakpoints.begin() + source.columnOffset + source.numColumns);
+		}
+	}
+
+	//Copy the values of the given tables into one contiguous block, after all layers were appended,
+	//and the splines of each layer: copied from the tables already finalized, built for the others
+	void gatherLayerValues(const std::vector<const TableData*>& tables)
+	{
+		size_t count = 0;
+		for (const TableLayer& l : layers) {
+			count += (size_t)l.numRows * l.numColumns;
+		}
+		values.allocate(count);
+		for (size_t i = 0; i < layers.size(); i++) {
+			const TableLayer& source = tables[i]->layers[0];
+			size_t layerCount = (size_t)source.numRows * source.numColumns;
+			if (layerCount > 0) {
+				memcpy(values.data() + layers[i].valueOffset, tables[i]->values.data() + source.valueOffset, layerCount * sizeof(T));
+			}
+		}
+		splines.assign(layers.size(), TableSplines());
+		for (size_t i = 0; i < layers.size(); i++)
+		{
+			if (tables[i]->prepared.load(std::memory_order_acquire)) {
+				splines[i] = tables[i]->splines[0];
+			}
+			else {
+				buildLayerSplines(layers[i], splines[i]);
+			}
+		}
+	}
+
+	//Number of dimensions of a single layer
+	unsigned int layerDimensions(const TableLayer& layer) const
+	{
+		return layer.numColumns > 1 ? 2 : 1;
+	}
+
+	void buildLayerSplines(const TableLayer& layer, TableSplines& layerSplines)
+	{
+		layerSplines.clear();
+
+		if (layer.interpMethod <= InterpMethod::INTERP_NEAREST)
+			return;
+
+		const T* x = &rowBreakpoints[layer.rowOffset];
+		const T* z = values.data() + layer.valueOffset;
+
+		if (layerDimensions(layer) == 1)
+		{
+			//1D table
+			std::vector<Splines::valueType> xVals(x, x + layer.numRows);
+			std::vector<Splines::valueType> yVals(z, z + layer.numRows);
+			layerSplines.build1D(xVals, yVals, layer.interpMethod);
+		}
+		else
+		{
+			//2D table
+			const T* y = &columnBreakpoints[layer.columnOffset];
+			std::vector<Splines::valueType> xVals(x, x + layer.numRows);
+			std::vector<Splines::valueType> yVals(y, y + layer.numColumns);
+			std::vector<Splines::valueType> zVals(z, z + (size_t)layer.numRows * layer.numColumns);
+			layerSplines.build2D(xVals, yVals, zVals, layer.interpMethod);
+		}
+	}
+
+	void buildSplines()
+	{
+		if (dimensions < 3)
+		{
+			if (interpMethod > InterpMethod::INTERP_NEAREST)
+			{
+				if (checkInterpolationMethod(interpMethod))
+				{
+					layers[0].interpMethod = interpMethod;
+					buildLayerSplines(layers[0], splines[0]);
+				}
+				else {
+					//TODO: WARNING message for using unsupported Interpolation Method
+					interpMethod = InterpMethod::INTERP_LINEAR;
+					layers[0].interpMethod = interpMethod;
+				}
+			}
+		}
+		else
+		{
+			//3D table, no splines on the 3rd dimension, but each layer can have its own
+			for (size_t i = 0; i < layers.size(); i++) {
+				buildLayerSplines(layers[i], splines[i]);
+			}
+		}
+	}
+
+	//Check which breakpoint axes are evenly spaced
+	void detectSpacing()
+	{
+		for (size_t i = 0; i < layers.size(); i++)
+		{
+			TableLayer& layer = layers[i];
+			layer.rowSpacing.detect(&rowBreakpoints[layer.rowOffset], layer.numRows);
+			if (layerDimensions(layer) == 2) {
+				layer.columnSpacing.detect(&columnBreakpoints[layer.columnOffset], layer.numColumns);
+			}
+			else {
+				layer.columnSpacing = AxisSpacing();
+			}
+		}
+		tableSpacing.detect(tableBreakpoints.data(), (unsigned int)tableBreakpoints.size());
+	}
+
+	//Has all the table data been streamed in?
+	bool dataComplete() const
+	{
+		return dimensions == 3 || rowInsertCtr > numRows;
+	}
+
+	//Build the spline polynomials of every layer and detect the axis spacings.  Done as soon
+	//as the table data is complete (or its interpolation method changes), so lookups never
+	//pay for it.
+	void finalize()
+	{
+		std::lock_guard<std::mutex> lock(prepareMutex);
+		if (!prepared.load(std::memory_order_relaxed))
+		{
+			buildSplines();
+			detectSpacing();
+			prepared.store(true, std::memory_order_release);
+		}
+	}
+
+	//Tables whose data was never completely streamed in are finalized by their first lookup.
+	//Several threads may do that at once, finalize() serializes them.
+	void prepare()
+	{
+		if (!prepared.load(std::memory_order_acquire)) {
+			finalize();
+		}
+	}
+
+	//Find the cells to blend for a linear or nearest neighbor lookup of a 1D layer (at least 2 rows).
+	//The cells are offsets into the value block, blended as fac*(values[hi] - values[lo]) + values[lo].
+	void locateLayer(const TableLayer& layer, T val, Cursor& cursor, bool extrapolate, size_t& lo, size_t& hi, T& fac) const
+	{
+		const T* x = &rowBreakpoints[layer.rowOffset];
+		unsigned int n = layer.numRows;
+		fac = 0;
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (layer.interpMethod == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+		//check for extrapolation
+		if (!extrapolate)
+		{
+			if (val <= x[0])
+			{
+				cursor.row = 0;
+				lo = hi = layer.valueOffset;
+				return;
+			}
+			else if (val >= x[n - 1])
+			{
+				cursor.row = n - 2;
+				lo = hi = layer.valueOffset + n - 1;
+				return;
+			}
+		}
+
+		unsigned int i = findInterval(x, n, val, cursor.row, layer.rowSpacing);
+
+		T rng = x[i + 1] - x[i];
+		if (rng != 0.0)
+		{
+			fac = (val - x[i]) / rng;
+			if (!extrapolate) {
+				fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+			}
+		}
+		else {
+			fac = (T)1.0;
+		}
+
+		lo = layer.valueOffset + i;
+		hi = lo + 1;
+
+		if (layer.interpMethod == InterpMethod::INTERP_NEAREST)
+		{
+			lo = hi = fac < 0.5 ? lo : hi;
+			fac = 0;
+		}
+	}
+
+	//Find the cells to blend for a linear or nearest neighbor lookup of a 2D layer (at least 2 rows).
+	//1D layers blend along the rows only (c00 == c01, c10 == c11 and colFac = 0).
+	void locateLayer(const TableLayer& layer, T rowVal, T colVal, Cursor& cursor, bool extrapolate, CellBlend& blend) const
+	{
+		if (layerDimensions(layer) == 1)
+		{
+			size_t lo, hi;
+			locateLayer(layer, rowVal, cursor, extrapolate, lo, hi, blend.rowFac);
+			blend.c00 = blend.c01 = lo;
+			blend.c10 = blend.c11 = hi;
+			blend.colFac = 0;
+			return;
+		}
+
+		const T* x = &rowBreakpoints[layer.rowOffset];
+		const T* y = &columnBreakpoints[layer.columnOffset];
+		unsigned int nr = layer.numRows;
+		unsigned int nc = layer.numColumns;
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (layer.interpMethod == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+
+		unsigned int r = findInterval(x, nr, rowVal, cursor.row, layer.rowSpacing);
+		unsigned int c = findInterval(y, nc, colVal, cursor.column, layer.columnSpacing);
+
+		T rFac = (rowVal - x[r]) / (x[r + 1] - x[r]);
+		T cFac = (colVal - y[c]) / (y[c + 1] - y[c]);
+
+		if (!extrapolate)
+		{
+			rFac = rFac > 1.0 ? (T)1.0 : rFac < 0.0 ? (T)0.0 : rFac;
+			cFac = cFac > 1.0 ? (T)1.0 : cFac < 0.0 ? (T)0.0 : cFac;
+		}
+
+		size_t lowerRow = layer.valueOffset + (size_t)r * nc + c;
+		size_t upperRow = lowerRow + nc;
+
+		if (layer.interpMethod == InterpMethod::INTERP_NEAREST)
+		{
+			size_t nearest = (rFac < 0.5 ? lowerRow : upperRow) + (cFac < 0.5 ? 0 : 1);
+			blend.c00 = blend.c01 = blend.c10 = blend.c11 = nearest;
+			blend.rowFac = blend.colFac = 0;
+			return;
+		}
+
+		blend.c00 = lowerRow;
+		blend.c01 = lowerRow + 1;
+		blend.c10 = upperRow;
+		blend.c11 = upperRow + 1;
+		blend.rowFac = rFac;
+		blend.colFac = cFac;
+	}
+
+	//Find the layers of a 3D table to blend for a 3rd dimension key, blended as
+	//fac*(high - low) + low.  The layers themselves are evaluated with layerExtrapolate.
+	void locateTables(T tableVal, Cursor& cursor, bool extrapolate, size_t& low, size_t& high, T& fac, bool& layerExtrapolate) const
+	{
+		const T* bp = tableBreakpoints.data();
+		unsigned int n = numTables;
+		fac = 0;
+		layerExtrapolate = false;
+
+		//3D interpolation between 2D tables only allows Nearest Neighbor or Linear
+		bool nearest = interpMethod == InterpMethod::INTERP_NEAREST;
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (nearest) {
+			extrapolate = false;
+		}
+
+		if (!extrapolate || n < 2)
+		{
+			if (tableVal <= bp[0] || n < 2)
+			{
+				cursor.table = 0;
+				low = high = 0;
+				return;
+			}
+			else if (tableVal >= bp[n - 1])
+			{
+				cursor.table = n - 2;
+				low = high = n - 1;
+				return;
+			}
+		}
+
+		unsigned int t = findInterval(bp, n, tableVal, cursor.table, tableSpacing);
+
+		T rng = bp[t + 1] - bp[t];
+		if (rng != 0.0)
+		{
+			fac = (tableVal - bp[t]) / rng;
+			if (!extrapolate) {
+				fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+			}
+		}
+		else {
+			fac = (T)1.0;
+		}
+
+		layerExtrapolate = extrapolate;
+		low = t;
+		high = t + 1;
+
+		if (nearest)
+		{
+			low = high = fac < 0.5 ? low : high;
+			fac = 0;
+		}
+	}
+
+	//Interpolate a 1D layer
+	T interpLayer(size_t layerIdx, T val, Cursor& cursor, bool extrapolate) const
+	{
+		const TableLayer& layer = layers[layerIdx];
+		const T* x = &rowBreakpoints[layer.rowOffset];
+		const T* y = values.data() + layer.valueOffset;
+		unsigned int n = layer.numRows;
+
+		if (n < 2) {
+			return n > 0 ? y[0] : (T)0;
+		}
+
+		if (layer.interpMethod > InterpMethod::INTERP_NEAREST)
+		{
+			//check for extrapolation
+			if (!extrapolate)
+			{
+				if (val <= x[0])
+				{
+					cursor.row = 0;
+					return y[0];
+				}
+				else if (val >= x[n - 1])
+				{
+					cursor.row = n - 2;
+					return y[n - 1];
+				}
+			}
+
+			//Spline interpolation
+			unsigned int i = findInterval(x, n, val, cursor.row, layer.rowSpacing);
+			return splines[layerIdx].evaluate(i, val - x[i]);
+		}
+
+		size_t lo, hi;
+		T fac;
+		locateLayer(layer, val, cursor, extrapolate, lo, hi, fac);
+		return fac*(values[hi] - values[lo]) + values[lo];
+	}
+
+	//Interpolate a 2D layer
+	T interpLayer(size_t layerIdx, T rowVal, T colVal, Cursor& cursor, bool extrapolate) const
+	{
+		const TableLayer& layer = layers[layerIdx];
+		if (layerDimensions(layer) == 1) {
+			return interpLayer(layerIdx, rowVal, cursor, extrapolate);
+		}
+
+		const T* x = &rowBreakpoints[layer.rowOffset];
+		const T* y = &columnBreakpoints[layer.columnOffset];
+		const T* z = values.data() + layer.valueOffset;
+		unsigned int nr = layer.numRows;
+		unsigned int nc = layer.numColumns;
+
+		if (nr < 2) {
+			return nr > 0 ? z[0] : (T)0;
+		}
+
+		if (layer.interpMethod > InterpMethod::INTERP_NEAREST)
+		{
+			bool outsideBounds = (rowVal <= x[0] || rowVal >= x[nr - 1]) ||
+								 (colVal <= y[0] || colVal >= y[nc - 1]);
+
+			if (!outsideBounds || extrapolate)
+			{
+				//Spline interpolation
+				unsigned int r = findInterval(x, nr, rowVal, cursor.row, layer.rowSpacing);
+				unsigned int c = findInterval(y, nc, colVal, cursor.column, layer.columnSpacing);
+				return splines[layerIdx].evaluate(r, c, nc - 1, rowVal - x[r], colVal - y[c]);
+			}
+		}
+
+		CellBlend blend;
+		locateLayer(layer, rowVal, colVal, cursor, extrapolate, blend);
+
+		//linear (or nearest neighbor, whose blend factors are zero)
+		T lowerColVal = blend.rowFac*(values[blend.c10] - values[blend.c00]) + values[blend.c00];
+		T upperColVal = blend.rowFac*(values[blend.c11] - values[blend.c01]) + values[blend.c01];
+		return lowerColVal + blend.colFac*(upperColVal - lowerColVal);
+	}
+
+	//Interpolate a 3D table
+	T interpTables(T rowVal, T colVal, T tableVal, Cursor& cursor, bool extrapolate) const
+	{
+		size_t low, high;
+		T fac;
+		bool layerExtrapolate;
+		locateTables(tableVal, cursor, extrapolate, low, high, fac, layerExtrapolate);
+
+		T table_value_low = interpLayer(low, rowVal, colVal, cursor, layerExtrapolate);
+		if (high == low) {
+			return table_value_low;
+		}
+		T table_value_high = interpLayer(high, rowVal, colVal, cursor, layerExtrapolate);
+
+		return fac*(table_value_high - table_value_low) + table_value_low;
+	}
+
+	//Interpolate a 1D layer and its derivative along the rows, in the same pass.  The value is the
+	//one interpLayer() gives.  The derivative is zero outside the breakpoints unless extrapolating,
+	//and for nearest neighbor layers.
+	T interpLayerGradient(size_t layerIdx, T val, Cursor& cursor, bool extrapolate, T& dRow) const
+	{
+		const TableLayer& layer = layers[layerIdx];
+		const T* x = &rowBreakpoints[layer.rowOffset];
+		const T* y = values.data() + layer.valueOffset;
+		unsigned int n = layer.numRows;
+		bool spline = layer.interpMethod > InterpMethod::INTERP_NEAREST;
+		dRow = 0;
+
+		if (n < 2 || layer.interpMethod == InterpMethod::INTERP_NEAREST) {
+			return interpLayer(layerIdx, val, cursor, extrapolate);
+		}
+
+		//check for extrapolation
+		if (!extrapolate && (val <= x[0] || val >= x[n - 1]))
+		{
+			bool first = val <= x[0];
+			unsigned int i = first ? 0 : n - 2;
+			cursor.row = i;
+			//on the first/last breakpoint, the slope of the end interval
+			if (val == x[first ? 0 : n - 1])
+			{
+				if (spline) {
+					splines[layerIdx].evaluate(i, val - x[i], dRow);
+				}
+				else if (x[i + 1] != x[i]) {
+					dRow = (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+				}
+			}
+			return first ? y[0] : y[n - 1];
+		}
+
+		unsigned int i = findInterval(x, n, val, cursor.row, layer.rowSpacing);
+		if (spline) {
+			return splines[layerIdx].evaluate(i, val - x[i], dRow);
+		}
+
+		T fac = (T)1.0;
+		T rng = x[i + 1] - x[i];
+		if (rng != 0.0)
+		{
+			fac = (val - x[i]) / rng;
+			if (!extrapolate) {
+				fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+			}
+			dRow = (y[i + 1] - y[i]) / rng;
+		}
+		return fac*(y[i + 1] - y[i]) + y[i];
+	}
+
+	//Interpolate a 2D layer and its partial derivatives along the rows and columns, see above
+	T interpLayerGradient(size_t layerIdx, T rowVal, T colVal, Cursor& cursor, bool extrapolate, T& dRow, T& dCol) const
+	{
+		const TableLayer& layer = layers[layerIdx];
+		dCol = 0;
+		if (layerDimensions(layer) == 1) {
+			return interpLayerGradient(layerIdx, rowVal, cursor, extrapolate, dRow);
+		}
+
+		const T* x = &rowBreakpoints[layer.rowOffset];
+		const T* y = &columnBreakpoints[layer.columnOffset];
+		const T* z = values.data() + layer.valueOffset;
+		unsigned int nr = layer.numRows;
+		unsigned int nc = layer.numColumns;
+		dRow = 0;
+
+		if (nr < 2 || layer.interpMethod == InterpMethod::INTERP_NEAREST) {
+			return interpLayer(layerIdx, rowVal, colVal, cursor, extrapolate);
+		}
+
+		unsigned int r = findInterval(x, nr, rowVal, cursor.row, layer.rowSpacing);
+		unsigned int c = findInterval(y, nc, colVal, cursor.column, layer.columnSpacing);
+
+		if (layer.interpMethod > InterpMethod::INTERP_NEAREST)
+		{
+			bool outsideBounds = (rowVal <= x[0] || rowVal >= x[nr - 1]) ||
+								 (colVal <= y[0] || colVal >= y[nc - 1]);
+			if (!outsideBounds || extrapolate)
+			{
+				//Spline interpolation
+				return splines[layerIdx].evaluate(r, c, nc - 1, rowVal - x[r], colVal - y[c], dRow, dCol);
+			}
+		}
+
+		//linear blend (also the fallback of splines on and outside the edges)
+		T rRng = x[r + 1] - x[r];
+		T cRng = y[c + 1] - y[c];
+		T rFac = (rowVal - x[r]) / rRng;
+		T cFac = (colVal - y[c]) / cRng;
+		if (!extrapolate)
+		{
+			rFac = rFac > 1.0 ? (T)1.0 : rFac < 0.0 ? (T)0.0 : rFac;
+			cFac = cFac > 1.0 ? (T)1.0 : cFac < 0.0 ? (T)0.0 : cFac;
+		}
+
+		const T* lowerRow = z + (size_t)r * nc + c;
+		const T* upperRow = lowerRow + nc;
+		T lowerColVal = rFac*(upperRow[0] - lowerRow[0]) + lowerRow[0];
+		T upperColVal = rFac*(upperRow[1] - lowerRow[1]) + lowerRow[1];
+
+		if (extrapolate || (rowVal >= x[0] && rowVal <= x[nr - 1])) {
+			dRow = ((upperRow[0] - lowerRow[0]) + cFac*((upperRow[1] - lowerRow[1]) - (upperRow[0] - lowerRow[0]))) / rRng;
+		}
+		if (extrapolate || (colVal >= y[0] && colVal <= y[nc - 1])) {
+			dCol = (upperColVal - lowerColVal) / cRng;
+		}
+		return lowerColVal + cFac*(upperColVal - lowerColVal);
+	}
+
+	//Interpolate a 3D table and its partial derivatives along the rows, columns and tables, see above
+	T interpTablesGradient(T rowVal, T colVal, T tableVal, Cursor& cursor, bool extrapolate, T gradient[3]) const
+	{
+		size_t low, high;
+		T fac;
+		bool layerExtrapolate;
+		locateTables(tableVal, cursor, extrapolate, low, high, fac, layerExtrapolate);
+
+		T lowGradient[2], highGradient[2];
+		T lowVal = interpLayerGradient(low, rowVal, colVal, cursor, layerExtrapolate, lowGradient[0], lowGradient[1]);
+		gradient[0] = lowGradient[0];
+		gradient[1] = lowGradient[1];
+		gradient[2] = 0;
+
+		const T* bp = tableBreakpoints.data();
+		unsigned int n = numTables;
+		bool nearest = interpMethod == InterpMethod::INTERP_NEAREST;
+		bool inside = extrapolate || (tableVal >= bp[0] && tableVal <= bp[n - 1]);
+
+		if (high == low)
+		{
+			//on (or beyond) the first/last table: the slope toward the neighboring table, on it
+			if (nearest || n < 2 || !inside)
+				return lowVal;
+
+			size_t other = low == 0 ? 1 : low - 1;
+			if (bp[other] != bp[low])
+			{
+				Cursor otherCursor = cursor;
+				T otherVal = interpLayer(other, rowVal, colVal, otherCursor, layerExtrapolate);
+				gradient[2] = (otherVal - lowVal) / (bp[other] - bp[low]);
+			}
+			return lowVal;
+		}
+
+		T highVal = interpLayerGradient(high, rowVal, colVal, cursor, layerExtrapolate, highGradient[0], highGradient[1]);
+		gradient[0] = fac*(highGradient[0] - lowGradient[0]) + lowGradient[0];
+		gradient[1] = fac*(highGradient[1] - lowGradient[1]) + lowGradient[1];
+		if (inside && bp[high] != bp[low]) {
+			gradient[2] = (highVal - lowVal) / (bp[high] - bp[low]);
+		}
+
+		return fac*(highVal - lowVal) + lowVal;
+	}
+
+	//Does the table have breakpoints on the axis?
+	bool hasAxis(TableAxis axis) const
+	{
+		if (layers.empty())
+			return false;
+		if (axis == TableAxis::AXIS_TABLE)
+			return dimensions == 3;
+		return axis == TableAxis::AXIS_ROW || layerDimensions(layers[0]) == 2;
+	}
+
+	//Breakpoints of an axis, shared by every layer (false if the table has no such axis, or
+	//its layers have different breakpoints on it)
+	bool axisBreakpoints(TableAxis axis, const T*& bp, unsigned int& n, const AxisSpacing*& spacing) const
+	{
+		if (layers.empty())
+			return false;
+
+		if (axis == TableAxis::AXIS_TABLE)
+		{
+			if (dimensions != 3)
+				return false;
+			bp = tableBreakpoints.data();
+			n = numTables;
+			spacing = &tableSpacing;
+			return true;
+		}
+
+		const TableLayer& first = layers[0];
+		bool row = axis == TableAxis::AXIS_ROW;
+		if (!row && layerDimensions(first) != 2)
+			return false;
+
+		bp = row ? &rowBreakpoints[first.rowOffset] : &columnBreakpoints[first.columnOffset];
+		n = row ? first.numRows : first.numColumns;
+		spacing = row ? &first.rowSpacing : &first.columnSpacing;
+
+		for (size_t i = 1; i < layers.size(); i++)
+		{
+			const TableLayer& layer = layers[i];
+			if (layerDimensions(layer) != layerDimensions(first) || (row ? layer.numRows : layer.numColumns) != n)
+				return false;
+			const T* layerBp = row ? &rowBreakpoints[layer.rowOffset] : &columnBreakpoints[layer.columnOffset];
+			if (!std::equal(bp, bp + n, layerBp))
+				return false;
+		}
+		return true;
+	}
+
+	//Locate a key on a breakpoint axis
+	static void prelookup(const T* bp, unsigned int n, T key, const AxisSpacing& spacing, Prelookup& pre)
+	{
+		if (n < 2)
+		{
+			pre.index = 0;
+			pre.fraction = pre.offset = 0;
+			pre.below = pre.above = true;
+			return;
+		}
+
+		unsigned int i = findInterval(bp, n, key, pre.index, spacing);
+		T rng = bp[i + 1] - bp[i];
+		pre.offset = key - bp[i];
+		pre.fraction = rng != 0.0 ? pre.offset / rng : (T)1.0;
+		pre.below = key <= bp[0];
+		pre.above = key >= bp[n - 1];
+	}
+
+	//Interpolate a 1D layer at a prelocated key, as interpLayer() does at the key itself
+	T interpLayer(size_t layerIdx, const Prelookup& row, bool extrapolate) const
+	{
+		const TableLayer& layer = layers[layerIdx];
+		const T* y = values.data() + layer.valueOffset;
+		unsigned int n = layer.numRows;
+
+		if (n < 2) {
+			return n > 0 ? y[0] : (T)0;
+		}
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (layer.interpMethod == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+		//check for extrapolation
+		if (!extrapolate)
+		{
+			if (row.below)
+				return y[0];
+			else if (row.above)
+				return y[n - 1];
+		}
+
+		if (layer.interpMethod > InterpMethod::INTERP_NEAREST) {
+			return splines[layerIdx].evaluate(row.index, row.offset);
+		}
+
+		T fac = row.fraction;
+		if (!extrapolate) {
+			fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+		}
+
+		if (layer.interpMethod == InterpMethod::INTERP_NEAREST)
+			return fac < 0.5 ? y[row.index] : y[row.index + 1];
+
+		return fac*(y[row.index + 1] - y[row.index]) + y[row.index];
+	}
+
+	//Interpolate a 2D layer at prelocated keys, as interpLayer() does at the keys themselves
+	T interpLayer(size_t layerIdx, const Prelookup& row, const Prelookup& col, bool extrapolate) const
+	{
+		const TableLayer& layer = layers[layerIdx];
+		if (layerDimensions(layer) == 1) {
+			return interpLayer(layerIdx, row, extrapolate);
+		}
+
+		const T* z = values.data() + layer.valueOffset;
+		unsigned int nr = layer.numRows;
+		unsigned int nc = layer.numColumns;
+
+		if (nr < 2) {
+			return nr > 0 ? z[0] : (T)0;
+		}
+
+		if (layer.interpMethod > InterpMethod::INTERP_NEAREST)
+		{
+			bool outsideBounds = row.below || row.above || col.below || col.above;
+			if (!outsideBounds || extrapolate)
+			{
+				//Spline interpolation
+				return splines[layerIdx].evaluate(row.index, col.index, nc - 1, row.offset, col.offset);
+			}
+		}
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (layer.interpMethod == InterpMethod::INTERP_NEAREST) {
+			extrapolate = false;
+		}
+
+		T rFac = row.fraction;
+		T cFac = col.fraction;
+		if (!extrapolate)
+		{
+			rFac = rFac > 1.0 ? (T)1.0 : rFac < 0.0 ? (T)0.0 : rFac;
+			cFac = cFac > 1.0 ? (T)1.0 : cFac < 0.0 ? (T)0.0 : cFac;
+		}
+
+		const T* lowerRow = z + (size_t)row.index * nc + col.index;
+		const T* upperRow = lowerRow + nc;
+
+		if (layer.interpMethod == InterpMethod::INTERP_NEAREST)
+			return (rFac < 0.5 ? lowerRow : upperRow)[cFac < 0.5 ? 0 : 1];
+
+		T lowerColVal = rFac*(upperRow[0] - lowerRow[0]) + lowerRow[0];
+		T upperColVal = rFac*(upperRow[1] - lowerRow[1]) + lowerRow[1];
+		return lowerColVal + cFac*(upperColVal - lowerColVal);
+	}
+
+	//Interpolate a 3D table at prelocated keys, as interpTables() does at the keys themselves
+	T interpTables(const Prelookup& row, const Prelookup& col, const Prelookup& table, bool extrapolate) const
+	{
+		unsigned int n = numTables;
+
+		//3D interpolation between 2D tables only allows Nearest Neighbor or Linear
+		bool nearest = interpMethod == InterpMethod::INTERP_NEAREST;
+
+		//cannot extrapolate with Nearest Neighbor selection
+		if (nearest) {
+			extrapolate = false;
+		}
+
+		if (!extrapolate || n < 2)
+		{
+			if (table.below || n < 2)
+				return interpLayer(0, row, col, false);
+			else if (table.above)
+				return interpLayer(n - 1, row, col, false);
+		}
+
+		T fac = table.fraction;
+		if (!extrapolate) {
+			fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
+		}
+
+		if (nearest)
+			return interpLayer(fac < 0.5 ? table.index : table.index + 1, row, col, extrapolate);
 
-struct TableSplines
-{
-	void clearSplinePtrs()
-	{
-		pchipSpline_1D = nullptr;
-		cubicSpline_1D = nullptr;
-		akimaSpline_1D = nullptr;
-		qunticSpline_1D = nullptr;
-		besselSpline_1D = nullptr;
-		hermiteSpline_1D = nullptr;
+		T table_value_low = interpLayer(table.index, row, col, extrapolate);
+		T table_value_high = interpLayer(table.index + 1, row, col, extrapolate);
 
-		cubicSpline_2D = nullptr;
-		akimaSpline_2D = nullptr;
-		qunticSpline_2D = nullptr;
+		return fac*(table_value_high - table_value_low) + table_value_low;
 	}
 
-	void deleteSplines()
+	//Can the vector kernels blend a batch?  Splines and layers with fewer than 2 rows go
+	//through interpLayer() one key at a time instead.
+	bool batchBlendable() const
 	{
-		if (pchipSpline_1D) { delete pchipSpline_1D; pchipSpline_1D = nullptr; }
-		if (cubicSpline_1D) { delete cubicSpline_1D; cubicSpline_1D = nullptr; }
-		if (akimaSpline_1D) { delete akimaSpline_1D; akimaSpline_1D = nullptr; }
-		if (qunticSpline_1D) { delete qunticSpline_1D; qunticSpline_1D = nullptr; }
-		if (besselSpline_1D) { delete besselSpline_1D; besselSpline_1D = nullptr; }
-		if (hermiteSpline_1D) { delete hermiteSpline_1D; hermiteSpline_1D = nullptr; }
+		if (values.size() > (size_t)INT_MAX)
+			return false;
 
-		if (cubicSpline_2D) { delete cubicSpline_2D; cubicSpline_2D = nullptr; }
-		if (akimaSpline_2D) { delete akimaSpline_2D; akimaSpline_2D = nullptr; }
-		if (qunticSpline_2D) { delete qunticSpline_2D; qunticSpline_2D = nullptr; }
+		for (size_t i = 0; i < layers.size(); i++) {
+			if (layers[i].interpMethod > InterpMethod::INTERP_NEAREST || layers[i].numRows < 2)
+				return false;
+		}
+		return true;
 	}
 
-	template <typename T>
-	T evaluate(T val, InterpMethod method)
+	//Batch of 1D lookups on the first layer
+	void interpBatch(const T* keys, T* out, size_t count, bool extrapolate, bool sortedKeys) const
 	{
-		switch (method)
+		Cursor cursor;
+		if (!batchBlendable() || layerDimensions(layers[0]) != 1)
 		{
-		case InterpMethod::INTERP_PCHIP:
-			if (pchipSpline_1D) return (T)pchipSpline_1D->eval((Splines::valueType)val);
-			break;
-		case InterpMethod::INTERP_CUBIC:
-			if (cubicSpline_1D) return (T)cubicSpline_1D->eval((Splines::valueType)val);
-			break;
-		case InterpMethod::INTERP_AKIMA:
-			if (akimaSpline_1D) return (T)akimaSpline_1D->eval((Splines::valueType)val);
-			break;
-		case InterpMethod::INTERP_QUINTIC:
-			if (qunticSpline_1D) return (T)qunticSpline_1D->eval((Splines::valueType)val);
-			break;
-		case InterpMethod::INTERP_BESSEL:
-			if (besselSpline_1D) return (T)besselSpline_1D->eval((Splines::valueType)val);
-			break;
-		case InterpMethod::INTERP_HERMITE:
-			if (hermiteSpline_1D) return (T)hermiteSpline_1D->eval((Splines::valueType)val);
-			break;
-		default:
-			//TODO: WARNING message for using unsupported Interpolation Method
-			break;
+			for (size_t k = 0; k < count; k++)
+			{
+				if (!sortedKeys) {
+					cursor.reset();
+				}
+				out[k] = interpLayer(0, keys[k], cursor, extrapolate);
+			}
+			return;
 		}
 
-		return (T)0;
+		int lo[BATCH_BLOCK], hi[BATCH_BLOCK];
+		T fac[BATCH_BLOCK];
+		for (size_t start = 0; start < count; start += BATCH_BLOCK)
+		{
+			size_t n = count - start < BATCH_BLOCK ? count - start : BATCH_BLOCK;
+			for (size_t k = 0; k < n; k++)
+			{
+				if (!sortedKeys) {
+					cursor.reset();
+				}
+				size_t l, h;
+				locateLayer(layers[0], keys[start + k], cursor, extrapolate, l, h, fac[k]);
+				lo[k] = (int)l;
+				hi[k] = (int)h;
+			}
+			TableKernels::blend1D(values.data(), lo, hi, fac, out + start, n);
+		}
 	}
 
-	template <typename T>
-	T evaluate(T rowVal, T colVal, InterpMethod method)
+	//Batch of 2D lookups on the first layer, or of 3D lookups when tableKeys is given
+	void interpBatch(const T* rowKeys, const T* colKeys, const T* tableKeys, T* out, size_t count, bool extrapolate, bool sortedKeys) const
 	{
-		switch (method)
+		Cursor cursor;
+		bool tables = tableKeys && dimensions == 3;
+		if (!batchBlendable())
 		{
-		case InterpMethod::INTERP_CUBIC:
-			if (cubicSpline_2D) return (T)cubicSpline_2D->eval((Splines::valueType)rowVal, (Splines::valueType)colVal);
-			break;
-		case InterpMethod::INTERP_AKIMA:
-			if (akimaSpline_2D) return (T)akimaSpline_2D->eval((Splines::valueType)rowVal, (Splines::valueType)colVal);
-			break;
-		case InterpMethod::INTERP_QUINTIC:
-			if (qunticSpline_2D) return (T)qunticSpline_2D->eval((Splines::valueType)rowVal, (Splines::valueType)colVal);
-			break;
-		default:
-			//TODO: WARNING message for using unsupported Interpolation Method
-			break;
+			for (size_t k = 0; k < count; k++)
+			{
+				if (!sortedKeys) {
+					cursor.reset();
+				}
+				out[k] = tables ? interpTables(rowKeys[k], colKeys[k], tableKeys[k], cursor, extrapolate) :
+					interpLayer(0, rowKeys[k], colKeys[k], cursor, extrapolate);
+			}
+			return;
 		}
 
-		return (T)0;
+		BatchCells low, high;
+		T tableFac[BATCH_BLOCK];
+		T lowVal[BATCH_BLOCK], highVal[BATCH_BLOCK];
+		for (size_t start = 0; start < count; start += BATCH_BLOCK)
+		{
+			size_t n = count - start < BATCH_BLOCK ? count - start : BATCH_BLOCK;
+			for (size_t k = 0; k < n; k++)
+			{
+				if (!sortedKeys) {
+					cursor.reset();
+				}
+				if (tables)
+				{
+					size_t lowLayer, highLayer;
+					bool layerExtrapolate;
+					locateTables(tableKeys[start + k], cursor, extrapolate, lowLayer, highLayer, tableFac[k], layerExtrapolate);
+					low.set(k, *this, layers[lowLayer], rowKeys[start + k], colKeys[start + k], cursor, layerExtrapolate);
+					high.set(k, *this, layers[highLayer], rowKeys[start + k], colKeys[start + k], cursor, layerExtrapolate);
+				}
+				else {
+					low.set(k, *this, layers[0], rowKeys[start + k], colKeys[start + k], cursor, extrapolate);
+				}
+			}
+
+			if (tables)
+			{
+				low.blend(values.data(), lowVal, n);
+				high.blend(values.data(), highVal, n);
+				TableKernels::lerp(lowVal, highVal, tableFac, out + start, n);
+			}
+			else {
+				low.blend(values.data(), out + start, n);
+			}
+		}
 	}
 
-	~TableSplines() {
-		deleteSplines();
+	//Evenly spaced breakpoints over the range of an axis, ending exactly on its last breakpoint
+	static void uniformAxis(const T* bp, unsigned int n, unsigned int count, std::vector<T>& axis)
+	{
+		axis.resize(count);
+		for (unsigned int i = 0; i < count; i++) {
+			axis[i] = bp[0] + (bp[n - 1] - bp[0]) * (T)i / (T)(count - 1);
+		}
+		axis[count - 1] = bp[n - 1];
 	}
 
-	Splines::PchipSpline* pchipSpline_1D = nullptr;
-	Splines::CubicSpline* cubicSpline_1D = nullptr;
-	Splines::AkimaSpline* akimaSpline_1D = nullptr;
-	Splines::QuinticSpline* qunticSpline_1D = nullptr;
-	Splines::BesselSpline* besselSpline_1D = nullptr;
-	Splines::HermiteSpline* hermiteSpline_1D = nullptr;
+	//Resample a layer onto evenly spaced breakpoints, adding breakpoints until linear interpolation
+	//of the samples stays within tolerance of the layer (or the samples would exceed maxValues).  The
+	//deviation is measured at the quarter points of each 1D interval, and at the center and edge
+	//midpoints of each 2D cell.  Outputs the new breakpoints and values (row-major) and the largest
+	//deviation measured.
+	void compileLayer(size_t layerIdx, T tolerance, size_t maxValues, std::vector<T>& rows,
+		std::vector<T>& cols, std::vector<T>& grid, T& deviation) const
+	{
+		const TableLayer& layer = layers[layerIdx];
+		const T* x = &rowBreakpoints[layer.rowOffset];
+		const T* y = layerDimensions(layer) == 2 ? &columnBreakpoints[layer.columnOffset] : nullptr;
+		unsigned int nr = layer.numRows;
+		unsigned int nc = y ? layer.numColumns : 1;
+		deviation = 0;
+		cols.clear();
+
+		if (nr < 2)
+		{
+			rows.assign(x, x + nr);
+			grid.assign(values.data() + layer.valueOffset, values.data() + layer.valueOffset + (size_t)nr * nc);
+			if (y) {
+				cols.assign(y, y + nc);
+			}
+			return;
+		}
 
-	Splines::BiCubicSpline* cubicSpline_2D = nullptr;
-	Splines::Akima2Dspline* akimaSpline_2D = nullptr;
-	Splines::BiQuinticSpline* qunticSpline_2D = nullptr;
-};
+		//2D layers are sampled as extrapolating (all keys are still inside the breakpoint range), so
+		//splines give their limit on the edges rather than the linear blend they fall back to there
+		bool edgeLimit = y != nullptr;
 
-template <typename T>
-class Table<T>::Impl
-{
-public:
-	//Number of dimensions of data
-	unsigned int dimensions = 0;
-	//Number of Rows of data
-	unsigned int numRows = 0;
-	//Number of Columns of data (1 for 1D tables)
-	unsigned int numColumns = 0;
-	//Number of tables of 2D data
-	unsigned int numTables = 0;
-	//Row counter for data insertion
-	unsigned int rowInsertCtr = 0;
-	//Column counter for data insertion
-	unsigned int columnInsertCtr = 0;
-	//Cached row index from last interpolation
-	mutable unsigned int lastRowIdx = 0;
-	//Cached column index from last interpolation
-	mutable unsigned int lastColumnIdx = 0;
-	//Interpolation method
-	InterpMethod interpMethod = InterpMethod::INTERP_LINEAR;
-	//Have splines already been built for the data?
-	bool splinesBuilt = false;
-	//2D Array of table data (only one dimension used in 1D tables)
-	T** data = nullptr;
-	//Vector of 2D tables (constitutes the 3rd dimension in the root table)
-	std::vector<Table<T>> tables;
+		Cursor cursor;
+		unsigned int countRows = nr;
+		unsigned int countCols = nc;
+		while (true)
+		{
+			uniformAxis(x, nr, countRows, rows);
+			if (y) {
+				uniformAxis(y, nc, countCols, cols);
+			}
+			else {
+				cols.assign(1, (T)0);
+				countCols = 1;
+			}
 
-	TableSplines splines;
+			grid.resize((size_t)countRows * countCols);
+			for (unsigned int i = 0; i < countRows; i++) {
+				for (unsigned int j = 0; j < countCols; j++) {
+					grid[(size_t)i * countCols + j] = interpLayer(layerIdx, rows[i], cols[j], cursor, edgeLimit);
+				}
+			}
 
-	//Allocate memory for the 2D array sizes
-	T** allocateArraySize()
-	{
-		data = new T*[numRows + 1];
-		for (unsigned int r = 0; r <= numRows; r++) {
-			data[r] = new T[numColumns + 1];
-			for (unsigned int c = 0; c <= numColumns; c++) {
-				data[r][c] = 0.0;
+			//deviation from blending along the rows, along the columns, and both
+			T rowError = 0, colError = 0, cellError = 0;
+			for (unsigned int i = 0; i < countRows; i++)
+			{
+				for (unsigned int j = 0; j < countCols; j++)
+				{
+					const T* g = &grid[(size_t)i * countCols + j];
+					if (i + 1 < countRows)
+					{
+						static const T quarters[3] = { (T)0.25, (T)0.5, (T)0.75 };
+						for (unsigned int q = y ? 1 : 0; q < (y ? 2u : 3u); q++)
+						{
+							T key = rows[i] + quarters[q] * (rows[i + 1] - rows[i]);
+							T linear = g[0] + quarters[q] * (g[countCols] - g[0]);
+							rowError = std::max(rowError, (T)std::abs(interpLayer(layerIdx, key, cols[j], cursor, edgeLimit) - linear));
+						}
+					}
+					if (j + 1 < countCols)
+					{
+						T key = (T)0.5 * (cols[j] + cols[j + 1]);
+						T linear = (T)0.5 * (g[0] + g[1]);
+						colError = std::max(colError, (T)std::abs(interpLayer(layerIdx, rows[i], key, cursor, edgeLimit) - linear));
+					}
+					if (i + 1 < countRows && j + 1 < countCols)
+					{
+						T linear = (T)0.25 * (g[0] + g[1] + g[countCols] + g[countCols + 1]);
+						T value = interpLayer(layerIdx, (T)0.5 * (rows[i] + rows[i + 1]), (T)0.5 * (cols[j] + cols[j + 1]), cursor, edgeLimit);
+						cellError = std::max(cellError, (T)std::abs(value - linear));
+					}
+				}
+			}
+
+			deviation = std::max(std::max(rowError, colError), cellError);
+			if (!(deviation > tolerance))
+				return;
+
+			//refine the axes whose own error is too large, or both when only their combination is
+			bool refineRows = rowError > (T)0.5 * tolerance;
+			bool refineCols = y && colError > (T)0.5 * tolerance;
+			if (!refineRows && !refineCols) {
+				refineRows = refineCols = true;
 			}
+			refineCols = refineCols && y;
+			unsigned int nextRows = refineRows ? 2 * countRows - 1 : countRows;
+			unsigned int nextCols = refineCols ? 2 * countCols - 1 : countCols;
+			if (refineRows && refineCols && (size_t)nextRows * nextCols > maxValues)
+			{
+				//only room to refine one axis, take the worse one
+				if (rowError >= colError)
+					nextCols = countCols;
+				else
+					nextRows = countRows;
+			}
+			if ((size_t)nextRows * nextCols > maxValues || (nextRows == countRows && nextCols == countCols))
+			{
+				//TODO: WARNING message for a compiled table not reaching its tolerance within maxValues
+				return;
+			}
+
+			countRows = nextRows;
+			countCols = nextCols;
 		}
-		return data;
 	}
 
-	void buildSplines()
+	//Table element in the layout of the stream operators: row 0 holds the column breakpoints,
+	//column 0 holds the row breakpoints (the 3rd dimension breakpoints are in column 1 for 3D tables)
+	T* cell(unsigned int row, unsigned int col)
 	{
-		if (interpMethod > InterpMethod::INTERP_NEAREST)
+		if (row < 1 || row > numRows)
 		{
-			if (numColumns == 1 && tables.size() == 0)
-			{
-				//1D table
-				if (checkInterpolationMethod(interpMethod))
-				{
-					std::vector<Splines::valueType> xVals;
-					std::vector<Splines::valueType> yVals;
-					for (unsigned int r = 1; r <= numRows; r++) {
-						xVals.push_back((Splines::valueType)data[r][0]);
-						yVals.push_back((Splines::valueType)data[r][1]);
-					}
+			if (row == 0 && dimensions == 2 && col >= 1 && col <= numColumns)
+				return &columnBreakpoints[col - 1];
+			return nullptr;
+		}
 
-					splines.deleteSplines();
+		if (dimensions == 3) {
+			return col == 1 ? &tableBreakpoints[row - 1] : nullptr;
+		}
+		if (col == 0) {
+			return &rowBreakpoints[row - 1];
+		}
+		if (col <= numColumns) {
+			return &values[(size_t)(row - 1) * numColumns + (col - 1)];
+		}
+		return nullptr;
+	}
 
-					switch (interpMethod)
-					{
-					case InterpMethod::INTERP_PCHIP:
-						splines.pchipSpline_1D = new Splines::PchipSpline();
-						splines.pchipSpline_1D->build(xVals, yVals);
-						break;
-					case InterpMethod::INTERP_CUBIC:
-						splines.cubicSpline_1D = new Splines::CubicSpline();
-						splines.cubicSpline_1D->build(xVals, yVals);
-						break;
-					case InterpMethod::INTERP_AKIMA:
-						splines.akimaSpline_1D = new Splines::AkimaSpline();
-						splines.akimaSpline_1D->build(xVals, yVals);
-						break;
-					case InterpMethod::INTERP_QUINTIC:
-						splines.qunticSpline_1D = new Splines::QuinticSpline();
-						splines.qunticSpline_1D->build(xVals, yVals);
-						break;
-					case InterpMethod::INTERP_BESSEL:
-						splines.besselSpline_1D = new Splines::BesselSpline();
-						splines.besselSpline_1D->build(xVals, yVals);
-						break;
-					case InterpMethod::INTERP_HERMITE:
-						splines.hermiteSpline_1D = new Splines::HermiteSpline();
-						splines.hermiteSpline_1D->build(xVals, yVals);
-						break;
-					default:
-						//should never happen
-						return;
-					}
+	//Write the table to a binary table file, with the spline polynomials of every layer.  The file
+	//is written next to the destination and then replaces it, so tables mapping the old file
+	//never see it truncated.
+	bool writeFile(const std::string& filePath)
+	{
+		if (mappedFile && mappedFile->isFile(filePath))
+		{
+			//TODO: WARNING message for writing a table over the file it is read from
+			return false;
+		}
 
-					splinesBuilt = true;
-				}
-				else {
-					//TODO: WARNING message for using unsupported Interpolation Method
-					interpMethod = InterpMethod::INTERP_LINEAR;
-					splinesBuilt = false;
-				}
+		prepare();
 
-			}
-			else if (numColumns > 1)
+		std::string tempPath = filePath + ".tmp";
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return false;
+
+		bool written = writeContents(file);
+		file.close();
+		if (!written || file.fail() || !MappedFile::replaceFile(tempPath, filePath))
+		{
+			std::remove(tempPath.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	//Write the header, layer records and sections of a binary table file
+	bool writeContents(std::ofstream& file) const
+	{
+		TableFileHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, TABLE_FILE_MAGIC, sizeof(header.magic));
+		header.byteOrder = TABLE_FILE_BYTE_ORDER;
+		header.version = TABLE_FILE_VERSION;
+		header.valueSize = sizeof(T);
+		header.dimensions = dimensions;
+		header.numRows = numRows;
+		header.numColumns = numColumns;
+		header.numTables = numTables;
+		header.interpMethod = (uint32_t)interpMethod;
+		header.numLayers = (uint32_t)layers.size();
+
+		std::vector<TableFileLayer> records(layers.size());
+		uint64_t coefficientCount = 0;
+		for (size_t i = 0; i < layers.size(); i++)
+		{
+			TableFileLayer& record = records[i];
+			memset(&record, 0, sizeof(record));
+			record.numRows = layers[i].numRows;
+			record.numColumns = layers[i].numColumns;
+			record.interpMethod = (uint32_t)layers[i].interpMethod;
+			record.splineOrder = splines[i].order;
+			record.rowOffset = layers[i].rowOffset;
+			record.columnOffset = layers[i].columnOffset;
+			record.valueOffset = layers[i].valueOffset;
+			record.coefficientOffset = coefficientCount;
+			record.coefficientCount = splines[i].coefficients.size();
+			coefficientCount += record.coefficientCount;
+		}
+
+		const T* sectionData[NUM_TABLE_FILE_SECTIONS] = {
+			rowBreakpoints.data(), columnBreakpoints.data(), tableBreakpoints.data(), values.data(), nullptr };
+		header.sectionCount[SECTION_ROW_BREAKPOINTS] = rowBreakpoints.size();
+		header.sectionCount[SECTION_COLUMN_BREAKPOINTS] = columnBreakpoints.size();
+		header.sectionCount[SECTION_TABLE_BREAKPOINTS] = tableBreakpoints.size();
+		header.sectionCount[SECTION_VALUES] = values.size();
+		header.sectionCount[SECTION_COEFFICIENTS] = coefficientCount;
+
+		uint64_t offset = alignFileOffset(sizeof(header));
+		header.layerOffset = offset;
+		offset = alignFileOffset(offset + records.size() * sizeof(TableFileLayer));
+		for (int k = 0; k < NUM_TABLE_FILE_SECTIONS; k++)
+		{
+			header.sectionOffset[k] = offset;
+			offset = alignFileOffset(offset + header.sectionCount[k] * sizeof(T));
+		}
+
+		uint64_t position = 0;
+		file.write((const char*)&header, sizeof(header));
+		position += sizeof(header);
+		padFile(file, position, header.layerOffset);
+		if (!records.empty())
+		{
+			file.write((const char*)records.data(), (std::streamsize)(records.size() * sizeof(TableFileLayer)));
+			position += records.size() * sizeof(TableFileLayer);
+		}
+		for (int k = 0; k < NUM_TABLE_FILE_SECTIONS; k++)
+		{
+			padFile(file, position, header.sectionOffset[k]);
+			if (k == SECTION_COEFFICIENTS)
 			{
-				//2D table
-				if (checkInterpolationMethod(interpMethod))
+				for (const TableSplines& layerSplines : splines)
 				{
-					std::vector<Splines::valueType> xVals;
-					std::vector<Splines::valueType> yVals;
-					std::vector<Splines::valueType> zVals;
-					for (unsigned int c = 1; c <= numColumns; c++) {
-						yVals.push_back((Splines::valueType)data[0][c]);
-					}
-					for (unsigned int r = 1; r <= numRows; r++) {
-						xVals.push_back((Splines::valueType)data[r][0]);
-						for (unsigned int c = 1; c <= numColumns; c++) {
-							zVals.push_back((Splines::valueType)data[r][c]);
-						}
-					}
+					file.write((const char*)layerSplines.coefficients.data(), (std::streamsize)(layerSplines.coefficients.size() * sizeof(T)));
+					position += layerSplines.coefficients.size() * sizeof(T);
+				}
+			}
+			else if (header.sectionCount[k] > 0)
+			{
+				file.write((const char*)sectionData[k], (std::streamsize)(header.sectionCount[k] * sizeof(T)));
+				position += header.sectionCount[k] * sizeof(T);
+			}
+		}
+		padFile(file, position, offset);
 
-					splines.deleteSplines();
+		return file.good();
+	}
 
-					switch (interpMethod)
-					{
-					case InterpMethod::INTERP_CUBIC:
-						splines.cubicSpline_2D = new Splines::BiCubicSpline();
-						splines.cubicSpline_2D->build(xVals, yVals, zVals);
-						break;
-					case InterpMethod::INTERP_AKIMA:
-						splines.akimaSpline_2D = new Splines::Akima2Dspline();
-						splines.akimaSpline_2D->build(xVals, yVals, zVals);
-						break;
-					case InterpMethod::INTERP_QUINTIC:
-						splines.qunticSpline_2D = new Splines::BiQuinticSpline();
-						splines.qunticSpline_2D->build(xVals, yVals, zVals);
-						break;
-					default:
-						//should never happen
-						return;
-					}
+	//Number of spline coefficients a layer has for the given polynomial order
+	size_t splineCoefficientCount(const TableLayer& layer, unsigned int order) const
+	{
+		if (layerDimensions(layer) == 1)
+			return (size_t)(layer.numRows - 1) * order;
+		return (size_t)(layer.numRows - 1) * (layer.numColumns - 1) * order * order;
+	}
 
-					splinesBuilt = true;
-				}
-				else {
-					//TODO: WARNING message for using unsupported Interpolation Method
-					interpMethod = InterpMethod::INTERP_LINEAR;
-					splinesBuilt = false;
-				}
+	//Take the table from a mapped binary table file.  The breakpoints are copied, the values and the
+	//spline coefficients are used in place.  Returns false (leaving the data unusable) for invalid files.
+	bool readFile(const std::shared_ptr<MappedFile>& file)
+	{
+		const unsigned char* base = file->data();
+		uint64_t fileSize = file->size();
+
+		TableFileHeader header;
+		if (fileSize < sizeof(header))
+			return false;
+		memcpy(&header, base, sizeof(header));
+
+		if (memcmp(header.magic, TABLE_FILE_MAGIC, sizeof(header.magic)) != 0 || header.byteOrder != TABLE_FILE_BYTE_ORDER ||
+			header.version != TABLE_FILE_VERSION || header.valueSize != sizeof(T))
+			return false;
+		if (header.dimensions < 1 || header.dimensions > 3 || header.numRows < 1 || header.numColumns < 1 ||
+			header.interpMethod > (uint32_t)InterpMethod::INTERP_HERMITE)
+			return false;
+		if (header.numLayers != (header.dimensions == 3 ? header.numTables : 1) || header.numLayers == 0)
+			return false;
+		if (header.layerOffset > fileSize || header.numLayers > (fileSize - header.layerOffset) / sizeof(TableFileLayer))
+			return false;
+
+		const T* section[NUM_TABLE_FILE_SECTIONS];
+		for (int k = 0; k < NUM_TABLE_FILE_SECTIONS; k++)
+		{
+			uint64_t sectionOffset = header.sectionOffset[k];
+			if (sectionOffset % TABLE_FILE_ALIGNMENT != 0 || sectionOffset > fileSize ||
+				header.sectionCount[k] > (fileSize - sectionOffset) / sizeof(T))
+				return false;
+			section[k] = (const T*)(base + sectionOffset);
+		}
+
+		//the table dimensions index the sections directly (see cell()), so they must fit them:
+		//a 1D or 2D table is its single layer, a 3D table has one row per table breakpoint
+		const uint64_t* count = header.sectionCount;
+		if (header.dimensions < 3)
+		{
+			if (header.numTables != 0 || (header.dimensions == 1 && header.numColumns != 1) ||
+				count[SECTION_ROW_BREAKPOINTS] < header.numRows ||
+				(header.dimensions == 2 && count[SECTION_COLUMN_BREAKPOINTS] != header.numColumns) ||
+				count[SECTION_VALUES] < (uint64_t)header.numRows * header.numColumns)
+				return false;
+
+			TableFileLayer record;
+			memcpy(&record, base + header.layerOffset, sizeof(record));
+			if (record.numRows != header.numRows || record.numColumns != header.numColumns)
+				return false;
+		}
+		else if (header.numRows != header.numTables || header.numColumns != 1 || count[SECTION_TABLE_BREAKPOINTS] != header.numTables)
+			return false;
+
+		dimensions = header.dimensions;
+		numRows = header.numRows;
+		numColumns = header.numColumns;
+		numTables = header.numTables;
+		interpMethod = (InterpMethod)header.interpMethod;
+		//all the data is in
+		rowInsertCtr = numRows + 1;
+		columnInsertCtr = 0;
+
+		rowBreakpoints.assign(section[SECTION_ROW_BREAKPOINTS], section[SECTION_ROW_BREAKPOINTS] + count[SECTION_ROW_BREAKPOINTS]);
+		columnBreakpoints.assign(section[SECTION_COLUMN_BREAKPOINTS], section[SECTION_COLUMN_BREAKPOINTS] + count[SECTION_COLUMN_BREAKPOINTS]);
+		tableBreakpoints.assign(section[SECTION_TABLE_BREAKPOINTS], section[SECTION_TABLE_BREAKPOINTS] + count[SECTION_TABLE_BREAKPOINTS]);
+		values.view(section[SECTION_VALUES], (size_t)count[SECTION_VALUES]);
+
+		layers.assign(header.numLayers, TableLayer());
+		splines.assign(header.numLayers, TableSplines());
+		for (size_t i = 0; i < layers.size(); i++)
+		{
+			TableFileLayer record;
+			memcpy(&record, base + header.layerOffset + i * sizeof(TableFileLayer), sizeof(record));
+
+			if (record.numRows < 1 || record.numColumns < 1 || record.interpMethod > (uint32_t)InterpMethod::INTERP_HERMITE)
+				return false;
+			if (record.rowOffset > count[SECTION_ROW_BREAKPOINTS] || record.numRows > count[SECTION_ROW_BREAKPOINTS] - record.rowOffset)
+				return false;
+			if (record.numColumns > 1 && (record.columnOffset > count[SECTION_COLUMN_BREAKPOINTS] ||
+				record.numColumns > count[SECTION_COLUMN_BREAKPOINTS] - record.columnOffset))
+				return false;
+			if (record.valueOffset > count[SECTION_VALUES] || (uint64_t)record.numRows * record.numColumns > count[SECTION_VALUES] - record.valueOffset)
+				return false;
+
+			TableLayer& layer = layers[i];
+			layer.numRows = record.numRows;
+			layer.numColumns = record.numColumns;
+			layer.rowOffset = (size_t)record.rowOffset;
+			layer.columnOffset = (size_t)record.columnOffset;
+			layer.valueOffset = (size_t)record.valueOffset;
+			layer.interpMethod = (InterpMethod)record.interpMethod;
+
+			bool validSplines = (record.splineOrder == 4 || record.splineOrder == 6) && layer.numRows > 1 &&
+				record.coefficientOffset <= count[SECTION_COEFFICIENTS] &&
+				record.coefficientCount <= count[SECTION_COEFFICIENTS] - record.coefficientOffset &&
+				record.coefficientCount == splineCoefficientCount(layer, record.splineOrder);
+			if (validSplines)
+			{
+				splines[i].order = record.splineOrder;
+				splines[i].coefficients.view(section[SECTION_COEFFICIENTS] + record.coefficientOffset, (size_t)record.coefficientCount);
 			}
-			else {
-				//3D table, no splines
+			else if (layer.interpMethod > InterpMethod::INTERP_NEAREST)
+			{
+				//no usable splines in the file, build them like a streamed in table
+				buildLayerSplines(layer, splines[i]);
 			}
 		}
+
+		detectSpacing();
+		mappedFile = file;
+		prepared.store(true, std::memory_order_release);
+		return true;
+	}
+
+	//Bytes used by the data, including the mapped file blocks it views
+	size_t memoryUsage() const
+	{
+		size_t bytes = sizeof(TableData);
+		bytes += (rowBreakpoints.capacity() + columnBreakpoints.capacity() + tableBreakpoints.capacity()) * sizeof(T);
+		bytes += values.size() * sizeof(T);
+		bytes += layers.capacity() * sizeof(TableLayer);
+		for (const TableSplines& layerSplines : splines) {
+			bytes += sizeof(TableSplines) + layerSplines.coefficients.size() * sizeof(T);
+		}
+		return bytes;
 	}
 
 	//Constructor
-	Impl() {
+	TableData() {
 
 	}
-	Impl(unsigned int numberRows, InterpMethod method);
+	TableData(unsigned int numberRows, InterpMethod method);
 
-	Impl(unsigned int numberRows, unsigned int numberColumns, InterpMethod method);
+	TableData(unsigned int numberRows, unsigned int numberColumns, InterpMethod method);
 
-	Impl(const std::vector<Table<T>>& tables, const std::vector<T>& breakpoints);
-
-	Impl(Table<T>* tables[], T breakpoints[], size_t arraySize);
+	TableData(const std::vector<const TableData*>& tables, const T* breakpoints);
 
 	bool checkInterpolationMethod(InterpMethod method)
 	{
@@ -316,44 +1842,35 @@ public:
 		return false;
 	}
 
-	void deleteData() {
-		for (unsigned int r = 0; r <= numRows; r++) delete[] data[r];
-		delete[] data;
-		data = nullptr;
-	}
-
 	//Destructor
-	~Impl() {
-		tables.clear();
-		deleteData();
+	~TableData() {
+
 	}
 
 	/// Copy constructor
-	Impl(const Impl& impl);
+	TableData(const TableData& impl);
 
 	/// Copy assignment constructor
-	Impl &operator=(const Impl &impl)
+	TableData &operator=(const TableData &impl)
 	{
-		if (data) deleteData();
+		std::lock_guard<std::mutex> lock(impl.prepareMutex);
 		dimensions = impl.dimensions;
 		numRows = impl.numRows;
 		numColumns = impl.numColumns;
 		numTables = impl.numTables;
 		rowInsertCtr = impl.rowInsertCtr;
 		columnInsertCtr = impl.columnInsertCtr;
-		lastRowIdx = impl.lastRowIdx;
-		lastColumnIdx = impl.lastColumnIdx;
 		interpMethod = impl.interpMethod;
-		tables = impl.tables;
-		data = allocateArraySize();
-		splinesBuilt = false;
-
-		for (unsigned int r = 0; r <= numRows; r++)
-		{
-			for (unsigned int c = 0; c <= numColumns; c++) {
-				data[r][c] = impl.data[r][c];
-			}
-		}
+		rowBreakpoints = impl.rowBreakpoints;
+		columnBreakpoints = impl.columnBreakpoints;
+		tableBreakpoints = impl.tableBreakpoints;
+		values = impl.values;
+		tableSpacing = impl.tableSpacing;
+		layers = impl.layers;
+		splines = impl.splines;
+		prepared.store(impl.prepared.load(std::memory_order_relaxed));
+		//the blocks were copied, nothing is viewed from a mapped file anymore
+		mappedFile.reset();
 
 		return *this;
 	}
@@ -361,7 +1878,7 @@ public:
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Impl::Impl(unsigned int numberRows, InterpMethod method)
+TableData<T>::TableData(unsigned int numberRows, InterpMethod method)
 {
 	dimensions = 1;
 	numRows = numberRows;
@@ -380,14 +1897,12 @@ Table<T>::Impl::Impl(unsigned int numberRows, InterpMethod method)
 	columnInsertCtr = 0;
 	numTables = 0;
 
-	data = allocateArraySize();
-	lastRowIdx = 2;
-	lastColumnIdx = 2;
+	allocateStorage();
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Impl::Impl(unsigned int numberRows, unsigned int numberColumns, InterpMethod method)
+TableData<T>::TableData(unsigned int numberRows, unsigned int numberColumns, InterpMethod method)
 {
 	dimensions = 2;
 	numRows = numberRows;
@@ -409,437 +1924,485 @@ Table<T>::Impl::Impl(unsigned int numberRows, unsigned int numberColumns, Interp
 		interpMethod = InterpMethod::INTERP_LINEAR;
 	}
 
-	data = allocateArraySize();
-	lastRowIdx = 2;
-	lastColumnIdx = 2;
+	allocateStorage();
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Impl::Impl(const std::vector<Table<T>>& tables, const std::vector<T>& breakpoints)
+TableData<T>::TableData(const std::vector<const TableData*>& tables, const T* breakpoints)
 {
 	numTables = (unsigned int)tables.size();
 	numRows = numTables;
 	numColumns = 1;
-	if (numTables <= 0 || breakpoints.size() != numTables)
+	if (numTables <= 0)
 		return;
 
 	dimensions = 3;
 	rowInsertCtr = 1;
 	columnInsertCtr = 1;
-	lastRowIdx = 2;
-	lastColumnIdx = 2;
 
-	data = allocateArraySize();
-	this->tables.reserve(numTables);
+	layers.reserve(numTables);
+	tableBreakpoints.assign(breakpoints, breakpoints + numTables);
 	bool allTablesNearestInterp = true;
 	for (unsigned int i = 0; i < numTables; i++)
 	{
 		//If all tables within 3d table are nearest neighbor, also make 3rd dimension nearest neighbor
-		if (tables.at(i).mImpl->interpMethod != InterpMethod::INTERP_NEAREST) {
+		if (tables[i]->interpMethod != InterpMethod::INTERP_NEAREST) {
 			allTablesNearestInterp = false;
 		}
-		this->tables.push_back(tables.at(i));
-		data[i + 1][1] = breakpoints.at(i);
+		appendLayer(*tables[i]);
 	}
+	gatherLayerValues(tables);
 
 	if (allTablesNearestInterp) {
 		interpMethod = InterpMethod::INTERP_NEAREST;
 	}
+
+	//the layer splines are in place, only the axis spacings are left to finalize
+	detectSpacing();
+	prepared.store(true, std::memory_order_release);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Impl::Impl(Table<T>* tables[], T breakpoints[], size_t arraySize)
+TableData<T>::TableData(const TableData& impl)
 {
-	numTables = (unsigned int)arraySize;
-	numRows = numTables;
-	numColumns = 1;
-	if (arraySize <= 0)
-		return;
+	*this = impl;
+}
 
-	dimensions = 3;
-	columnInsertCtr = 1;
-	rowInsertCtr = 1;
-	lastRowIdx = 2;
-	lastColumnIdx = 2;
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+class Table<T>::Impl
+{
+public:
+	Impl(TableData<T>* tableData) : data(tableData) {}
 
-	data = allocateArraySize();
-	this->tables.reserve(numTables);
-	bool allTablesNearestInterp = true;
-	for (unsigned int i = 0; i < numTables; i++)
+	//Data to modify, detached from any other table sharing it (or from the read-only mapped
+	//file it was read from) first
+	TableData<T>& write()
+	{
+		if (data.use_count() > 1 || data->mappedFile) {
+			data = std::make_shared<TableData<T>>(*data);
+		}
+		return *data;
+	}
+
+	//Table data, possibly shared with copies of this table
+	std::shared_ptr<TableData<T>> data;
+};
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+InterpMethod Table<T>::getInterpolationMethod() const
+{
+	return mImpl->data->interpMethod;
+}
+
+template <typename T>
+void Table<T>::changeInterpolationMethod(InterpMethod method)
+{
+	if (mImpl->data->interpMethod != method) {
+		if (mImpl->data->checkInterpolationMethod(method)) {
+			TableData<T>& data = mImpl->write();
+			data.interpMethod = method;
+			if (data.dimensions < 3) {
+				data.layers[0].interpMethod = method;
+			}
+			data.prepared.store(false);
+			if (data.dataComplete()) {
+				data.finalize(); //rebuild the splines for the new method now rather than on the next lookup
+			}
+		}
+		else {
+			//TODO: WARNING message for using unsupported Interpolation Method
+		}
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+unsigned int Table<T>::getNumRows() const
+{
+	return mImpl->data->numRows;
+}
+
+template <typename T>
+unsigned int Table<T>::getNumColumns() const
+{
+	return mImpl->data->numColumns;
+}
+
+template <typename T>
+unsigned int Table<T>::getNumTables() const
+{
+	return mImpl->data->numTables;
+}
+
+template <typename T>
+size_t Table<T>::getMemoryUsage() const
+{
+	return sizeof(Table<T>) + sizeof(Table<T>::Impl) + mImpl->data->memoryUsage();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+Table<T>::Table(unsigned int numberRows, InterpMethod method)
+{
+	mImpl = new Table::Impl(new TableData<T>(numberRows, method));
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+Table<T>::Table(unsigned int numberRows, unsigned int numberColumns, InterpMethod method)
+{
+	mImpl = new Table::Impl(new TableData<T>(numberRows, numberColumns, method));
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+Table<T>::Table(const std::vector<Table<T>>& tables, const std::vector<T>& breakpoints)
+{
+	std::vector<const TableData<T>*> sources;
+	if (breakpoints.size() == tables.size())
 	{
-		//If all tables within 3d table are nearest neighbor, also make 3rd dimension nearest neighbor
-		if (tables[i]->mImpl->interpMethod != InterpMethod::INTERP_NEAREST) {
-			allTablesNearestInterp = false;
+		sources.reserve(tables.size());
+		for (size_t i = 0; i < tables.size(); i++) {
+			sources.push_back(tables[i].mImpl->data.get());
 		}
-		this->tables.push_back(*tables[i]);
-		data[i + 1][1] = breakpoints[i];
 	}
+	mImpl = new Table::Impl(new TableData<T>(sources, breakpoints.data()));
+}
 
-	if (allTablesNearestInterp) {
-		interpMethod = InterpMethod::INTERP_NEAREST;
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+Table<T>::Table(Table<T>* tables[], T breakpoints[], size_t arraySize)
+{
+	std::vector<const TableData<T>*> sources;
+	sources.reserve(arraySize);
+	for (size_t i = 0; i < arraySize; i++) {
+		sources.push_back(tables[i]->mImpl->data.get());
 	}
+	mImpl = new Table::Impl(new TableData<T>(sources, breakpoints));
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Impl::Impl(const Impl& impl)
+const Table<T> &Table<T>::operator=(const Table &table)
 {
-	dimensions = impl.dimensions;
-	numRows = impl.numRows;
-	numColumns = impl.numColumns;
-	numTables = impl.numTables;
-	rowInsertCtr = impl.rowInsertCtr;
-	columnInsertCtr = impl.columnInsertCtr;
-	lastRowIdx = impl.lastRowIdx;
-	lastColumnIdx = impl.lastColumnIdx;
-	interpMethod = impl.interpMethod;
-	tables = impl.tables;
-	data = allocateArraySize();
-	splinesBuilt = false;
-
-	for (unsigned int r = 0; r <= numRows; r++)
+	if (this != &table)
 	{
-		for (unsigned int c = 0; c <= numColumns; c++) {
-			data[r][c] = impl.data[r][c];
+		if (mImpl) {
+			mImpl->data = table.mImpl->data;
+		}
+		else {
+			mImpl = new Table::Impl(*table.mImpl);
 		}
 	}
 
+	return *this;
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-InterpMethod Table<T>::getInterpolationMethod() const
+Table<T>::Table(const Table<T>& table)
 {
-	return mImpl->interpMethod;
+	mImpl = new Table<T>::Impl(*table.mImpl);
 }
 
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-void Table<T>::changeInterpolationMethod(InterpMethod method)
+Table<T>::Table(Table<T>&& table) noexcept
 {
-	if (mImpl->interpMethod != method) {
-		if (mImpl->checkInterpolationMethod(method)) {
-			mImpl->interpMethod = method;
-			mImpl->splinesBuilt = false; //splines will be rebuilt next time interp() is called
-		}
-		else {
-			//TODO: WARNING message for using unsupported Interpolation Method
-		}
-	}
+	//the moved table is left an empty one-row table, usable like any other
+	mImpl = table.mImpl;
+	table.mImpl = new Table::Impl(new TableData<T>(1, InterpMethod::INTERP_LINEAR));
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-unsigned int Table<T>::getNumRows() const
+Table<T>& Table<T>::operator=(Table<T>&& table) noexcept
 {
-	return mImpl->numRows;
+	std::swap(mImpl, table.mImpl);
+	return *this;
 }
 
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-unsigned int Table<T>::getNumColumns() const
+Table<T>::~Table()
 {
-	return mImpl->numColumns;
+	delete mImpl;
 }
 
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-unsigned int Table<T>::getNumTables() const
+T Table<T>::interp(T val, bool extrapolate) const
 {
-	return mImpl->numTables;
+	Cursor cursor;
+	return interp(val, cursor, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Table(unsigned int numberRows, InterpMethod method)
+T Table<T>::interp(T rowVal, T colVal, bool extrapolate) const
 {
-	mImpl = new Table::Impl(numberRows, method);
+	Cursor cursor;
+	return interp(rowVal, colVal, cursor, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Table(unsigned int numberRows, unsigned int numberColumns, InterpMethod method)
+T Table<T>::interp(T rowVal, T colVal, T tableVal, bool extrapolate) const
 {
-	mImpl = new Table::Impl(numberRows, numberColumns, method);
+	Cursor cursor;
+	return interp(rowVal, colVal, tableVal, cursor, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Table(const std::vector<Table<T>>& tables, const std::vector<T>& breakpoints)
+T Table<T>::interp(T val, Cursor& cursor, bool extrapolate) const
 {
-	mImpl = new Table::Impl(tables, breakpoints);
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
+		return (T)0;
+
+	data.prepare();
+
+	return data.interpLayer(0, val, cursor, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Table(Table<T>* tables[], T breakpoints[], size_t arraySize)
+T Table<T>::interp(T rowVal, T colVal, Cursor& cursor, bool extrapolate) const
 {
-	mImpl = new Table::Impl(tables, breakpoints, arraySize);
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
+		return (T)0;
+
+	data.prepare();
+
+	return data.interpLayer(0, rowVal, colVal, cursor, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-const Table<T> &Table<T>::operator=(const Table &table)
+T Table<T>::interp(T rowVal, T colVal, T tableVal, Cursor& cursor, bool extrapolate) const
 {
-	delete mImpl;
-	mImpl = new Table<T>::Impl();
-	*mImpl = *table.mImpl;
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
+		return (T)0;
 
-	return *this;
+	data.prepare();
+
+	if (data.dimensions < 3)
+		return data.interpLayer(0, rowVal, colVal, cursor, extrapolate);
+
+	return data.interpTables(rowVal, colVal, tableVal, cursor, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::Table(const Table<T>& table)
+T Table<T>::interpWithGradient(T val, T gradient[1], bool extrapolate) const
 {
-	delete mImpl;
-	mImpl = new Table<T>::Impl();
-	*mImpl = *table.mImpl;
+	Cursor cursor;
+	return interpWithGradient(val, gradient, cursor, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-Table<T>::~Table()
+T Table<T>::interpWithGradient(T rowVal, T colVal, T gradient[2], bool extrapolate) const
 {
-	delete mImpl;
+	Cursor cursor;
+	return interpWithGradient(rowVal, colVal, gradient, cursor, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-T Table<T>::interp(T val, bool extrapolate) const
+T Table<T>::interpWithGradient(T rowVal, T colVal, T tableVal, T gradient[3], bool extrapolate) const
 {
-	T interpVal = 0;
-	if (mImpl->interpMethod > InterpMethod::INTERP_NEAREST)
-	{
-		if (!mImpl->splinesBuilt)
-			mImpl->buildSplines();
-	}
+	Cursor cursor;
+	return interpWithGradient(rowVal, colVal, tableVal, gradient, cursor, extrapolate);
+}
 
-	//cannot extrapolate with Nearest Neighbor selection
-	if (mImpl->interpMethod == InterpMethod::INTERP_NEAREST) {
-		extrapolate = false;
-	}
-	//check for extrapolation
-	if (!extrapolate)
-	{
-		if (val <= mImpl->data[1][0])
-		{
-			mImpl->lastRowIdx = 2;
-			return mImpl->data[1][1];
-		}
-		else if (val >= mImpl->data[mImpl->numRows][0])
-		{
-			mImpl->lastRowIdx = mImpl->numRows;
-			return mImpl->data[mImpl->numRows][1];
-		}
-	}
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T Table<T>::interpWithGradient(T val, T gradient[1], Cursor& cursor, bool extrapolate) const
+{
+	TableData<T>& data = *mImpl->data;
+	gradient[0] = 0;
+	if (data.layers.empty())
+		return (T)0;
 
-	if (mImpl->interpMethod > InterpMethod::INTERP_NEAREST)
-	{
-		//Spline interpolation
-		interpVal = mImpl->splines.evaluate(val, mImpl->interpMethod);
-	}
-	else
-	{
-		unsigned int r = mImpl->lastRowIdx;
+	data.prepare();
 
-		while (r > 2 && mImpl->data[r - 1][0] > val) {
-			r--;
-		}
-		while (r < mImpl->numRows && mImpl->data[r][0] < val) {
-			r++;
-		}
+	return data.interpLayerGradient(0, val, cursor, extrapolate, gradient[0]);
+}
 
-		mImpl->lastRowIdx = r;
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T Table<T>::interpWithGradient(T rowVal, T colVal, T gradient[2], Cursor& cursor, bool extrapolate) const
+{
+	TableData<T>& data = *mImpl->data;
+	gradient[0] = gradient[1] = 0;
+	if (data.layers.empty())
+		return (T)0;
 
-		T rng = mImpl->data[r][0] - mImpl->data[r - 1][0];
-		T fac = 0;
-		if (rng != 0.0)
-		{
-			fac = (val - mImpl->data[r - 1][0]) / rng;
-			if (!extrapolate) {
-				fac = fac > 1.0 ? (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
-			}
-		}
-		else {
-			fac = (T)1.0;
-		}
+	data.prepare();
 
-		T interpVal;
-		if (mImpl->interpMethod == InterpMethod::INTERP_LINEAR) {
-			interpVal = fac*(mImpl->data[r][1] - mImpl->data[r - 1][1]) + mImpl->data[r - 1][1];
-		}
-		else if (mImpl->interpMethod == InterpMethod::INTERP_NEAREST)
-		{
-			if (fac < 0.5) {
-				interpVal = mImpl->data[r - 1][1];
-			}
-			else {
-				interpVal = mImpl->data[r][1];
-			}
-		}
-	}
+	return data.interpLayerGradient(0, rowVal, colVal, cursor, extrapolate, gradient[0], gradient[1]);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T Table<T>::interpWithGradient(T rowVal, T colVal, T tableVal, T gradient[3], Cursor& cursor, bool extrapolate) const
+{
+	TableData<T>& data = *mImpl->data;
+	gradient[0] = gradient[1] = gradient[2] = 0;
+	if (data.layers.empty())
+		return (T)0;
+
+	data.prepare();
+
+	if (data.dimensions < 3)
+		return data.interpLayerGradient(0, rowVal, colVal, cursor, extrapolate, gradient[0], gradient[1]);
 
-	return interpVal;
+	return data.interpTablesGradient(rowVal, colVal, tableVal, cursor, extrapolate, gradient);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-T Table<T>::interp(T rowVal, T colVal, bool extrapolate) const
+void Table<T>::prelookup(T key, TableAxis axis, Prelookup& prelookup) const
 {
-	T interpVal = 0;
-	if (mImpl->interpMethod > InterpMethod::INTERP_NEAREST)
+	TableData<T>& data = *mImpl->data;
+	data.prepare();
+
+	const T* bp = nullptr;
+	unsigned int n = 0;
+	const AxisSpacing<T>* spacing = nullptr;
+	if (!data.axisBreakpoints(axis, bp, n, spacing))
 	{
-		if (!mImpl->splinesBuilt)
-			mImpl->buildSplines();
+		//TODO: WARNING message for prelookup on an axis the table does not have (or whose layers differ)
+		TableData<T>::prelookup(bp, 0, key, AxisSpacing<T>(), prelookup);
+		return;
 	}
 
-	//cannot extrapolate with Nearest Neighbor selection
-	if (mImpl->interpMethod == InterpMethod::INTERP_NEAREST) {
-		extrapolate = false;
-	}
+	TableData<T>::prelookup(bp, n, key, *spacing, prelookup);
+}
 
-	bool outsideBounds = false;
-	outsideBounds = (rowVal <= mImpl->data[1][0] || rowVal >= mImpl->data[mImpl->numRows][0]) ||
-					(colVal <= mImpl->data[0][1] || colVal >= mImpl->data[0][mImpl->numColumns]);
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T Table<T>::interp(const Prelookup& row, bool extrapolate) const
+{
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
+		return (T)0;
 
-	if (mImpl->interpMethod > InterpMethod::INTERP_NEAREST && (!outsideBounds || (outsideBounds && extrapolate)))
-	{
-		//Spline interpolation
-		interpVal = mImpl->splines.evaluate(rowVal, colVal, mImpl->interpMethod);
-	}
-	else
-	{
-		unsigned int r = mImpl->lastRowIdx;
-		unsigned int c = mImpl->lastColumnIdx;
+	data.prepare();
 
-		while (r > 2 && mImpl->data[r - 1][0] > rowVal) {
-			r--;
-		}
-		while (r < mImpl->numRows && mImpl->data[r][0] < rowVal) {
-			r++;
-		}
+	return data.interpLayer(0, row, extrapolate);
+}
 
-		while (c > 2 && mImpl->data[0][c - 1] > colVal) {
-			c--;
-		}
-		while (c < mImpl->numColumns && mImpl->data[0][c] < colVal) {
-			c++;
-		}
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T Table<T>::interp(const Prelookup& row, const Prelookup& column, bool extrapolate) const
+{
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
+		return (T)0;
 
-		mImpl->lastRowIdx = r;	mImpl->lastColumnIdx = c;
+	data.prepare();
 
-		T rFac = (rowVal - mImpl->data[r - 1][0]) /
-			(mImpl->data[r][0] - mImpl->data[r - 1][0]);
+	return data.interpLayer(0, row, column, extrapolate);
+}
 
-		T cFac = (colVal - mImpl->data[0][c - 1]) /
-			(mImpl->data[0][c] - mImpl->data[0][c - 1]);
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+T Table<T>::interp(const Prelookup& row, const Prelookup& column, const Prelookup& table, bool extrapolate) const
+{
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
+		return (T)0;
 
-		if (!extrapolate)
-		{
-			rFac = rFac > 1.0 ? (T)1.0 : rFac < 0.0 ? (T)0.0 : rFac;
-			cFac = cFac > 1.0 ? (T)1.0 : cFac < 0.0 ? (T)0.0 : cFac;
-		}
+	data.prepare();
 
-		if (mImpl->interpMethod == InterpMethod::INTERP_NEAREST)
-		{
-			if (rFac < 0.5 && cFac < 0.5) {
-				interpVal = mImpl->data[r - 1][c - 1];
-			}
-			else if (rFac < 0.5 && cFac >= 0.5) {
-				interpVal = mImpl->data[r - 1][c];
-			}
-			else if (rFac >= 0.5 && cFac < 0.5) {
-				interpVal = mImpl->data[r][c - 1];
-			}
-			else {
-				interpVal = mImpl->data[r][c];
-			}
-		}
-		else
-		{
-			//linear
-			T lowerColVal = rFac*(mImpl->data[r][c - 1] - mImpl->data[r - 1][c - 1]) + mImpl->data[r - 1][c - 1];
-			T upperColVal = rFac*(mImpl->data[r][c] - mImpl->data[r - 1][c]) + mImpl->data[r - 1][c];
-			interpVal = lowerColVal + cFac*(upperColVal - lowerColVal);
-		}
-	}
+	if (data.dimensions < 3)
+		return data.interpLayer(0, row, column, extrapolate);
 
-	return interpVal;
+	return data.interpTables(row, column, table, extrapolate);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
-T Table<T>::interp(T rowVal, T colVal, T tableVal, bool extrapolate) const
+bool Table<T>::hasSameBreakpoints(const Table<T>& table, TableAxis axis) const
 {
-	unsigned int r = mImpl->lastRowIdx;
+	const T* bp = nullptr;
+	const T* otherBp = nullptr;
+	unsigned int n = 0, otherN = 0;
+	const AxisSpacing<T>* spacing = nullptr;
+	const TableData<T>& data = *mImpl->data;
+	const TableData<T>& otherData = *table.mImpl->data;
+	if (!data.hasAxis(axis) && !otherData.hasAxis(axis))
+		return true;
+	if (!data.axisBreakpoints(axis, bp, n, spacing) || !otherData.axisBreakpoints(axis, otherBp, otherN, spacing))
+		return false;
 
-	//cannot use spline interpolation on 3rd dimension
-	if (mImpl->interpMethod > InterpMethod::INTERP_NEAREST) {
-		mImpl->interpMethod = InterpMethod::INTERP_LINEAR;
-	}
+	return n == otherN && std::equal(bp, bp + n, otherBp);
+}
 
-	//cannot extrapolate with Nearest Neighbor selection
-	if (mImpl->interpMethod == InterpMethod::INTERP_NEAREST) {
-		extrapolate = false;
-	}
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void Table<T>::interp(const T* keys, T* out, size_t count, bool extrapolate, bool sortedKeys) const
+{
+	if (count == 0)
+		return;
 
-	if (!extrapolate)
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
 	{
-		if (tableVal <= mImpl->data[1][1])
-		{
-			mImpl->lastRowIdx = 2;
-			return mImpl->tables[0].interp(rowVal, colVal, false);
-		}
-		else if (tableVal >= mImpl->data[mImpl->numRows][1])
-		{
-			mImpl->lastRowIdx = mImpl->numRows;
-			return mImpl->tables[mImpl->numRows - 1].interp(rowVal, colVal, false);
-		}
+		std::fill(out, out + count, (T)0);
+		return;
 	}
 
+	data.prepare();
 
-	while (r > 2 && mImpl->data[r - 1][1] > tableVal) {
-		r--;
-	}
-	while (r < mImpl->numRows && mImpl->data[r][1] < tableVal) {
-		r++;
-	}
+	data.interpBatch(keys, out, count, extrapolate, sortedKeys);
+}
 
-	mImpl->lastRowIdx = r;
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void Table<T>::interp(const T* rowKeys, const T* colKeys, T* out, size_t count, bool extrapolate, bool sortedKeys) const
+{
+	if (count == 0)
+		return;
 
-	T rng = mImpl->data[r][1] - mImpl->data[r - 1][1];
-	T fac = 0;
-	if (rng != 0.0)
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
 	{
-		fac = (tableVal - mImpl->data[r - 1][1]) / rng;
-		if (!extrapolate) {
-			fac = fac > 1.0 ? fac = (T)1.0 : fac < 0.0 ? (T)0.0 : fac;
-		}
-	}
-	else {
-		fac = (T)1.0;
+		std::fill(out, out + count, (T)0);
+		return;
 	}
 
-	T table_value_low = mImpl->tables[r - 2].interp(rowVal, colVal, extrapolate);
-	T table_value_high = mImpl->tables[r - 1].interp(rowVal, colVal, extrapolate);
+	data.prepare();
+
+	data.interpBatch(rowKeys, colKeys, nullptr, out, count, extrapolate, sortedKeys);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+void Table<T>::interp(const T* rowKeys, const T* colKeys, const T* tableKeys, T* out, size_t count, bool extrapolate, bool sortedKeys) const
+{
+	if (count == 0)
+		return;
 
-	T interpVal;
-	//3D interpolation between 2D tables only allows Nearest Neighbor or Linear
-	if (mImpl->interpMethod == InterpMethod::INTERP_NEAREST)
+	TableData<T>& data = *mImpl->data;
+	if (data.layers.empty())
 	{
-		if (fac < 0.5) {
-			interpVal = table_value_low;
-		}
-		else {
-			interpVal = table_value_high;
-		}
-	}
-	else {
-		//Linear
-		interpVal = fac*(table_value_high - table_value_low) + table_value_low;
+		std::fill(out, out + count, (T)0);
+		return;
 	}
 
-	return interpVal;
+	data.prepare();
+
+	data.interpBatch(rowKeys, colKeys, tableKeys, out, count, extrapolate, sortedKeys);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -848,15 +2411,21 @@ template <typename T>
 Table<T>& Table<T>::operator<<(const T n)
 {
 	//Prevent access violation, was a common cause of runtime crashes, so check was needed
-	if (mImpl->rowInsertCtr <= mImpl->numRows && mImpl->columnInsertCtr <= mImpl->numColumns)
+	TableData<T>& data = mImpl->write();
+	T* cell = data.cell(data.rowInsertCtr, data.columnInsertCtr);
+	if (cell)
 	{
-		mImpl->data[mImpl->rowInsertCtr][mImpl->columnInsertCtr] = n;
-		if (mImpl->columnInsertCtr == (int)mImpl->numColumns) {
-			mImpl->columnInsertCtr = 0;
-			mImpl->rowInsertCtr++;
+		*cell = n;
+		if (data.columnInsertCtr == data.numColumns) {
+			data.columnInsertCtr = 0;
+			data.rowInsertCtr++;
 		}
 		else {
-			mImpl->columnInsertCtr++;
+			data.columnInsertCtr++;
+		}
+		data.prepared.store(false);
+		if (data.dataComplete()) {
+			data.finalize(); //last value is in, build the splines before the first lookup
 		}
 	}
 	else {
@@ -870,15 +2439,172 @@ template <typename T>
 Table<T>& Table<T>::operator<<(const int n)
 {
 	*this << (T)n;
-	mImpl->splinesBuilt = false;
 	return *this;
 }
 
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+bool Table<T>::readFile(const std::string& filePath)
+{
+	std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+	if (!file->open(filePath))
+	{
+		//TODO: WARNING message for table file not found
+		return false;
+	}
+
+	std::shared_ptr<TableData<T>> data = std::make_shared<TableData<T>>();
+	if (!data->readFile(file))
+	{
+		//TODO: WARNING message for invalid table file
+		return false;
+	}
+
+	mImpl->data = data;
+	return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+bool Table<T>::writeFile(const std::string& filePath) const
+{
+	if (mImpl->data->layers.empty())
+		return false;
+
+	return mImpl->data->writeFile(filePath);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+bool Table<T>::readCSV(const std::string& filePath, InterpMethod method)
+{
+	std::ifstream file(filePath);
+	if (!file)
+	{
+		//TODO: WARNING message for table file not found
+		return false;
+	}
+
+	//Numbers of each line, skipping blank lines and # comments.  An empty leading field (the
+	//corner cell of a 2D table) is dropped.
+	std::vector<std::vector<T>> lines;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		size_t first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos || line[first] == '#')
+			continue;
+
+		std::vector<T> numbers;
+		std::stringstream fields(line);
+		std::string field;
+		bool leadingField = true;
+		while (std::getline(fields, field, ','))
+		{
+			char* end = nullptr;
+			double number = strtod(field.c_str(), &end);
+			if (end == field.c_str())
+			{
+				if (leadingField && field.find_first_not_of(" \t\r") == std::string::npos) {
+					leadingField = false;
+					continue;
+				}
+				//TODO: WARNING message for invalid number in table file
+				return false;
+			}
+			numbers.push_back((T)number);
+			leadingField = false;
+		}
+		lines.push_back(numbers);
+	}
+
+	if (lines.empty())
+		return false;
+
+	//1D tables are breakpoint,value pairs.  2D tables start with the column breakpoints, then each
+	//row is its breakpoint followed by its values.
+	bool oneDimensional = lines[0].size() == 2 && lines.size() > 1 && lines[1].size() == 2;
+	unsigned int rows = (unsigned int)(oneDimensional ? lines.size() : lines.size() - 1);
+	unsigned int columns = (unsigned int)(oneDimensional ? 1 : lines[0].size());
+	if (rows < 1 || columns < 1)
+		return false;
+	for (size_t i = oneDimensional ? 0 : 1; i < lines.size(); i++)
+	{
+		if (lines[i].size() != (size_t)columns + 1)
+		{
+			//TODO: WARNING message for table file rows of different lengths
+			return false;
+		}
+	}
+
+	Table<T> table = oneDimensional ? Table<T>(rows, method) : Table<T>(rows, columns, method);
+	for (const std::vector<T>& numbers : lines) {
+		for (T n : numbers) {
+			table << n;
+		}
+	}
+
+	*this = std::move(table);
+	return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+template <typename T>
+Table<T> Table<T>::compile(T tolerance, T* maxDeviation, size_t maxValues) const
+{
+	TableData<T>& data = *mImpl->data;
+	data.prepare();
+
+	std::vector<Table<T>> layerTables;
+	T deviation = 0;
+	for (size_t k = 0; k < data.layers.size(); k++)
+	{
+		std::vector<T> rows, cols, grid;
+		T layerDeviation;
+		data.compileLayer(k, tolerance, maxValues, rows, cols, grid, layerDeviation);
+		deviation = std::max(deviation, layerDeviation);
+
+		//stream the samples into a linear table, laid out as for the stream operators
+		unsigned int nr = (unsigned int)rows.size();
+		unsigned int nc = (unsigned int)cols.size();
+		Table<T> layerTable = nc > 1 ? Table<T>(nr, nc) : Table<T>(nr);
+		if (nc > 1)
+		{
+			for (unsigned int j = 0; j < nc; j++) {
+				layerTable << cols[j];
+			}
+		}
+		for (unsigned int i = 0; i < nr; i++)
+		{
+			layerTable << rows[i];
+			for (unsigned int j = 0; j < nc; j++) {
+				layerTable << grid[(size_t)i * nc + j];
+			}
+		}
+		layerTables.push_back(std::move(layerTable));
+	}
+
+	if (maxDeviation) {
+		*maxDeviation = deviation;
+	}
+
+	if (data.dimensions == 3)
+	{
+		std::vector<T> tableBreakpoints(data.tableBreakpoints.data(), data.tableBreakpoints.data() + data.numTables);
+		return Table<T>(layerTables, tableBreakpoints);
+	}
+	if (layerTables.empty()) {
+		return Table<T>(*this);
+	}
+	return std::move(layerTables[0]);
+}
+
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 template <typename T>
 T Table<T>::get(unsigned int row, unsigned int col) const
 {
-	return mImpl->data[row][col];
+	const T* cell = mImpl->data->cell(row, col);
+	return cell ? *cell : (T)0;
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -896,4 +2622,4 @@ template class MATH_API Table<double>;
 
 } //namespace otMath
 
-//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
\ No newline at end of file
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -0,0 +1,365 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       TableKernels.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef TableKernels_H
+#define TableKernels_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+
+//TABLE_KERNELS_AVX2 implies TABLE_KERNELS_SSE2, the dispatchers below rely on it
+#if defined(_M_X64) || defined(__x86_64__)
+#define TABLE_KERNELS_SSE2
+#define TABLE_KERNELS_AVX2
+#elif (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define TABLE_KERNELS_SSE2
+#endif //_M_X64 || __x86_64__
+
+#ifdef TABLE_KERNELS_SSE2
+#include <emmintrin.h>
+#endif //TABLE_KERNELS_SSE2
+
+#ifdef TABLE_KERNELS_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TABLE_KERNELS_AVX2_TARGET
+#else
+#define TABLE_KERNELS_AVX2_TARGET __attribute__((target("avx2")))
+#endif //_MSC_VER
+#endif //TABLE_KERNELS_AVX2
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Blend kernels for the batched Table lookups.  Internal to otMath.
+
+The breakpoint search of a batch is done first, leaving for every key the offsets
+of the table cells to blend and the blend factors.  These kernels then gather the
+cells and blend them, several keys at a time.  AVX2 is used when the CPU supports
+it (checked once at runtime), otherwise SSE2, otherwise plain loops.  The
+arithmetic is the same as the scalar Table::interp() code so both give the same
+results.
+
+@author Cory Parks
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FUNCTION DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otMath {
+namespace TableKernels {
+
+//Portable versions, also used for the tail of the vector loops
+
+/// out[k] = fac[k]*(values[hi[k]] - values[lo[k]]) + values[lo[k]]
+template <typename T>
+inline void blend1DScalar(const T* values, const int* lo, const int* hi, const T* fac, T* out, size_t begin, size_t n)
+{
+	for (size_t k = begin; k < n; k++) {
+		T y0 = values[lo[k]];
+		out[k] = fac[k]*(values[hi[k]] - y0) + y0;
+	}
+}
+
+/// Bilinear blend of the cells c00 (row i, col j), c01, c10 and c11 of each key
+template <typename T>
+inline void blend2DScalar(const T* values, const int* c00, const int* c01, const int* c10, const int* c11,
+	const T* rowFac, const T* colFac, T* out, size_t begin, size_t n)
+{
+	for (size_t k = begin; k < n; k++) {
+		T lowerColVal = rowFac[k]*(values[c10[k]] - values[c00[k]]) + values[c00[k]];
+		T upperColVal = rowFac[k]*(values[c11[k]] - values[c01[k]]) + values[c01[k]];
+		out[k] = lowerColVal + colFac[k]*(upperColVal - lowerColVal);
+	}
+}
+
+/// out[k] = fac[k]*(high[k] - low[k]) + low[k]
+template <typename T>
+inline void lerpScalar(const T* low, const T* high, const T* fac, T* out, size_t begin, size_t n)
+{
+	for (size_t k = begin; k < n; k++) {
+		out[k] = fac[k]*(high[k] - low[k]) + low[k];
+	}
+}
+
+#ifdef TABLE_KERNELS_AVX2
+
+/// Does the CPU (and OS) support AVX2?  Checked once.
+inline bool detectAVX2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+	bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 &&
+		(_xgetbv(0) & 6) == 6;
+	if (!osSavesYmm)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#endif //_MSC_VER
+}
+
+inline bool hasAVX2()
+{
+	static const bool supported = detectAVX2();
+	return supported;
+}
+
+//Gathers of the cells at the 4 (double) or 8 (float) indices.  The masked form with a zero
+//source is the same instruction as _mm256_i32gather_*, whose GCC 12 header reads an
+//uninitialized source and warns under -Wall
+TABLE_KERNELS_AVX2_TARGET
+inline __m256d gatherAVX2(const double* values, const int* indices)
+{
+	__m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+	return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), values, _mm_loadu_si128((const __m128i*)indices), all, 8);
+}
+
+TABLE_KERNELS_AVX2_TARGET
+inline __m256 gatherAVX2(const float* values, const int* indices)
+{
+	__m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), values, _mm256_loadu_si256((const __m256i*)indices), all, 4);
+}
+
+TABLE_KERNELS_AVX2_TARGET
+inline size_t blend1DAVX2(const double* values, const int* lo, const int* hi, const double* fac, double* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 4 <= n; k += 4)
+	{
+		__m256d y0 = gatherAVX2(values, lo + k);
+		__m256d y1 = gatherAVX2(values, hi + k);
+		__m256d f = _mm256_loadu_pd(fac + k);
+		_mm256_storeu_pd(out + k, _mm256_add_pd(_mm256_mul_pd(f, _mm256_sub_pd(y1, y0)), y0));
+	}
+	return k;
+}
+
+TABLE_KERNELS_AVX2_TARGET
+inline size_t blend1DAVX2(const float* values, const int* lo, const int* hi, const float* fac, float* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 8 <= n; k += 8)
+	{
+		__m256 y0 = gatherAVX2(values, lo + k);
+		__m256 y1 = gatherAVX2(values, hi + k);
+		__m256 f = _mm256_loadu_ps(fac + k);
+		_mm256_storeu_ps(out + k, _mm256_add_ps(_mm256_mul_ps(f, _mm256_sub_ps(y1, y0)), y0));
+	}
+	return k;
+}
+
+TABLE_KERNELS_AVX2_TARGET
+inline size_t blend2DAVX2(const double* values, const int* c00, const int* c01, const int* c10, const int* c11,
+	const double* rowFac, const double* colFac, double* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 4 <= n; k += 4)
+	{
+		__m256d z00 = gatherAVX2(values, c00 + k);
+		__m256d z01 = gatherAVX2(values, c01 + k);
+		__m256d z10 = gatherAVX2(values, c10 + k);
+		__m256d z11 = gatherAVX2(values, c11 + k);
+		__m256d rf = _mm256_loadu_pd(rowFac + k);
+		__m256d cf = _mm256_loadu_pd(colFac + k);
+		__m256d lower = _mm256_add_pd(_mm256_mul_pd(rf, _mm256_sub_pd(z10, z00)), z00);
+		__m256d upper = _mm256_add_pd(_mm256_mul_pd(rf, _mm256_sub_pd(z11, z01)), z01);
+		_mm256_storeu_pd(out + k, _mm256_add_pd(lower, _mm256_mul_pd(cf, _mm256_sub_pd(upper, lower))));
+	}
+	return k;
+}
+
+TABLE_KERNELS_AVX2_TARGET
+inline size_t blend2DAVX2(const float* values, const int* c00, const int* c01, const int* c10, const int* c11,
+	const float* rowFac, const float* colFac, float* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 8 <= n; k += 8)
+	{
+		__m256 z00 = gatherAVX2(values, c00 + k);
+		__m256 z01 = gatherAVX2(values, c01 + k);
+		__m256 z10 = gatherAVX2(values, c10 + k);
+		__m256 z11 = gatherAVX2(values, c11 + k);
+		__m256 rf = _mm256_loadu_ps(rowFac + k);
+		__m256 cf = _mm256_loadu_ps(colFac + k);
+		__m256 lower = _mm256_add_ps(_mm256_mul_ps(rf, _mm256_sub_ps(z10, z00)), z00);
+		__m256 upper = _mm256_add_ps(_mm256_mul_ps(rf, _mm256_sub_ps(z11, z01)), z01);
+		_mm256_storeu_ps(out + k, _mm256_add_ps(lower, _mm256_mul_ps(cf, _mm256_sub_ps(upper, lower))));
+	}
+	return k;
+}
+
+#endif //TABLE_KERNELS_AVX2
+
+#ifdef TABLE_KERNELS_SSE2
+
+//SSE2 has no gather, the cells are loaded one by one and blended 2 (double) or 4 (float) at a time
+
+inline size_t blend1DSSE2(const double* values, const int* lo, const int* hi, const double* fac, double* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 2 <= n; k += 2)
+	{
+		__m128d y0 = _mm_set_pd(values[lo[k + 1]], values[lo[k]]);
+		__m128d y1 = _mm_set_pd(values[hi[k + 1]], values[hi[k]]);
+		__m128d f = _mm_loadu_pd(fac + k);
+		_mm_storeu_pd(out + k, _mm_add_pd(_mm_mul_pd(f, _mm_sub_pd(y1, y0)), y0));
+	}
+	return k;
+}
+
+inline size_t blend1DSSE2(const float* values, const int* lo, const int* hi, const float* fac, float* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 4 <= n; k += 4)
+	{
+		__m128 y0 = _mm_set_ps(values[lo[k + 3]], values[lo[k + 2]], values[lo[k + 1]], values[lo[k]]);
+		__m128 y1 = _mm_set_ps(values[hi[k + 3]], values[hi[k + 2]], values[hi[k + 1]], values[hi[k]]);
+		__m128 f = _mm_loadu_ps(fac + k);
+		_mm_storeu_ps(out + k, _mm_add_ps(_mm_mul_ps(f, _mm_sub_ps(y1, y0)), y0));
+	}
+	return k;
+}
+
+inline size_t blend2DSSE2(const double* values, const int* c00, const int* c01, const int* c10, const int* c11,
+	const double* rowFac, const double* colFac, double* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 2 <= n; k += 2)
+	{
+		__m128d z00 = _mm_set_pd(values[c00[k + 1]], values[c00[k]]);
+		__m128d z01 = _mm_set_pd(values[c01[k + 1]], values[c01[k]]);
+		__m128d z10 = _mm_set_pd(values[c10[k + 1]], values[c10[k]]);
+		__m128d z11 = _mm_set_pd(values[c11[k + 1]], values[c11[k]]);
+		__m128d rf = _mm_loadu_pd(rowFac + k);
+		__m128d cf = _mm_loadu_pd(colFac + k);
+		__m128d lower = _mm_add_pd(_mm_mul_pd(rf, _mm_sub_pd(z10, z00)), z00);
+		__m128d upper = _mm_add_pd(_mm_mul_pd(rf, _mm_sub_pd(z11, z01)), z01);
+		_mm_storeu_pd(out + k, _mm_add_pd(lower, _mm_mul_pd(cf, _mm_sub_pd(upper, lower))));
+	}
+	return k;
+}
+
+inline size_t blend2DSSE2(const float* values, const int* c00, const int* c01, const int* c10, const int* c11,
+	const float* rowFac, const float* colFac, float* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 4 <= n; k += 4)
+	{
+		__m128 z00 = _mm_set_ps(values[c00[k + 3]], values[c00[k + 2]], values[c00[k + 1]], values[c00[k]]);
+		__m128 z01 = _mm_set_ps(values[c01[k + 3]], values[c01[k + 2]], values[c01[k + 1]], values[c01[k]]);
+		__m128 z10 = _mm_set_ps(values[c10[k + 3]], values[c10[k + 2]], values[c10[k + 1]], values[c10[k]]);
+		__m128 z11 = _mm_set_ps(values[c11[k + 3]], values[c11[k + 2]], values[c11[k + 1]], values[c11[k]]);
+		__m128 rf = _mm_loadu_ps(rowFac + k);
+		__m128 cf = _mm_loadu_ps(colFac + k);
+		__m128 lower = _mm_add_ps(_mm_mul_ps(rf, _mm_sub_ps(z10, z00)), z00);
+		__m128 upper = _mm_add_ps(_mm_mul_ps(rf, _mm_sub_ps(z11, z01)), z01);
+		_mm_storeu_ps(out + k, _mm_add_ps(lower, _mm_mul_ps(cf, _mm_sub_ps(upper, lower))));
+	}
+	return k;
+}
+
+inline size_t lerpSSE2(const double* low, const double* high, const double* fac, double* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 2 <= n; k += 2)
+	{
+		__m128d l = _mm_loadu_pd(low + k);
+		__m128d h = _mm_loadu_pd(high + k);
+		_mm_storeu_pd(out + k, _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(fac + k), _mm_sub_pd(h, l)), l));
+	}
+	return k;
+}
+
+inline size_t lerpSSE2(const float* low, const float* high, const float* fac, float* out, size_t n)
+{
+	size_t k = 0;
+	for (; k + 4 <= n; k += 4)
+	{
+		__m128 l = _mm_loadu_ps(low + k);
+		__m128 h = _mm_loadu_ps(high + k);
+		_mm_storeu_ps(out + k, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(fac + k), _mm_sub_ps(h, l)), l));
+	}
+	return k;
+}
+
+#endif //TABLE_KERNELS_SSE2
+
+//Dispatching versions used by Table
+
+/// out[k] = fac[k]*(values[hi[k]] - values[lo[k]]) + values[lo[k]] for k in [0, n)
+template <typename T>
+inline void blend1D(const T* values, const int* lo, const int* hi, const T* fac, T* out, size_t n)
+{
+	size_t k = 0;
+#ifdef TABLE_KERNELS_AVX2
+	if (hasAVX2())
+		k = blend1DAVX2(values, lo, hi, fac, out, n);
+	else
+#endif //TABLE_KERNELS_AVX2
+#ifdef TABLE_KERNELS_SSE2
+	k = blend1DSSE2(values, lo, hi, fac, out, n);
+#endif //TABLE_KERNELS_SSE2
+	blend1DScalar(values, lo, hi, fac, out, k, n);
+}
+
+/// Bilinear blend of the cells c00, c01, c10, c11 for k in [0, n)
+template <typename T>
+inline void blend2D(const T* values, const int* c00, const int* c01, const int* c10, const int* c11,
+	const T* rowFac, const T* colFac, T* out, size_t n)
+{
+	size_t k = 0;
+#ifdef TABLE_KERNELS_AVX2
+	if (hasAVX2())
+		k = blend2DAVX2(values, c00, c01, c10, c11, rowFac, colFac, out, n);
+	else
+#endif //TABLE_KERNELS_AVX2
+#ifdef TABLE_KERNELS_SSE2
+	k = blend2DSSE2(values, c00, c01, c10, c11, rowFac, colFac, out, n);
+#endif //TABLE_KERNELS_SSE2
+	blend2DScalar(values, c00, c01, c10, c11, rowFac, colFac, out, k, n);
+}
+
+/// out[k] = fac[k]*(high[k] - low[k]) + low[k] for k in [0, n)
+template <typename T>
+inline void lerp(const T* low, const T* high, const T* fac, T* out, size_t n)
+{
+	size_t k = 0;
+#ifdef TABLE_KERNELS_SSE2
+	k = lerpSSE2(low, high, fac, out, n);
+#endif //TABLE_KERNELS_SSE2
+	lerpScalar(low, high, fac, out, k, n);
+}
+
+} //namespace TableKernels
+} //namespace otMath
+
+#endif //TableKernels_H
@@ -0,0 +1,243 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Header:       TableStorage.h
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef TableStorage_H
+#define TableStorage_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "Splines.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+//Storage, breakpoint search and spline packing shared by the table classes.  Internal to otMath.
+
+namespace otMath {
+
+//Heap block aligned for SIMD loads, used for the contiguous table values.  Can instead view a
+//block it does not own (a mapped table file), copies of a view always own their block.
+template <typename T>
+class AlignedArray
+{
+public:
+	AlignedArray() {}
+
+	AlignedArray(const AlignedArray& other)
+	{
+		*this = other;
+	}
+
+	AlignedArray& operator=(const AlignedArray& other)
+	{
+		if (this != &other) {
+			allocate(other.count);
+			if (count > 0) {
+				memcpy(ptr, other.ptr, count * sizeof(T));
+			}
+		}
+		return *this;
+	}
+
+	~AlignedArray()
+	{
+		release();
+	}
+
+	//Allocate a zero filled block for the given number of elements
+	void allocate(size_t numElements)
+	{
+		release();
+		if (numElements == 0)
+			return;
+
+		size_t bytes = numElements * sizeof(T);
+#ifdef _MSC_VER
+		ptr = (T*)_aligned_malloc(bytes, ALIGNMENT);
+#else
+		void* block = nullptr;
+		ptr = posix_memalign(&block, ALIGNMENT, bytes) == 0 ? (T*)block : nullptr;
+#endif
+		if (ptr) {
+			memset(ptr, 0, bytes);
+			count = numElements;
+		}
+	}
+
+	//View a block owned by someone else, which must outlive the view
+	void view(const T* block, size_t numElements)
+	{
+		release();
+		ptr = const_cast<T*>(block);
+		count = numElements;
+		owned = false;
+	}
+
+	void release()
+	{
+		if (ptr && owned) {
+#ifdef _MSC_VER
+			_aligned_free(ptr);
+#else
+			free(ptr);
+#endif
+		}
+		ptr = nullptr;
+		count = 0;
+		owned = true;
+	}
+
+	T* data() { return ptr; }
+	const T* data() const { return ptr; }
+	size_t size() const { return count; }
+
+	T& operator[](size_t i) { return ptr[i]; }
+	const T& operator[](size_t i) const { return ptr[i]; }
+
+	//Alignment in bytes (wide enough for AVX loads)
+	static const size_t ALIGNMENT = 32;
+
+private:
+	T* ptr = nullptr;
+	size_t count = 0;
+	bool owned = true;
+};
+
+//Tolerance, relative to the breakpoint spacing, for an axis to be treated as evenly spaced
+static const double UNIFORM_TOLERANCE = 1.0e-3;
+
+//Intervals walked from a search hint before bisecting the rest of the axis instead
+static const unsigned int HUNT_STEPS = 8;
+
+//Spacing of one breakpoint axis, detected when the table is prepared for interpolation.
+//Evenly spaced axes find the interval of a key directly as (key - origin) * invSpacing.
+template <typename T>
+struct AxisSpacing
+{
+	//Are the breakpoints evenly spaced?
+	bool uniform = false;
+	//First breakpoint
+	T origin = 0;
+	//1 / distance between breakpoints
+	T invSpacing = 0;
+
+	void detect(const T* bp, unsigned int n)
+	{
+		uniform = false;
+		if (n < 2)
+			return;
+
+		T spacing = (bp[n - 1] - bp[0]) / (T)(n - 1);
+		if (!(spacing > 0))
+			return;
+
+		T tolerance = (T)UNIFORM_TOLERANCE * spacing;
+		for (unsigned int i = 1; i < n - 1; i++)
+		{
+			if (std::abs(bp[i] - (bp[0] + (T)i * spacing)) > tolerance)
+				return;
+		}
+
+		origin = bp[0];
+		invSpacing = (T)1.0 / spacing;
+		uniform = true;
+	}
+};
+
+//Find the index i of the interval [bp[i], bp[i+1]] containing the key (clamped to the
+//first/last interval).  Evenly spaced axes compute the index directly, otherwise a valid
+//hint is hunted from, or the axis is bisected.  The hint is updated with the interval found.
+template <typename T>
+inline unsigned int findInterval(const T* bp, unsigned int n, T key, unsigned int& hint, const AxisSpacing<T>& spacing)
+{
+	unsigned int i = hint;
+	if (spacing.uniform)
+	{
+		T pos = (key - spacing.origin) * spacing.invSpacing;
+		i = !(pos > 0) ? 0 : pos >= (T)(n - 2) ? n - 2 : (unsigned int)pos;
+	}
+	else if (i > n - 2)
+	{
+		i = (unsigned int)(std::upper_bound(bp + 1, bp + n - 1, key) - bp) - 1;
+	}
+
+	//hunt from the hint, or correct the computed index of a nearly uniform axis.  A hint far
+	//from the key (unrelated successive keys) bisects the rest of the axis instead.
+	unsigned int steps = 0;
+	while (i > 0 && bp[i] > key)
+	{
+		if (++steps > HUNT_STEPS) {
+			i = (unsigned int)(std::upper_bound(bp + 1, bp + i, key) - bp) - 1;
+			break;
+		}
+		i--;
+	}
+	while (i < n - 2 && bp[i + 1] < key)
+	{
+		if (++steps > HUNT_STEPS) {
+			i = (unsigned int)(std::lower_bound(bp + i + 1, bp + n - 1, key) - bp) - 1;
+			break;
+		}
+		i++;
+	}
+	hint = i;
+	return i;
+}
+
+//Monomial coefficients of the Hermite basis on an interval of width h, in powers of the local
+//coordinate t = x - x[i].  Row j holds the basis of the node data (y0, y1, dy0, dy1[, ddy0, ddy1]).
+inline void hermiteMonomials(unsigned int order, Splines::valueType h, Splines::valueType basis[6][6])
+{
+	//Basis in powers of s = t/h
+	static const Splines::valueType cubic[4][4] = {
+		{ 1, 0, -3,  2 },
+		{ 0, 0,  3, -2 },
+		{ 0, 1, -2,  1 },
+		{ 0, 0, -1,  1 } };
+	static const Splines::valueType quintic[6][6] = {
+		{ 1, 0,   0, -10,  15,   -6 },
+		{ 0, 0,   0,  10, -15,    6 },
+		{ 0, 1,   0,  -6,   8,   -3 },
+		{ 0, 0,   0,  -4,   7,   -3 },
+		{ 0, 0, 0.5, -1.5, 1.5, -0.5 },
+		{ 0, 0,   0,  0.5,  -1,  0.5 } };
+
+	for (unsigned int j = 0; j < order; j++)
+	{
+		//derivative node data are scaled by h (first) or h^2 (second derivatives)
+		Splines::valueType scale = j < 2 ? 1 : j < 4 ? h : h*h;
+		Splines::valueType hk = 1;
+		for (unsigned int k = 0; k < order; k++)
+		{
+			Splines::valueType c = order == 4 ? cubic[j][k] : quintic[j][k];
+			basis[j][k] = scale * c / hk;
+			hk *= h;
+		}
+	}
+}
+
+} //namespace otMath
+
+#endif //TableStorage_H
@@ -29,6 +29,7 @@ INCLUDES
 #include "ITime.h"
 #include "Conversions.h"
 #include "Paths.h"
+#include "StaticTable.h"
 
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 CLASS IMPLEMENTATION
@@ -36,6 +37,11 @@ CLASS IMPLEMENTATION
 
 namespace otWorld {
 
+//Gravity fraction falling linearly to zero at the center, used until a body sets its own table
+static constexpr otMath::StaticTable<double, 2> defaultInternalGravityFactorTable(
+	{ { 0.0000000, 1.0000000 } },		//Radius Frac
+	{ { 0.0000000, 1.0000000 } });		//Gravity Frac
+
 class CelestialBody::Impl
 {
 public:
@@ -43,13 +49,6 @@ public:
 	{
 		//initially create an empty atmosphere and assign it to the celestial body
 		//atmosphere = Weather::AtmosphereFactory::CreateAtmosphere(Weather::NO_ATMOSPHERE);
-
-		internalGravityFactorTable = new dTable(2);
-
-		//							 Radius Frac    Gravity Frac
-		//							 -----------    -----------
-		*internalGravityFactorTable << 0.0000000 << 0.0000000
-									<< 1.0000000 << 1.0000000;
 	}
 
 	~Impl() {
@@ -69,6 +68,14 @@ public:
 	bool loadMagneticModel(MagneticModelTypes model);
 	bool loadGravityModel(GravityModelTypes model);
 
+	//Fraction of surface gravity at the given fraction of the surface radius
+	double getInternalGravityFactor(double radiusFraction) const
+	{
+		if (internalGravityFactorTable)
+			return internalGravityFactorTable->interp(radiusFraction);
+		return defaultInternalGravityFactorTable.interp(radiusFraction);
+	}
+
 	ICelestialBody* centralBody = nullptr;  //parent celestial body
 	Ellipsoid* shape = nullptr;
 
@@ -111,7 +118,7 @@ public:
 	Matrix33 ECI2ECEFTransform;
 	Matrix33 ECEF2ECITransform;
 
-	dTable* internalGravityFactorTable = nullptr; //Fraction of surface gravity as you travel toward the center of the body
+	dTable* internalGravityFactorTable = nullptr; //Fraction of surface gravity as you travel toward the center of the body (default table if not set)
 
 };
 
@@ -509,11 +516,12 @@ void CelestialBody::setInternalGravityFactorTable(const dTable& table)
 {
 	if (table.getNumRows() > 1 && table.getNumColumns() == 1)
 	{
-		//delete mImpl->internalGravityFactorTable;
-
-		//mImpl->internalGravityFactorTable = new dTable(table.getNumRows());
-
-		*mImpl->internalGravityFactorTable = table;
+		if (mImpl->internalGravityFactorTable) {
+			*mImpl->internalGravityFactorTable = table;
+		}
+		else {
+			mImpl->internalGravityFactorTable = new dTable(table);
+		}
 	}
 }
 
@@ -571,7 +579,7 @@ Vector3 CelestialBody::getGravitationalAccelerationECEF(const Vector3& ecef) con
 		}
 		else {
 			//below the surface, adjust the gravity value
-			double internalGravityFactor = mImpl->internalGravityFactorTable->interp(radius / physicalProperties.semiminorRadius);
+			double internalGravityFactor = mImpl->getInternalGravityFactor(radius / physicalProperties.semiminorRadius);
 
 			adivr = physicalProperties.semimajorRadius / physicalProperties.semiminorRadius;
 			preCommon = 1.5*physicalProperties.J2*adivr*adivr;
@@ -644,7 +652,7 @@ double CelestialBody::getGravity(double radius) const
 	}
 	else {
 		//below the surface of the celestial body, use an adjustment factor to prevent the gravity value from rising
-		double internalGravityFactor = mImpl->internalGravityFactorTable->interp(radius / physicalProperties.semiminorRadius);
+		double internalGravityFactor = mImpl->getInternalGravityFactor(radius / physicalProperties.semiminorRadius);
 		return (physicalProperties.GM / (physicalProperties.semiminorRadius*physicalProperties.semiminorRadius) * internalGravityFactor);
 	}
 }
@@ -19,6 +19,27 @@ Ellipsoid class
 NOTES
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+The closed form ECEF to geodetic conversion is the method of H. Vermeille,
+"An analytical method to transform geocentric into geodetic coordinates",
+J. Geodesy 85, 105-117 (2011), in the form GeographicLib::Geocentric uses for
+oblate ellipsoids (which guards each step against cancellation).  It solves the
+quartic for the distance along the normal with one cube root, so its cost does
+not depend on the position.
+
+The array conversions run the same formulas over a range of elements with the
+vectorizable functions of BatchMath.h in place of the standard library calls.
+The closed form batch assumes r > 0 (outside the evolute, so one real cube root of
+a positive number and u > 0); the elements where that does not hold are computed
+again with toGeodetic3 in a second, scalar pass.
+
+The distance and bearing matrices estimate a row at a time on the sphere of the
+mean radius a (1 - f / 3), from the sines and cosines of the latitudes and
+longitudes of the points (computed once per point, not once per pair), with the
+formulas of Vincenty's method on a sphere (atan2 of the cross and dot products, well
+conditioned at every distance).  The estimate is within 0.6% of the geodesic on the
+Earth; the prefilter allows max(1%, 3 f) so a pair it skips is always beyond the
+maximum distance.  Solved pairs go through the same GeographicLib calls as the
+functions for a single pair, so they give the same results.
 
 
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -29,11 +50,15 @@ INCLUDES
 
 #include <cmath>
 #include <algorithm>
+#include <functional>
+#include <vector>
 
-#include "GeographicLib\Geodesic.hpp"
-#include "GeographicLib\Geocentric.hpp"
+#include "GeographicLib/Geodesic.hpp"
+#include "GeographicLib/Geocentric.hpp"
 
 #include "Conversions.h"
+#include "BatchMath.h"
+#include "ThreadPool.h"
 
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 CLASS IMPLEMENTATION
@@ -41,6 +66,12 @@ CLASS IMPLEMENTATION
 
 namespace otWorld {
 
+// Elements per chunk when splitting array conversions across a thread pool
+static const size_t BATCH_CHUNK_SIZE = 4096;
+
+// Pairs per chunk (whole rows) when splitting solved geodesic matrices across a thread pool
+static const size_t GEODESIC_CHUNK_PAIRS = 256;
+
 // Hidden (private) implementation details
 class Ellipsoid::Impl
 {
@@ -53,13 +84,218 @@ public:
 
 	GeographicLib::Geodesic *geodesicObj = nullptr;
 	GeographicLib::Geocentric *geocentricObj = nullptr;
+
+	GeodeticConversion conversion = GeodeticConversion::ITERATIVE;
+
+	// constants of the closed form conversion, only valid if closedForm is true
+	bool closedForm = false;
+	double a = 1.0;				// equatorial radius
+	double oneOverA2 = 1.0;		// 1 / a^2
+	double e2 = 0.0;			// eccentricity squared
+	double e4 = 0.0;			// eccentricity to the fourth
+	double oneMinusE2 = 1.0;	// 1 - e2
+
+	void InitializeClosedForm();
+	Geodetic3 toGeodetic3ClosedForm(const Vector3& position) const;
+	bool isClosedFormBatchable(double x, double y, double z) const;
+
+	// the arrays never overlap, __restrict spares the compiler checking it before vectorizing
+	void toECEFBatch(const double* __restrict latitudes, const double* __restrict longitudes,
+		const double* __restrict heights, double* __restrict x, double* __restrict y, double* __restrict z,
+		size_t begin, size_t end) const;
+	void toGeodetic3ClosedFormBatch(const double* __restrict x, const double* __restrict y,
+		const double* __restrict z, double* __restrict latitudes, double* __restrict longitudes,
+		double* __restrict heights, size_t begin, size_t end) const;
 };
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+// Run function(begin, end) over the count elements of a batch, split across the
+// pool's threads if given one and the batch is worth splitting
+static void runBatch(size_t count, otCore::ThreadPool* pool, const std::function<void(size_t, size_t)>& function)
+{
+	if (pool && count >= 2 * BATCH_CHUNK_SIZE) {
+		pool->parallelFor(count, BATCH_CHUNK_SIZE, function);
+	}
+	else {
+		function(0, count);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void Ellipsoid::Impl::InitializeClosedForm()
+{
+	// only ellipsoids of revolution flattened at the poles (or spheres)
+	closedForm = (_radii[0] == _radii[1]) && (_radii[2] <= _radii[0]) && (_radii[2] > 0.0);
+	if (closedForm)
+	{
+		double f = (_radii[0] - _radii[2]) / _radii[0];
+		a = _radii[0];
+		oneOverA2 = _oneOverRadiiSquared[0];
+		e2 = f * (2.0 - f);
+		e4 = e2 * e2;
+		oneMinusE2 = (1.0 - f) * (1.0 - f);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Geodetic3 Ellipsoid::Impl::toGeodetic3ClosedForm(const Vector3& position) const
+{
+	double latitude = 0.0;
+	double longitude = 0.0;
+	double height = 0.0;
+
+	if (!position.isNull()) {
+		double R2 = position[0] * position[0] + position[1] * position[1];
+		double R = sqrt(R2);
+		double Z = position[2];
+
+		double p = R2 * oneOverA2;
+		double q = oneMinusE2 * Z * Z * oneOverA2;
+		double r = (p + q - e4) / 6.0;
+
+		if (e4 * q != 0.0 || r > 0.0)
+		{
+			double S = e4 * p * q / 4.0;
+			double r2 = r * r;
+			double r3 = r * r2;
+			double disc = S * (2.0 * r3 + S);
+
+			double u = r;
+			if (disc >= 0.0)
+			{
+				// sign of the root picked to avoid cancellation
+				double T3 = S + r3;
+				T3 += (T3 < 0.0) ? -sqrt(disc) : sqrt(disc);
+				double T = cbrt(T3);
+				u += T + ((T != 0.0) ? r2 / T : 0.0);
+			}
+			else
+			{
+				// inside the evolute of the meridian ellipse, close to the center
+				u += 2.0 * r * cos(atan2(sqrt(-disc), -(S + r3)) / 3.0);
+			}
+
+			double v = sqrt(u * u + e4 * q);
+			double uv = (u < 0.0) ? e4 * q / (v - u) : u + v;
+			double w = std::max(0.0, e2 * (uv - q) / (2.0 * v));
+			double k = uv / (sqrt(uv + w * w) + w);
+
+			// the point on the surface is at (R k / (k + e2), Z), along the normal (R / (k + e2), Z / k),
+			// both scaled here by k (k + e2) > 0.  normalR is never negative, so atan (about half the
+			// cost of atan2) gives the latitude, +-pi/2 on the axis where normalR is 0
+			double normalR = R * k;
+			double normalZ = Z * (k + e2);
+
+			latitude = atan(normalZ / normalR);
+			height = (k - oneMinusE2) * sqrt(normalR * normalR + normalZ * normalZ) / (k * (k + e2));
+		}
+		else
+		{
+			// equatorial plane inside the evolute, limit of the general case as k -> 0
+			double zz = sqrt((e4 - p) / oneMinusE2);
+			double xx = sqrt(p);
+
+			latitude = atan2((Z < 0.0) ? -zz : zz, xx);
+			height = -a * oneMinusE2 * sqrt(zz * zz + xx * xx) / e2;
+		}
+		longitude = atan2(position[1], position[0]);
+	}
+
+	return Geodetic3(latitude, longitude, height);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool Ellipsoid::Impl::isClosedFormBatchable(double x, double y, double z) const
+{
+	// r as in toGeodetic3ClosedForm, bounded so r^3 stays normal (false for NaN)
+	double p = (x * x + y * y) * oneOverA2;
+	double q = oneMinusE2 * z * z * oneOverA2;
+	double r = (p + q - e4) / 6.0;
+	return (r > 1.0e-90) && (r < 1.0e90);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void Ellipsoid::Impl::toECEFBatch(const double* __restrict latitudes, const double* __restrict longitudes,
+	const double* __restrict heights, double* __restrict x, double* __restrict y, double* __restrict z,
+	size_t begin, size_t end) const
+{
+	const double radiusSquared0 = _radiiSquared[0];
+	const double radiusSquared1 = _radiiSquared[1];
+	const double radiusSquared2 = _radiiSquared[2];
+
+	// same steps as toECEF for a Geodetic3
+	for (size_t i = begin; i < end; i++)
+	{
+		double sinLatitude, cosLatitude, sinLongitude, cosLongitude;
+		otMath::batchSinCos(latitudes[i], sinLatitude, cosLatitude);
+		otMath::batchSinCos(longitudes[i], sinLongitude, cosLongitude);
+
+		double n0 = cosLatitude * cosLongitude;
+		double n1 = cosLatitude * sinLongitude;
+		double n2 = sinLatitude;
+		double k0 = radiusSquared0 * n0;
+		double k1 = radiusSquared1 * n1;
+		double k2 = radiusSquared2 * n2;
+		double oneOverGamma = 1.0 / sqrt((k0 * n0) + (k1 * n1) + (k2 * n2));
+
+		x[i] = k0 * oneOverGamma + n0 * heights[i];
+		y[i] = k1 * oneOverGamma + n1 * heights[i];
+		z[i] = k2 * oneOverGamma + n2 * heights[i];
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void Ellipsoid::Impl::toGeodetic3ClosedFormBatch(const double* __restrict x, const double* __restrict y,
+	const double* __restrict z, double* __restrict latitudes, double* __restrict longitudes,
+	double* __restrict heights, size_t begin, size_t end) const
+{
+	// toGeodetic3ClosedForm for r > 0, where disc >= 0, T3 > 0 and u > 0 (elements outside
+	// isClosedFormBatchable get garbage here and are redone by the caller)
+	for (size_t i = begin; i < end; i++)
+	{
+		double R2 = x[i] * x[i] + y[i] * y[i];
+		double R = sqrt(R2);
+		double Z = z[i];
+
+		double p = R2 * oneOverA2;
+		double q = oneMinusE2 * Z * Z * oneOverA2;
+		double r = (p + q - e4) / 6.0;
+
+		double S = e4 * p * q / 4.0;
+		double r2 = r * r;
+		double r3 = r * r2;
+		double disc = S * (2.0 * r3 + S);
+
+		double T = otMath::batchCbrt((S + r3) + sqrt(disc));
+		double u = r + T + r2 / T;
+
+		double v = sqrt(u * u + e4 * q);
+		double uv = u + v;
+		double w = e2 * (uv - q) / (2.0 * v);
+		w = otMath::batchSelect(otMath::batchSignMask(w), 0.0, w);	// max(0, w) without a branch
+		double k = uv / (sqrt(uv + w * w) + w);
+
+		double normalR = R * k;
+		double normalZ = Z * (k + e2);
+
+		latitudes[i] = otMath::batchAtan2(normalZ, normalR);
+		longitudes[i] = otMath::batchAtan2(y[i], x[i]);
+		heights[i] = (k - oneMinusE2) * sqrt(normalR * normalR + normalZ * normalZ) / (k * (k + e2));
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 Ellipsoid::Ellipsoid(void) : mImpl(new Impl())
 {
 	mImpl->_radii = mImpl->_radiiSquared = mImpl->_radiiToTheFourth = mImpl->_oneOverRadiiSquared = Vector3(1.0, 1.0, 1.0);
+	mImpl->InitializeClosedForm();
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -118,6 +354,8 @@ void Ellipsoid::Initialize(const Vector3& radii)
 		mImpl->geodesicObj = new GeographicLib::Geodesic(radii[0], f);
 		mImpl->geocentricObj = new GeographicLib::Geocentric(radii[0], f);
 	}
+
+	mImpl->InitializeClosedForm();
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -144,6 +382,7 @@ void Ellipsoid::Initialize(double a, double f)
 	mImpl->geodesicObj = new GeographicLib::Geodesic(a, f);
 	mImpl->geocentricObj = new GeographicLib::Geocentric(a, f);
 
+	mImpl->InitializeClosedForm();
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -201,12 +440,13 @@ void Ellipsoid::getDestinationPoint(const Geodetic3& origin, Geodetic3& destinat
 {
 	DirectGeodesicFunction destinationFunction = &GeographicLib::Geodesic::VincentyDirect;
 
-	double lat1, lon1, lat2, lon2;
-
-	PreprocessDistanceData(origin, destination, lat1, lon1, lat2, lon2, distance, initialBearing, finalBearing);
+	double lat2 = 0.0, lon2 = 0.0;
+	finalBearing = 0.0;
 
 	if (mImpl->geodesicObj) {
-		getDestinationPointArbitrary(lat1, lon1, lat2, lon2, distance, initialBearing, finalBearing, *mImpl->geodesicObj, destinationFunction);
+		getDestinationPointArbitrary(RADtoDEG(origin.getLatitude()), RADtoDEG(origin.getLongitude()), lat2, lon2,
+			distance, RADtoDEG(initialBearing), finalBearing, *mImpl->geodesicObj, destinationFunction);
+		destination = Geodetic3(DEGtoRAD(lat2), DEGtoRAD(lon2), origin.getHeight());
 	}
 }
 
@@ -217,12 +457,13 @@ void Ellipsoid::getEstimatedDestinationPoint(const Geodetic3& origin, Geodetic3&
 {
 	DirectGeodesicFunction destinationFunction = &GeographicLib::Geodesic::HaversineDirect;
 
-	double lat1, lon1, lat2, lon2;
-
-	PreprocessDistanceData(origin, destination, lat1, lon1, lat2, lon2, distance, initialBearing, finalBearing);
+	double lat2 = 0.0, lon2 = 0.0;
+	finalBearing = 0.0;
 
 	if (mImpl->geodesicObj) {
-		getDestinationPointArbitrary(lat1, lon1, lat2, lon2, distance, initialBearing, finalBearing, *mImpl->geodesicObj, destinationFunction);
+		getDestinationPointArbitrary(RADtoDEG(origin.getLatitude()), RADtoDEG(origin.getLongitude()), lat2, lon2,
+			distance, RADtoDEG(initialBearing), finalBearing, *mImpl->geodesicObj, destinationFunction);
+		destination = Geodetic3(DEGtoRAD(lat2), DEGtoRAD(lon2), origin.getHeight());
 	}
 }
 
@@ -392,6 +633,17 @@ Vector3 Ellipsoid::toECEF(const Geodetic2& geodetic) const
 
 Geodetic3 Ellipsoid::toGeodetic3(const Vector3& position) const
 {
+	return toGeodetic3(position, mImpl->conversion);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Geodetic3 Ellipsoid::toGeodetic3(const Vector3& position, GeodeticConversion conversion) const
+{
+	if (conversion == GeodeticConversion::CLOSED_FORM && mImpl->closedForm) {
+		return mImpl->toGeodetic3ClosedForm(position);
+	}
+
 	double latitude = 0.0;
 	double longitude = 0.0;
 	double height = 0.0;
@@ -421,6 +673,224 @@ Geodetic2 Ellipsoid::toGeodetic2(const Vector3& position) const
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+Geodetic2 Ellipsoid::toGeodetic2(const Vector3& position, GeodeticConversion conversion) const
+{
+	Geodetic3 geod3 = toGeodetic3(position, conversion);
+
+	return Geodetic2(geod3.getLatitude(), geod3.getLongitude());
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void Ellipsoid::setGeodeticConversion(GeodeticConversion conversion)
+{
+	mImpl->conversion = conversion;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+GeodeticConversion Ellipsoid::getGeodeticConversion(void) const
+{
+	return mImpl->conversion;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void Ellipsoid::toECEF(const double* latitudes, const double* longitudes, const double* heights,
+	double* x, double* y, double* z, size_t count, otCore::ThreadPool* pool) const
+{
+	runBatch(count, pool, [&](size_t begin, size_t end) {
+		mImpl->toECEFBatch(latitudes, longitudes, heights, x, y, z, begin, end);
+
+		// angles beyond the range of the batch sine and cosine (or not finite)
+		for (size_t i = begin; i < end; i++)
+		{
+			if (!(fabs(latitudes[i]) <= otMath::BATCH_SINCOS_MAX && fabs(longitudes[i]) <= otMath::BATCH_SINCOS_MAX))
+			{
+				Vector3 position = toECEF(Geodetic3(latitudes[i], longitudes[i], heights[i]));
+				x[i] = position[0];
+				y[i] = position[1];
+				z[i] = position[2];
+			}
+		}
+	});
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void Ellipsoid::toGeodetic3(const double* x, const double* y, const double* z,
+	double* latitudes, double* longitudes, double* heights, size_t count, otCore::ThreadPool* pool) const
+{
+	toGeodetic3(x, y, z, latitudes, longitudes, heights, count, mImpl->conversion, pool);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void Ellipsoid::toGeodetic3(const double* x, const double* y, const double* z,
+	double* latitudes, double* longitudes, double* heights, size_t count,
+	GeodeticConversion conversion, otCore::ThreadPool* pool) const
+{
+	bool closedForm = (conversion == GeodeticConversion::CLOSED_FORM && mImpl->closedForm);
+
+	runBatch(count, pool, [&](size_t begin, size_t end) {
+		if (closedForm) {
+			mImpl->toGeodetic3ClosedFormBatch(x, y, z, latitudes, longitudes, heights, begin, end);
+		}
+
+		// elements the batch does not handle, or all of them for the iterative conversion
+		for (size_t i = begin; i < end; i++)
+		{
+			if (!closedForm || !mImpl->isClosedFormBatchable(x[i], y[i], z[i]))
+			{
+				Geodetic3 geodetic = toGeodetic3(Vector3(x[i], y[i], z[i]), conversion);
+				latitudes[i] = geodetic.getLatitude();
+				longitudes[i] = geodetic.getLongitude();
+				heights[i] = geodetic.getHeight();
+			}
+		}
+	});
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+// Points of a geodesic matrix, in degrees for GeographicLib and as sines and cosines for the estimate
+struct GeodesicPoints
+{
+	std::vector<double> latitudes;
+	std::vector<double> longitudes;
+	std::vector<double> sinLatitudes;
+	std::vector<double> cosLatitudes;
+	std::vector<double> sinLongitudes;
+	std::vector<double> cosLongitudes;
+
+	GeodesicPoints(const double* lat, const double* lon, size_t count) :
+		latitudes(count), longitudes(count), sinLatitudes(count), cosLatitudes(count),
+		sinLongitudes(count), cosLongitudes(count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			latitudes[i] = RADtoDEG(lat[i]);
+			longitudes[i] = RADtoDEG(lon[i]);
+			sinLatitudes[i] = sin(lat[i]);
+			cosLatitudes[i] = cos(lat[i]);
+			sinLongitudes[i] = sin(lon[i]);
+			cosLongitudes[i] = cos(lon[i]);
+		}
+	}
+};
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+// Estimated distances and bearings from origin o of the points to each of the destinations
+static void estimateGeodesicRow(double radius, const GeodesicPoints& origins, size_t o,
+	const double* __restrict sinLatitudes, const double* __restrict cosLatitudes,
+	const double* __restrict sinLongitudes, const double* __restrict cosLongitudes,
+	double* __restrict distances, double* __restrict initialBearings, double* __restrict finalBearings,
+	size_t count)
+{
+	const double TWO_PI = 2.0 * PI;
+	const double sinLatitude = origins.sinLatitudes[o];
+	const double cosLatitude = origins.cosLatitudes[o];
+	const double sinLongitude = origins.sinLongitudes[o];
+	const double cosLongitude = origins.cosLongitudes[o];
+
+	for (size_t j = 0; j < count; j++)
+	{
+		double cosDeltaLongitude = cosLongitudes[j] * cosLongitude + sinLongitudes[j] * sinLongitude;
+		double sinDeltaLongitude = sinLongitudes[j] * cosLongitude - cosLongitudes[j] * sinLongitude;
+
+		double y = sinDeltaLongitude * cosLatitudes[j];
+		double x = cosLatitude * sinLatitudes[j] - sinLatitude * cosLatitudes[j] * cosDeltaLongitude;
+		double cosAngle = sinLatitude * sinLatitudes[j] + cosLatitude * cosLatitudes[j] * cosDeltaLongitude;
+		distances[j] = radius * otMath::batchAtan2(sqrt(x * x + y * y), cosAngle);
+
+		// adding 0 turns -0 into 0, so only negative bearings get 2 pi
+		double initialBearing = otMath::batchAtan2(y, x) + 0.0;
+		double finalBearing = otMath::batchAtan2(sinDeltaLongitude * cosLatitude,
+			cosLatitude * sinLatitudes[j] * cosDeltaLongitude - sinLatitude * cosLatitudes[j]) + 0.0;
+		initialBearings[j] = otMath::batchSelect(otMath::batchSignMask(initialBearing), initialBearing + TWO_PI, initialBearing);
+		finalBearings[j] = otMath::batchSelect(otMath::batchSignMask(finalBearing), finalBearing + TWO_PI, finalBearing);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void Ellipsoid::getDistanceAndBearingMatrix(const double* originLatitudes, const double* originLongitudes, size_t numOrigins,
+	const double* destinationLatitudes, const double* destinationLongitudes, size_t numDestinations,
+	double* distances, double* initialBearings, double* finalBearings,
+	GeodesicSolution solution, double maxDistance, otCore::ThreadPool* pool) const
+{
+	size_t numPairs = numOrigins * numDestinations;
+	if (numPairs == 0) return;
+
+	if (!mImpl->geodesicObj)
+	{
+		std::fill(distances, distances + numPairs, 0.0);
+		if (initialBearings) std::fill(initialBearings, initialBearings + numPairs, 0.0);
+		if (finalBearings) std::fill(finalBearings, finalBearings + numPairs, 0.0);
+		return;
+	}
+
+	const GeographicLib::Geodesic& geodesic = *mImpl->geodesicObj;
+	double flattening = geodesic.Flattening();
+	double meanRadius = geodesic.MajorRadius() * (1.0 - flattening / 3.0);
+
+	bool estimate = (solution == GeodesicSolution::ESTIMATED) || (maxDistance > 0.0);
+	double maxEstimate = maxDistance * (1.0 + std::max(0.01, 3.0 * fabs(flattening)));
+	InverseGeodesicFunction distanceFunction = (solution == GeodesicSolution::VINCENTY) ?
+		&GeographicLib::Geodesic::VincentyInverse : &GeographicLib::Geodesic::KarneyInverse;
+
+	GeodesicPoints origins(originLatitudes, originLongitudes, numOrigins);
+	GeodesicPoints destinations(destinationLatitudes, destinationLongitudes, numDestinations);
+
+	std::function<void(size_t, size_t)> solveRows = [&](size_t begin, size_t end) {
+		// rows of the bearing matrices not asked for
+		std::vector<double> initialRow(initialBearings ? 0 : numDestinations);
+		std::vector<double> finalRow(finalBearings ? 0 : numDestinations);
+
+		for (size_t i = begin; i < end; i++)
+		{
+			size_t row = i * numDestinations;
+			double* distance = distances + row;
+			double* initialBearing = initialBearings ? initialBearings + row : initialRow.data();
+			double* finalBearing = finalBearings ? finalBearings + row : finalRow.data();
+
+			if (estimate)
+			{
+				estimateGeodesicRow(meanRadius, origins, i,
+					destinations.sinLatitudes.data(), destinations.cosLatitudes.data(),
+					destinations.sinLongitudes.data(), destinations.cosLongitudes.data(),
+					distance, initialBearing, finalBearing, numDestinations);
+			}
+			if (solution == GeodesicSolution::ESTIMATED) continue;
+
+			for (size_t j = 0; j < numDestinations; j++)
+			{
+				if (maxDistance > 0.0 && !(distance[j] <= maxEstimate)) continue;
+
+				double s12 = 0.0, azi1 = 0.0, azi2 = 0.0;
+				getDistanceAndBearingArbitrary(origins.latitudes[i], origins.longitudes[i],
+					destinations.latitudes[j], destinations.longitudes[j], s12, azi1, azi2,
+					*mImpl->geodesicObj, distanceFunction);
+				distance[j] = s12;
+				initialBearing[j] = azi1;
+				finalBearing[j] = azi2;
+			}
+		}
+	};
+
+	if (pool)
+	{
+		size_t chunkPairs = (solution == GeodesicSolution::ESTIMATED) ? BATCH_CHUNK_SIZE : GEODESIC_CHUNK_PAIRS;
+		pool->parallelFor(numOrigins, std::max<size_t>(1, chunkPairs / numDestinations), solveRows);
+	}
+	else {
+		solveRows(0, numOrigins);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 Vector3 Ellipsoid::ScaleToGeodeticSurface(const Vector3& position) const
 {
 	double beta = 1.0 / sqrt(
@@ -0,0 +1,404 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       GeodesicRoute.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+Route of geodesic legs between waypoints, for sampling many points along it.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+NOTES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+A leg is built with InverseLine, which solves the inverse problem between its
+endpoints once and keeps the coefficients of the series in the arc length for
+latitude, longitude and distance.  A point at a distance then inverts the distance
+series and evaluates the others; a point at an arc length skips the inversion.
+
+A leg holds only the line of the route's kind, GeodesicLine or GeodesicLineExact
+(LineLeg), behind a virtual position function.  The virtual call is nothing next to
+the series evaluation it leads to.
+
+Legs are immutable once built and shared (std::shared_ptr) between the cache and
+the route, so a leg dropped from the cache stays valid while the route uses it.
+The cache key is the endpoints exactly as given, so a waypoint moved by any amount
+is a new leg.  The cached legs are kept in a list from the most to the least
+recently used, a leg found or built moving to the front, and the legs not in the
+route are dropped from the back.
+
+The route keeps the distance and the arc length from its start to each waypoint,
+and finds the leg of a point by binary search in them.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "GeodesicRoute.h"
+
+#include <algorithm>
+#include <array>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "GeographicLib/Geodesic.hpp"
+#include "GeographicLib/GeodesicLine.hpp"
+#include "GeographicLib/GeodesicExact.hpp"
+#include "GeographicLib/GeodesicLineExact.hpp"
+
+#include "Ellipsoid.h"
+#include "Conversions.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otWorld {
+
+// Leg between two waypoints
+struct RouteLeg
+{
+	virtual ~RouteLeg() {}
+
+	// Latitude, longitude and azimuth (degrees) at a distance (m) or arc length (degrees) along the leg
+	virtual void position(bool arcMode, double along, double& latitude, double& longitude, double& azimuth) const = 0;
+
+	double length = 0.0;	// m
+	double arc = 0.0;		// degrees on the auxiliary sphere
+};
+
+// Leg on a GeodesicLine or a GeodesicLineExact, the line of the route's kind
+template <typename Line>
+struct LineLeg : public RouteLeg
+{
+	explicit LineLeg(const Line& lineIn) : line(lineIn)
+	{
+		length = line.Distance();
+		arc = line.Arc();
+	}
+
+	void position(bool arcMode, double along, double& latitude, double& longitude, double& azimuth) const override
+	{
+		double unused;
+		line.GenPosition(arcMode, along, Line::LATITUDE | Line::LONGITUDE | Line::AZIMUTH,
+			latitude, longitude, azimuth, unused, unused, unused, unused, unused);
+	}
+
+	Line line;
+};
+
+// Endpoints of a leg (lat1, lon1, lat2, lon2)
+typedef std::array<double, 4> LegKey;
+
+// Cached leg, in the list from the most to the least recently used
+struct CachedLeg
+{
+	LegKey key;
+	std::shared_ptr<const RouteLeg> leg;
+};
+
+// Hidden (private) implementation details
+class GeodesicRoute::Impl
+{
+public:
+	bool exact = false;
+	std::unique_ptr<GeographicLib::Geodesic> geodesic;
+	std::unique_ptr<GeographicLib::GeodesicExact> geodesicExact;
+
+	std::vector<Geodetic2> waypoints;
+	std::vector<std::shared_ptr<const RouteLeg>> legs;
+	std::vector<double> distances;	// from the start to each waypoint (m)
+	std::vector<double> arcs;		// from the start to each waypoint (degrees)
+
+	std::list<CachedLeg> recentLegs;	// most recently used first
+	std::map<LegKey, std::list<CachedLeg>::iterator> cache;
+	size_t maxCachedLegs = 1024;
+	unsigned long long numLegsBuilt = 0;
+
+	bool hasGeodesic() const { return geodesic || geodesicExact; }
+	void appendLeg(const Geodetic2& from, const Geodetic2& to);
+	void trimCache();
+	void position(bool arcMode, double along, double& latitude, double& longitude, double* bearing) const;
+};
+
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodesicRoute::Impl::appendLeg(const Geodetic2& from, const Geodetic2& to)
+{
+	LegKey key = { { from.getLatitude(), from.getLongitude(), to.getLatitude(), to.getLongitude() } };
+
+	auto found = cache.find(key);
+	if (found != cache.end())
+	{
+		// most recently used from now on
+		recentLegs.splice(recentLegs.begin(), recentLegs, found->second);
+	}
+	else
+	{
+		const unsigned caps = GeographicLib::Geodesic::LATITUDE | GeographicLib::Geodesic::LONGITUDE |
+			GeographicLib::Geodesic::AZIMUTH | GeographicLib::Geodesic::DISTANCE_IN;
+		double lat1 = RADtoDEG(from.getLatitude());
+		double lon1 = RADtoDEG(from.getLongitude());
+		double lat2 = RADtoDEG(to.getLatitude());
+		double lon2 = RADtoDEG(to.getLongitude());
+
+		std::shared_ptr<const RouteLeg> leg;
+		if (exact) {
+			leg = std::make_shared<LineLeg<GeographicLib::GeodesicLineExact>>(geodesicExact->InverseLine(lat1, lon1, lat2, lon2, caps));
+		}
+		else {
+			leg = std::make_shared<LineLeg<GeographicLib::GeodesicLine>>(geodesic->InverseLine(lat1, lon1, lat2, lon2, caps));
+		}
+		recentLegs.push_front(CachedLeg{ key, leg });
+		found = cache.emplace(key, recentLegs.begin()).first;
+		numLegsBuilt++;
+	}
+
+	const std::shared_ptr<const RouteLeg>& cached = found->second->leg;
+	legs.push_back(cached);
+	distances.push_back(distances.back() + cached->length);
+	arcs.push_back(arcs.back() + cached->arc);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodesicRoute::Impl::trimCache()
+{
+	// drop the least recently used legs the route does not use (the cache holds their only reference)
+	for (auto it = recentLegs.end(); it != recentLegs.begin() && cache.size() > maxCachedLegs;)
+	{
+		--it;
+		if (it->leg.use_count() == 1)
+		{
+			cache.erase(it->key);
+			it = recentLegs.erase(it);
+		}
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodesicRoute::Impl::position(bool arcMode, double along, double& latitude, double& longitude, double* bearing) const
+{
+	latitude = 0.0;
+	longitude = 0.0;
+	if (bearing) *bearing = 0.0;
+
+	if (legs.empty())
+	{
+		if (!waypoints.empty())
+		{
+			latitude = waypoints[0].getLatitude();
+			longitude = waypoints[0].getLongitude();
+		}
+		return;
+	}
+
+	// leg starting at the last waypoint not beyond the point (the last leg at the end)
+	const std::vector<double>& starts = arcMode ? arcs : distances;
+	along = std::min(std::max(along, 0.0), starts.back());
+	size_t leg = std::upper_bound(starts.begin(), starts.end(), along) - starts.begin();
+	leg = std::min(std::max(leg, (size_t)1), legs.size()) - 1;
+
+	double lat2, lon2, azi2;
+	legs[leg]->position(arcMode, along - starts[leg], lat2, lon2, azi2);
+
+	latitude = DEGtoRAD(lat2);
+	longitude = DEGtoRAD(lon2);
+	if (bearing)
+	{
+		if (azi2 < 0) azi2 += 360.0;
+		*bearing = DEGtoRAD(azi2);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+GeodesicRoute::GeodesicRoute(const Ellipsoid& ellipsoid, bool exact) : mImpl(new GeodesicRoute::Impl())
+{
+	mImpl->exact = exact;
+	mImpl->distances.push_back(0.0);
+	mImpl->arcs.push_back(0.0);
+
+	// same condition as the geodesic of the ellipsoid
+	const Vector3& radii = ellipsoid.getRadii();
+	if (radii[0] == radii[1] && radii[0] > 0.0)
+	{
+		double f = (radii[0] - radii[2]) / radii[0];
+		if (exact) {
+			mImpl->geodesicExact.reset(new GeographicLib::GeodesicExact(radii[0], f));
+		}
+		else {
+			mImpl->geodesic.reset(new GeographicLib::Geodesic(radii[0], f));
+		}
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+GeodesicRoute::~GeodesicRoute()
+{
+	delete mImpl;
+	mImpl = nullptr;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool GeodesicRoute::setWaypoints(const Geodetic2* waypoints, size_t count)
+{
+	// the legs are released only after the new ones are looked up, so unchanged legs are found
+	std::vector<std::shared_ptr<const RouteLeg>> previousLegs;
+	previousLegs.swap(mImpl->legs);
+	clearWaypoints();
+
+	if (!mImpl->hasGeodesic())
+	{
+		//TODO: WARNING, no geodesics on an ellipsoid with different X and Y radii
+		return false;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		addWaypoint(waypoints[i]);
+	}
+	previousLegs.clear();
+	mImpl->trimCache();
+	return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool GeodesicRoute::addWaypoint(const Geodetic2& waypoint)
+{
+	if (!mImpl->hasGeodesic())
+	{
+		//TODO: WARNING, no geodesics on an ellipsoid with different X and Y radii
+		return false;
+	}
+
+	if (!mImpl->waypoints.empty())
+	{
+		mImpl->appendLeg(mImpl->waypoints.back(), waypoint);
+		if (mImpl->cache.size() > mImpl->maxCachedLegs) {
+			mImpl->trimCache();
+		}
+	}
+	mImpl->waypoints.push_back(waypoint);
+	return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodesicRoute::clearWaypoints(void)
+{
+	mImpl->waypoints.clear();
+	mImpl->legs.clear();
+	mImpl->distances.assign(1, 0.0);
+	mImpl->arcs.assign(1, 0.0);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+size_t GeodesicRoute::getNumWaypoints(void) const
+{
+	return mImpl->waypoints.size();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Geodetic2 GeodesicRoute::getWaypoint(size_t index) const
+{
+	if (index >= mImpl->waypoints.size()) return Geodetic2();
+	return mImpl->waypoints[index];
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+double GeodesicRoute::getLength(void) const
+{
+	return mImpl->distances.back();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+double GeodesicRoute::getLegLength(size_t leg) const
+{
+	if (leg >= mImpl->legs.size()) return 0.0;
+	return mImpl->legs[leg]->length;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Geodetic2 GeodesicRoute::getPoint(double distance, double* bearing) const
+{
+	double latitude, longitude;
+	mImpl->position(false, distance, latitude, longitude, bearing);
+	return Geodetic2(latitude, longitude);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodesicRoute::sample(size_t count, double* latitudes, double* longitudes, double* bearings,
+	RouteSpacing spacing) const
+{
+	bool arcMode = (spacing == RouteSpacing::ARC_LENGTH);
+	double total = arcMode ? mImpl->arcs.back() : mImpl->distances.back();
+	double step = (count > 1) ? total / (double)(count - 1) : 0.0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		// the last point exactly at the end
+		double along = (i + 1 == count) ? total : step * (double)i;
+		mImpl->position(arcMode, along, latitudes[i], longitudes[i], bearings ? bearings + i : nullptr);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodesicRoute::sample(const double* distances, size_t count, double* latitudes, double* longitudes,
+	double* bearings) const
+{
+	for (size_t i = 0; i < count; i++) {
+		mImpl->position(false, distances[i], latitudes[i], longitudes[i], bearings ? bearings + i : nullptr);
+	}
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodesicRoute::setMaxCachedLegs(size_t maxCachedLegs)
+{
+	mImpl->maxCachedLegs = maxCachedLegs;
+	mImpl->trimCache();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+size_t GeodesicRoute::getMaxCachedLegs(void) const
+{
+	return mImpl->maxCachedLegs;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+size_t GeodesicRoute::getNumCachedLegs(void) const
+{
+	return mImpl->cache.size();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+unsigned long long GeodesicRoute::getNumLegsBuilt(void) const
+{
+	return mImpl->numLegsBuilt;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+} //namespace otWorld
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -0,0 +1,313 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Module:       GeodeticConverter.cpp
+Author:       Cory Parks
+Date started: 09/2017
+
+See LICENSE file for copyright and license information
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+ECEF to geodetic conversion for the successive positions of one entity
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+NOTES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+The surface point is the position divided by 1 + alpha / radius^2 on each axis,
+with alpha the root of the ellipsoid equation found by Newton iteration as in
+Ellipsoid::ScaleToGeodeticSurface.  alpha is about the height over the surface
+times the radius, so the previous alpha is within the move of the new one, and
+for a move of a few meters the first Newton step is already below the tolerance.
+The iteration stops after a step below the tolerance rather than on the residual,
+so the last step (quadratic convergence) leaves an error far smaller than the step.
+The position is the surface point plus alpha times the normal divided by the radii
+squared, which gives the height.
+
+The latitude and longitude increments are the angles between the previous and new
+surface normals in the meridian and equatorial planes, atan(t) with t the tangent
+from their cross and dot products, by its series for |t| <= 0.01 (error below
+t^11 / 11).  The increments are added to the previous angles, so their rounding
+accumulates, a full conversion every 64 resets it.
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "GeodeticConverter.h"
+#include "Ellipsoid.h"
+
+#include <cmath>
+
+#include "Conversions.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace otWorld {
+
+// Newton step on alpha, relative to the radius squared, after which the iteration stops.
+// About 6 mm of height on the Earth, the error after that step is below a nanometer.
+static const double SURFACE_STEP_TOLERANCE = 1e-9;
+
+// Evaluations a warm start may take (its first step is usually the last)
+static const int WARM_EVALUATIONS = 3;
+
+// Evaluations a full conversion may take
+static const int FULL_EVALUATIONS = 100;
+
+// Warm started conversions between full ones
+static const int WARM_CONVERSIONS = 63;
+
+// Largest tangent of an angle increment taken by series
+static const double SMALL_TANGENT = 0.01;
+
+// atan(t) for |t| <= SMALL_TANGENT
+static inline double smallAtan(double t)
+{
+	double t2 = t * t;
+	return t * (1.0 - t2 * (1.0 / 3.0 - t2 * (1.0 / 5.0 - t2 * (1.0 / 7.0 - t2 * (1.0 / 9.0)))));
+}
+
+// Hidden (private) implementation details
+class GeodeticConverter::Impl
+{
+public:
+	Impl(const Ellipsoid& ellipsoidIn) : ellipsoid(ellipsoidIn), oneOverRadiiSquared(ellipsoidIn.getOneOverRadiiSquared()) {}
+
+	const Ellipsoid& ellipsoid;
+	const Vector3& oneOverRadiiSquared;	// the ellipsoid's own, not a copy
+	double maxWarmStep = 10000.0;
+
+	// previous conversion, only valid if valid is true.  normal is the surface normal
+	// not normalized (the surface point divided by the radii squared), horizontal its
+	// length in the equatorial plane
+	bool valid = false;
+	Vector3 position;
+	double alpha = 0.0;
+	Vector3 normal;
+	double horizontal = 1.0;
+	double latitude = 0.0;
+	double longitude = 0.0;
+	int warmConversions = 0;		// since the last full conversion
+
+	unsigned long long numWarmConversions = 0;
+	unsigned long long numFullConversions = 0;
+
+	bool scaleToSurface(const Vector3& positionIn, double& alphaInOut, int maxEvaluations, Vector3& normalOut) const;
+	Geodetic3 fullConversion(const Vector3& positionIn);
+	bool warmConversion(const Vector3& positionIn, Geodetic3& geodetic);
+};
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool GeodeticConverter::Impl::scaleToSurface(const Vector3& positionIn, double& alphaInOut, int maxEvaluations, Vector3& normalOut) const
+{
+	double x2 = positionIn[0] * positionIn[0];
+	double y2 = positionIn[1] * positionIn[1];
+	double z2 = positionIn[2] * positionIn[2];
+
+	for (int evaluation = 0; evaluation < maxEvaluations; evaluation++)
+	{
+		// the surface point is the position times oneOverDa, oneOverDb, oneOverDc
+		double oneOverDa = 1.0 / (1.0 + (alphaInOut * oneOverRadiiSquared[0]));
+		double oneOverDb = 1.0 / (1.0 + (alphaInOut * oneOverRadiiSquared[1]));
+		double oneOverDc = 1.0 / (1.0 + (alphaInOut * oneOverRadiiSquared[2]));
+
+		double sa = x2 * oneOverRadiiSquared[0] * oneOverDa * oneOverDa;
+		double sb = y2 * oneOverRadiiSquared[1] * oneOverDb * oneOverDb;
+		double sc = z2 * oneOverRadiiSquared[2] * oneOverDc * oneOverDc;
+
+		double s = sa + sb + sc - 1.0;
+		double dSdA = -2.0 *
+			(sa * oneOverRadiiSquared[0] * oneOverDa +
+				sb * oneOverRadiiSquared[1] * oneOverDb +
+				sc * oneOverRadiiSquared[2] * oneOverDc);
+
+		double step = s / dSdA;
+		if (fabs(step * oneOverRadiiSquared[0]) <= SURFACE_STEP_TOLERANCE)
+		{
+			// the last step is below the tolerance, take it and return the normal there
+			alphaInOut -= step;
+			normalOut = Vector3(
+				positionIn[0] * oneOverRadiiSquared[0] / (1.0 + (alphaInOut * oneOverRadiiSquared[0])),
+				positionIn[1] * oneOverRadiiSquared[1] / (1.0 + (alphaInOut * oneOverRadiiSquared[1])),
+				positionIn[2] * oneOverRadiiSquared[2] / (1.0 + (alphaInOut * oneOverRadiiSquared[2])));
+			return true;
+		}
+		alphaInOut -= step;
+	}
+	return false;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Geodetic3 GeodeticConverter::Impl::fullConversion(const Vector3& positionIn)
+{
+	// start from the estimate of Ellipsoid::ScaleToGeodeticSurface
+	double beta = 1.0 / sqrt(
+		(positionIn[0] * positionIn[0]) * oneOverRadiiSquared[0] +
+		(positionIn[1] * positionIn[1]) * oneOverRadiiSquared[1] +
+		(positionIn[2] * positionIn[2]) * oneOverRadiiSquared[2]);
+	double n = Vector3(
+		beta * positionIn[0] * oneOverRadiiSquared[0],
+		beta * positionIn[1] * oneOverRadiiSquared[1],
+		beta * positionIn[2] * oneOverRadiiSquared[2]).magnitude();
+	double alphaStart = (1.0 - beta) * (positionIn.magnitude() / n);
+
+	Vector3 newNormal;
+	if (!scaleToSurface(positionIn, alphaStart, FULL_EVALUATIONS, newNormal))
+	{
+		//TODO: WARNING - no convergence, fall back to the ellipsoid's conversion and no warm start
+		valid = false;
+		return ellipsoid.toGeodetic3(positionIn, GeodeticConversion::ITERATIVE);
+	}
+
+	valid = true;
+	position = positionIn;
+	alpha = alphaStart;
+	normal = newNormal;
+	horizontal = sqrt(normal[0] * normal[0] + normal[1] * normal[1]);
+	latitude = atan2(normal[2], horizontal);
+	longitude = atan2(normal[1], normal[0]);
+	warmConversions = 0;
+	numFullConversions++;
+
+	// the position is the surface point plus alpha times the normal
+	return Geodetic3(latitude, longitude, alpha * sqrt(horizontal * horizontal + normal[2] * normal[2]));
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool GeodeticConverter::Impl::warmConversion(const Vector3& positionIn, Geodetic3& geodetic)
+{
+	if (!valid || warmConversions >= WARM_CONVERSIONS) return false;
+
+	Vector3 step = positionIn - position;
+	if (!(step.dot(step) <= maxWarmStep * maxWarmStep)) return false;
+
+	double alphaWarm = alpha;
+	Vector3 newNormal;
+	if (!scaleToSurface(positionIn, alphaWarm, WARM_EVALUATIONS, newNormal)) return false;
+	double newHorizontal = sqrt(newNormal[0] * newNormal[0] + newNormal[1] * newNormal[1]);
+
+	// latitude and longitude increments from the tangents of the angles between the normals
+	// (which do not need normalizing), or the full angles if the increments are not small
+	double newLatitude;
+	double cosine = newHorizontal * horizontal + newNormal[2] * normal[2];
+	double tangent = (newNormal[2] * horizontal - newHorizontal * normal[2]) / cosine;
+	if (cosine > 0.0 && fabs(tangent) <= SMALL_TANGENT) {
+		newLatitude = latitude + smallAtan(tangent);
+	}
+	else {
+		newLatitude = atan2(newNormal[2], newHorizontal);
+	}
+
+	double newLongitude;
+	cosine = normal[0] * newNormal[0] + normal[1] * newNormal[1];
+	tangent = (normal[0] * newNormal[1] - normal[1] * newNormal[0]) / cosine;
+	if (cosine > 0.0 && fabs(tangent) <= SMALL_TANGENT)
+	{
+		newLongitude = longitude + smallAtan(tangent);
+		if (newLongitude > PI) newLongitude -= 2.0 * PI;
+		else if (newLongitude < -PI) newLongitude += 2.0 * PI;
+	}
+	else {
+		newLongitude = atan2(newNormal[1], newNormal[0]);
+	}
+
+	position = positionIn;
+	alpha = alphaWarm;
+	normal = newNormal;
+	horizontal = newHorizontal;
+	latitude = newLatitude;
+	longitude = newLongitude;
+	warmConversions++;
+	numWarmConversions++;
+
+	geodetic = Geodetic3(latitude, longitude, alpha * sqrt(horizontal * horizontal + normal[2] * normal[2]));
+	return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+GeodeticConverter::GeodeticConverter(const Ellipsoid& ellipsoid, double maxWarmStep) : mImpl(new Impl(ellipsoid))
+{
+	mImpl->maxWarmStep = maxWarmStep;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+GeodeticConverter::~GeodeticConverter()
+{
+	delete mImpl;
+	mImpl = nullptr;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Geodetic3 GeodeticConverter::toGeodetic3(const Vector3& position)
+{
+	if (position.isNull())
+	{
+		mImpl->valid = false;
+		return Geodetic3(0.0, 0.0, 0.0);
+	}
+
+	Geodetic3 geodetic;
+	if (mImpl->warmConversion(position, geodetic)) {
+		return geodetic;
+	}
+	return mImpl->fullConversion(position);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+Geodetic2 GeodeticConverter::toGeodetic2(const Vector3& position)
+{
+	Geodetic3 geod3 = toGeodetic3(position);
+
+	return Geodetic2(geod3.getLatitude(), geod3.getLongitude());
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodeticConverter::reset(void)
+{
+	mImpl->valid = false;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void GeodeticConverter::setMaxWarmStep(double maxWarmStep)
+{
+	mImpl->maxWarmStep = maxWarmStep;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+double GeodeticConverter::getMaxWarmStep(void) const
+{
+	return mImpl->maxWarmStep;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+unsigned long long GeodeticConverter::getNumWarmConversions(void) const
+{
+	return mImpl->numWarmConversions;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+unsigned long long GeodeticConverter::getNumFullConversions(void) const
+{
+	return mImpl->numFullConversions;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+} //namespace otWorld
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
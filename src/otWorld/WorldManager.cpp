@@ -53,6 +53,48 @@ public:
 		celestialBodies.clear();
 	}
 
+	//Build the internal gravity factor table from the radiusFraction and gravityFraction arrays
+	//of a celestial body config, returns false if the config has no such arrays
+	static bool readInternalGravityFactorArrays(otCore::JSON& json, dTable& table)
+	{
+		if (!json.hasObject("internalGravityFactorTable.radiusFraction") || !json.hasObject("internalGravityFactorTable.gravityFraction"))
+			return false;
+
+		std::vector<double> radFracVec = json.getValueNumericArray("internalGravityFactorTable.radiusFraction");
+		std::vector<double> gravFracVec = json.getValueNumericArray("internalGravityFactorTable.gravityFraction");
+		//if (radFracVec.size() != gravFracVec.size())
+		//	Core::FSLog::warning("Json arrays sizes for x and y do not match, using smallest array size for table.");
+
+		size_t sizeArray = std::min(radFracVec.size(), gravFracVec.size());
+
+		dTable arrayTable(sizeArray);
+
+		for (unsigned int j = 0; j < sizeArray; j++) {
+			//		 Radius Frac			Gravity Frac
+			//		 -----------			-----------
+			arrayTable << radFracVec.at(j) << gravFracVec.at(j);
+		}
+
+		table = arrayTable;
+		return true;
+	}
+
+	//Path of the binary internal gravity factor table file of a celestial body config (absolute,
+	//or relative to the folder of the config file), empty if it names none
+	static std::string getInternalGravityFactorFile(otCore::JSON& json, const std::string& file)
+	{
+		std::string tableFile = json.getValue("internalGravityFactorTable.file", std::string(""));
+		if (tableFile.empty())
+			return tableFile;
+
+		bool absolute = tableFile[0] == '/' || tableFile[0] == '\\' || (tableFile.size() > 1 && tableFile[1] == ':');
+		size_t lastSlash = file.find_last_of("/\\");
+		if (!absolute && lastSlash != std::string::npos) {
+			tableFile = file.substr(0, lastSlash + 1) + tableFile;
+		}
+		return tableFile;
+	}
+
 	unsigned int numberCelestialBodies;
 	bool solarSystemChanged;
 	std::vector<ICelestialBody*> celestialBodies;
@@ -301,24 +343,23 @@ bool WorldManager::parseCelestialBodyConfig(const std::string& file)
 					}
 
 
-					if (json.hasObject("internalGravityFactorTable.radiusFraction") && json.hasObject("internalGravityFactorTable.gravityFraction"))
+					//The JSON arrays define the table.  Without them the table can come from a binary
+					//table file (see writeInternalGravityFactorTable()), mapped rather than parsed.
+					dTable gravityFactorTable(2);
+					if (Impl::readInternalGravityFactorArrays(json, gravityFactorTable))
 					{
-						std::vector<double> radFracVec = json.getValueNumericArray("internalGravityFactorTable.radiusFraction");
-						std::vector<double> gravFracVec = json.getValueNumericArray("internalGravityFactorTable.gravityFraction");
-						//if (radFracVec.size() != gravFracVec.size())
-						//	Core::FSLog::warning("Json arrays sizes for x and y do not match, using smallest array size for table.");
-
-						size_t sizeArray = std::min(radFracVec.size(), gravFracVec.size());
-
-						dTable table(sizeArray);
-
-						for (unsigned int j = 0; j < sizeArray; j++) {
-							//		 Radius Frac			Gravity Frac
-							//		 -----------			-----------
-							table << radFracVec.at(j) << gravFracVec.at(j);
+						body->setInternalGravityFactorTable(gravityFactorTable);
+					}
+					else
+					{
+						std::string gravityFactorTableFile = Impl::getInternalGravityFactorFile(json, file);
+						if (!gravityFactorTableFile.empty())
+						{
+							if (gravityFactorTable.readFile(gravityFactorTableFile)) {
+								body->setInternalGravityFactorTable(gravityFactorTable);
+							}
+							//else TODO: WARNING message for a missing or invalid internal gravity factor table file
 						}
-
-						body->setInternalGravityFactorTable(table);
 					}
 
 
@@ -333,6 +374,25 @@ bool WorldManager::parseCelestialBodyConfig(const std::string& file)
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+bool WorldManager::writeInternalGravityFactorTable(const std::string& file) const
+{
+	otCore::JSON json;
+	if (!json.readFile(file))
+		return false;
+
+	std::string gravityFactorTableFile = Impl::getInternalGravityFactorFile(json, file);
+	dTable gravityFactorTable(2);
+	if (gravityFactorTableFile.empty() || !Impl::readInternalGravityFactorArrays(json, gravityFactorTable))
+	{
+		//TODO: WARNING message for a config without internal gravity factor arrays or table file
+		return false;
+	}
+
+	return gravityFactorTable.writeFile(gravityFactorTableFile);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 } //namespace otWorld
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
\ No newline at end of file